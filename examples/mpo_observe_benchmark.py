@@ -0,0 +1,145 @@
+#!/usr/bin/env python3
+"""
+MPO Observe Benchmark
+
+Compares `cudaq.observe` on the MPS backend with each Pauli term evaluated by
+its own expectation contraction (`per-term`) against the whole observable
+compressed into a matrix product operator and contracted with the MPS once
+(`mpo`). Reports the number of terms, the observe time of both modes and the
+speedup.
+
+The observables are long-range Heisenberg chains (all pairs, couplings
+decaying with distance), whose number of terms grows quadratically with the
+number of qubits while the bond dimension of their MPO grows linearly, and,
+when `cudaq.chemistry` is available (it requires PySCF and OpenFermion),
+molecular Hamiltonians (LiH, H2O). The ansatz is a hardware-efficient circuit
+with fixed random angles. Each mode runs in a fresh process, since
+`CUDAQ_TENSORNET_OBSERVE_MODE` is read once; the first observe (which builds
+and compresses the MPO) is not timed.
+
+Usage:
+    python mpo_observe_benchmark.py [--target formotensor-mps] [--repeats 3]
+"""
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+import time
+
+MODES = ['per-term', 'mpo']
+
+CHAINS = {'Heisenberg-16': 16, 'Heisenberg-32': 32, 'Heisenberg-64': 64}
+
+GEOMETRIES = {
+    'LiH': [('Li', (0., 0., 0.)), ('H', (0., 0., 1.5949))],
+    'H2O': [('O', (0., 0., 0.1173)), ('H', (0., 0.7572, -0.4692)),
+            ('H', (0., -0.7572, -0.4692))],
+}
+
+
+def build_hamiltonian(cudaq, name):
+    """Spin operator and number of qubits of the observable `name`"""
+    if name in CHAINS:
+        num_qubits = CHAINS[name]
+        hamiltonian = 0
+        for i in range(num_qubits):
+            for j in range(i + 1, num_qubits):
+                coupling = 1.0 / (j - i)**2
+                for factory in (cudaq.spin.x, cudaq.spin.y, cudaq.spin.z):
+                    hamiltonian += coupling * factory(i) * factory(j)
+        return hamiltonian, num_qubits
+    hamiltonian, _ = cudaq.chemistry.create_molecular_hamiltonian(
+        GEOMETRIES[name], 'sto-3g', 1, 0)
+    return hamiltonian, hamiltonian.get_qubit_count()
+
+
+def count_terms(hamiltonian):
+    terms = []
+    hamiltonian.for_each_term(lambda term: terms.append(term))
+    return len(terms)
+
+
+def run_worker(target, name, repeats):
+    """Time `cudaq.observe` in the mode of this process, as one JSON line"""
+    import cudaq
+    import numpy as np
+    cudaq.set_target(target)
+    hamiltonian, num_qubits = build_hamiltonian(cudaq, name)
+
+    @cudaq.kernel
+    def ansatz(num_qubits: int, angles: list[float]):
+        q = cudaq.qvector(num_qubits)
+        for layer in range(2):
+            for i in range(num_qubits):
+                ry(angles[layer * num_qubits + i], q[i])
+            for i in range(num_qubits - 1):
+                x.ctrl(q[i], q[i + 1])
+
+    angles = np.random.default_rng(1234).uniform(0, np.pi,
+                                                 2 * num_qubits).tolist()
+    energy = cudaq.observe(ansatz, hamiltonian, num_qubits,
+                           angles).expectation()
+    start = time.perf_counter()
+    for _ in range(repeats):
+        cudaq.observe(ansatz, hamiltonian, num_qubits, angles)
+    elapsed = (time.perf_counter() - start) / repeats
+    print(json.dumps({
+        'qubits': num_qubits,
+        'terms': count_terms(hamiltonian),
+        'energy': energy,
+        'time': elapsed
+    }),
+          flush=True)
+
+
+def run_mode(args, name, mode):
+    env = dict(os.environ, CUDAQ_TENSORNET_OBSERVE_MODE=mode)
+    output = subprocess.run([
+        sys.executable, __file__, '--worker', '--target', args.target,
+        '--observable', name, '--repeats',
+        str(args.repeats)
+    ],
+                            check=True,
+                            capture_output=True,
+                            text=True,
+                            env=env).stdout
+    return json.loads(output.splitlines()[-1])
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('--target', default='formotensor-mps')
+    parser.add_argument('--repeats', type=int, default=3)
+    parser.add_argument('--observable', default=None, help=argparse.SUPPRESS)
+    parser.add_argument('--worker', action='store_true', help=argparse.SUPPRESS)
+    args = parser.parse_args()
+
+    if args.worker:
+        run_worker(args.target, args.observable, args.repeats)
+        return
+
+    print("=" * 80)
+    print(f"MPO Observe: target '{args.target}'")
+    print("=" * 80)
+    print()
+    print(f"{'Observable':<14} {'Qubits':>6} {'Terms':>6} "
+          f"{'Per-term (s)':>13} {'MPO (s)':>10} {'Speedup':>8}")
+    print("-" * 80)
+    for name in list(CHAINS) + list(GEOMETRIES):
+        try:
+            results = {mode: run_mode(args, name, mode) for mode in MODES}
+        except subprocess.CalledProcessError as error:
+            reason = error.stderr.strip().splitlines()[-1]
+            print(f"{name:<14} skipped ({reason})")
+            continue
+        per_term, mpo = results['per-term'], results['mpo']
+        assert abs(per_term['energy'] - mpo['energy']) < 1e-6
+        print(f"{name:<14} {mpo['qubits']:>6} {mpo['terms']:>6} "
+              f"{per_term['time']:>13.4f} {mpo['time']:>10.4f} "
+              f"{per_term['time'] / mpo['time']:>7.2f}x")
+
+
+if __name__ == '__main__':
+    main()
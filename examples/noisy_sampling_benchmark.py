@@ -0,0 +1,94 @@
+#!/usr/bin/env python3
+"""
+Noisy Sampling Benchmark
+
+Times noisy `cudaq.sample` with depolarizing noise after every gate, for a
+range of error rates and numbers of shots. The shots are grouped by noise
+trajectory on the host and each distinct trajectory is contracted once, so
+that the time follows the number of distinct trajectories (reported as an
+estimate from the error rates: 1 - P(no error) of the shots deviate from the
+noiseless trajectory) rather than the number of shots.
+
+The circuit is a hardware-efficient ansatz (two `ry` layers and `cx` chains)
+with fixed random angles.
+
+Usage:
+    python noisy_sampling_benchmark.py [--target formotensor]
+                                       [--qubits 12]
+                                       [--shots 1000 10000 100000]
+                                       [--error-rates 1e-4 1e-3 1e-2]
+"""
+
+import argparse
+import time
+
+import cudaq
+import numpy as np
+
+
+@cudaq.kernel
+def ansatz(num_qubits: int, angles: list[float]):
+    q = cudaq.qvector(num_qubits)
+    for layer in range(2):
+        for i in range(num_qubits):
+            ry(angles[layer * num_qubits + i], q[i])
+        for i in range(num_qubits - 1):
+            x.ctrl(q[i], q[i + 1])
+
+
+def noise_model(error_rate):
+    noise = cudaq.NoiseModel()
+    depolarization = cudaq.DepolarizationChannel(error_rate)
+    noise.add_all_qubit_channel('ry', depolarization)
+    noise.add_all_qubit_channel('x', depolarization, num_controls=1)
+    return noise
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('--target', default='formotensor')
+    parser.add_argument('--qubits', type=int, default=12)
+    parser.add_argument('--shots',
+                        type=int,
+                        nargs='+',
+                        default=[1000, 10000, 100000])
+    parser.add_argument('--error-rates',
+                        type=float,
+                        nargs='+',
+                        default=[1e-4, 1e-3, 1e-2])
+    args = parser.parse_args()
+    cudaq.set_target(args.target)
+    num_qubits = args.qubits
+    angles = np.random.default_rng(1234).uniform(0, np.pi,
+                                                 2 * num_qubits).tolist()
+    # One channel per `ry` and per `cx` target.
+    num_channels = 2 * num_qubits + 2 * (num_qubits - 1)
+
+    print("=" * 80)
+    print(f"Noisy Sampling: target '{args.target}', {num_qubits} qubits, "
+          f"{num_channels} channels")
+    print("=" * 80)
+    print()
+    print(f"{'Error rate':>10} {'Shots':>9} {'Deviating':>10} "
+          f"{'Time (s)':>10} {'Shots/s':>10}")
+    print("-" * 80)
+    for error_rate in args.error_rates:
+        noise = noise_model(error_rate)
+        # Warm-up (plugin loading, device initialization)
+        cudaq.sample(ansatz, num_qubits, angles, shots_count=10,
+                     noise_model=noise)
+        for shots in args.shots:
+            deviating = shots * (1 - (1 - error_rate)**num_channels)
+            start = time.perf_counter()
+            cudaq.sample(ansatz,
+                         num_qubits,
+                         angles,
+                         shots_count=shots,
+                         noise_model=noise)
+            elapsed = time.perf_counter() - start
+            print(f"{error_rate:>10.0e} {shots:>9} {deviating:>10.0f} "
+                  f"{elapsed:>10.3f} {shots / elapsed:>10.0f}")
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,157 @@
+#!/usr/bin/env python3
+"""
+Pauli Propagation Benchmark
+
+Compares `cudaq.observe` by tensor network contraction (`auto` mode) against
+Pauli propagation (`pauli-propagation` mode), which evolves the observable
+backwards through the gates as a truncated sum of Pauli products on the host.
+Reports the time of both modes, the energies, and the truncation error bound
+and number of Pauli products of the propagation.
+
+The circuits are deep brickwork layers of random Clifford gates (`h`, `s`,
+`cx`) with a few `rx` rotations per layer, and the observable is a nearest-
+neighbor Ising chain (`Z_i Z_i+1` and `X_i` terms). Each mode runs in a fresh
+process, since `CUDAQ_TENSORNET_OBSERVE_MODE` is read once; the first observe
+(which finds the contraction path) is not timed.
+
+Usage:
+    python pauli_propagation_benchmark.py [--target formotensor]
+                                          [--qubits 16 32] [--layers 20 40]
+                                          [--cutoff 1e-6]
+"""
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+import time
+
+# Gate codes of `circuit`.
+H, S, CX, RX = 0, 1, 2, 3
+ROTATIONS_PER_LAYER = 2
+
+
+def circuit_gates(num_qubits, num_layers, seed=1234):
+    """Flat (code, qubit, angle) list of a Clifford-dominated brickwork"""
+    import numpy as np
+    rng = np.random.default_rng(seed)
+    gates = []
+    for layer in range(num_layers):
+        for i in range(num_qubits):
+            gates.append((int(rng.choice([H, S])), i, 0.0))
+        for i in range(layer % 2, num_qubits - 1, 2):
+            gates.append((CX, i, 0.0))
+        for i in rng.choice(num_qubits, ROTATIONS_PER_LAYER, replace=False):
+            gates.append((RX, int(i), float(rng.uniform(0, np.pi))))
+    return gates
+
+
+def run_worker(target, num_qubits, num_layers, repeats):
+    """Time `cudaq.observe` in the mode of this process, as one JSON line"""
+    import cudaq
+    cudaq.set_target(target)
+
+    @cudaq.kernel
+    def circuit(num_qubits: int, codes: list[int], qubits: list[int],
+                angles: list[float]):
+        q = cudaq.qvector(num_qubits)
+        for k in range(len(codes)):
+            if codes[k] == 0:
+                h(q[qubits[k]])
+            elif codes[k] == 1:
+                s(q[qubits[k]])
+            elif codes[k] == 2:
+                x.ctrl(q[qubits[k]], q[qubits[k] + 1])
+            else:
+                rx(angles[k], q[qubits[k]])
+
+    hamiltonian = 0
+    for i in range(num_qubits):
+        hamiltonian += 0.5 * cudaq.spin.x(i)
+        if i + 1 < num_qubits:
+            hamiltonian += cudaq.spin.z(i) * cudaq.spin.z(i + 1)
+    gates = circuit_gates(num_qubits, num_layers)
+    args = ([code for code, _, _ in gates], [qubit for _, qubit, _ in gates],
+            [angle for _, _, angle in gates])
+
+    result = cudaq.observe(circuit, hamiltonian, num_qubits, *args)
+    start = time.perf_counter()
+    for _ in range(repeats):
+        cudaq.observe(circuit, hamiltonian, num_qubits, *args)
+    elapsed = (time.perf_counter() - start) / repeats
+    counts = result.counts()
+    bound, products = 0.0, 0
+    if '__pauli_propagation__' in counts.register_names:
+        bound = counts.expectation('__pauli_propagation__')
+        products = counts.get_register_counts('__pauli_propagation__').count(
+            'max_terms')
+    print(json.dumps({
+        'energy': result.expectation(),
+        'time': elapsed,
+        'bound': bound,
+        'products': products
+    }),
+          flush=True)
+
+
+def run_mode(args, num_qubits, num_layers, mode):
+    env = dict(os.environ,
+               CUDAQ_TENSORNET_OBSERVE_MODE=mode,
+               CUDAQ_TENSORNET_PAULI_PROPAGATION_CUTOFF=str(args.cutoff))
+    output = subprocess.run([
+        sys.executable, __file__, '--worker', '--target', args.target,
+        '--qubits',
+        str(num_qubits), '--layers',
+        str(num_layers), '--repeats',
+        str(args.repeats)
+    ],
+                            check=True,
+                            capture_output=True,
+                            text=True,
+                            env=env).stdout
+    return json.loads(output.splitlines()[-1])
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('--target', default='formotensor')
+    parser.add_argument('--qubits', type=int, nargs='+', default=[16, 32])
+    parser.add_argument('--layers', type=int, nargs='+', default=[20, 40])
+    parser.add_argument('--cutoff', type=float, default=1e-6)
+    parser.add_argument('--repeats', type=int, default=3)
+    parser.add_argument('--worker', action='store_true', help=argparse.SUPPRESS)
+    args = parser.parse_args()
+
+    if args.worker:
+        run_worker(args.target, args.qubits[0], args.layers[0], args.repeats)
+        return
+
+    print("=" * 80)
+    print(f"Pauli Propagation: target '{args.target}', cutoff {args.cutoff}")
+    print("=" * 80)
+    print()
+    print(f"{'Qubits':>6} {'Layers':>6} {'Contract (s)':>13} "
+          f"{'Propagate (s)':>14} {'Speedup':>8} {'|Diff|':>9} "
+          f"{'Bound':>9} {'Products':>9}")
+    print("-" * 80)
+    for num_qubits in args.qubits:
+        for num_layers in args.layers:
+            try:
+                contract = run_mode(args, num_qubits, num_layers, 'auto')
+                propagate = run_mode(args, num_qubits, num_layers,
+                                     'pauli-propagation')
+            except subprocess.CalledProcessError as error:
+                reason = error.stderr.strip().splitlines()[-1]
+                print(f"{num_qubits:>6} {num_layers:>6} skipped ({reason})")
+                continue
+            diff = abs(contract['energy'] - propagate['energy'])
+            print(f"{num_qubits:>6} {num_layers:>6} "
+                  f"{contract['time']:>13.4f} {propagate['time']:>14.4f} "
+                  f"{contract['time'] / propagate['time']:>7.2f}x "
+                  f"{diff:>9.2e} {propagate['bound']:>9.2e} "
+                  f"{propagate['products']:>9}")
+
+
+if __name__ == '__main__':
+    main()
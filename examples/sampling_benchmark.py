@@ -0,0 +1,66 @@
+#!/usr/bin/env python3
+"""
+Sampling Post-Processing Benchmark
+
+Times `cudaq.sample` of many shots on wide, shallow circuits, where the
+contraction is cheap and the cost is dominated by the host processing of the
+shots: packing the sampled bits, counting the outcomes and building the
+result. Reports the time, the throughput (shots per second) and the number of
+distinct outcomes for each width and number of shots.
+
+The circuit is a layer of `h` gates followed by a `cx` chain on every other
+pair (GHZ-like pairs), so that the number of distinct outcomes grows with the
+number of shots.
+
+Usage:
+    python sampling_benchmark.py [--target formotensor]
+                                 [--qubits 20 50 100]
+                                 [--shots 10000 100000 1000000]
+"""
+
+import argparse
+import time
+
+import cudaq
+
+
+@cudaq.kernel
+def pairs(num_qubits: int):
+    q = cudaq.qvector(num_qubits)
+    for i in range(0, num_qubits, 2):
+        h(q[i])
+    for i in range(0, num_qubits - 1, 2):
+        x.ctrl(q[i], q[i + 1])
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('--target', default='formotensor')
+    parser.add_argument('--qubits', type=int, nargs='+', default=[20, 50, 100])
+    parser.add_argument('--shots',
+                        type=int,
+                        nargs='+',
+                        default=[10000, 100000, 1000000])
+    args = parser.parse_args()
+    cudaq.set_target(args.target)
+
+    print("=" * 80)
+    print(f"Sampling Post-Processing: target '{args.target}'")
+    print("=" * 80)
+    print()
+    print(f"{'Qubits':>6} {'Shots':>9} {'Time (s)':>10} {'Shots/s':>12} "
+          f"{'Outcomes':>10}")
+    print("-" * 80)
+    for num_qubits in args.qubits:
+        # Warm-up (plugin loading, device initialization, path finding)
+        cudaq.sample(pairs, num_qubits, shots_count=100)
+        for shots in args.shots:
+            start = time.perf_counter()
+            counts = cudaq.sample(pairs, num_qubits, shots_count=shots)
+            elapsed = time.perf_counter() - start
+            print(f"{num_qubits:>6} {shots:>9} {elapsed:>10.3f} "
+                  f"{shots / elapsed:>12.0f} {len(counts):>10}")
+
+
+if __name__ == '__main__':
+    main()
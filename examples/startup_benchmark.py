@@ -0,0 +1,105 @@
+#!/usr/bin/env python3
+"""
+Plugin Startup Benchmark
+
+Measures the latency from loading the backend plugin to the first result, in
+fresh processes (cold start):
+  - import:        `import cudaq`
+  - set target:    `cudaq.set_target(...)`, i.e., loading the plugin
+  - first result:  first `cudaq.sample` of a small kernel (device and
+                   cuTensorNet initialization, scratch allocation, execution)
+  - second result: the same query again (steady state)
+
+The backends initialize the device, the cuTensorNet handle and the scratch
+workspace lazily on first use, and size the scratch buffer from the actual
+workspace of the queries; loading the plugin only to query targets is then
+cheap. To compare against another build, run this script once with each
+build on the `PYTHONPATH` and compare the tables.
+
+Usage:
+    python startup_benchmark.py [--target formotensor] [--qubits 8] [--runs 5]
+"""
+
+import argparse
+import json
+import statistics
+import subprocess
+import sys
+import time
+
+PHASES = ['import', 'set target', 'first result', 'second result']
+
+
+def run_worker(target, num_qubits):
+    """Time the startup phases of a single process, as one JSON line"""
+    times = {}
+    start = time.perf_counter()
+    import cudaq
+    times['import'] = time.perf_counter() - start
+
+    start = time.perf_counter()
+    cudaq.set_target(target)
+    times['set target'] = time.perf_counter() - start
+
+    @cudaq.kernel
+    def ghz(num_qubits: int):
+        q = cudaq.qvector(num_qubits)
+        h(q[0])
+        for i in range(num_qubits - 1):
+            x.ctrl(q[i], q[i + 1])
+
+    for phase in ['first result', 'second result']:
+        start = time.perf_counter()
+        counts = cudaq.sample(ghz, num_qubits, shots_count=100)
+        times[phase] = time.perf_counter() - start
+    assert set(counts) <= {'0' * num_qubits, '1' * num_qubits}
+    print(json.dumps(times), flush=True)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('--target', default='formotensor')
+    parser.add_argument('--qubits', type=int, default=8)
+    parser.add_argument('--runs', type=int, default=5)
+    parser.add_argument('--worker', action='store_true', help=argparse.SUPPRESS)
+    args = parser.parse_args()
+
+    if args.worker:
+        run_worker(args.target, args.qubits)
+        return
+
+    print("=" * 80)
+    print(f"Plugin Startup: target '{args.target}', {args.qubits}-qubit GHZ, "
+          f"{args.runs} cold starts")
+    print("=" * 80)
+    print()
+
+    runs = []
+    for _ in range(args.runs):
+        output = subprocess.run([
+            sys.executable, __file__, '--worker', '--target', args.target,
+            '--qubits',
+            str(args.qubits)
+        ],
+                                check=True,
+                                capture_output=True,
+                                text=True).stdout
+        runs.append(json.loads(output.splitlines()[-1]))
+
+    print(f"{'Phase':<16} {'Median (ms)':>12} {'Min (ms)':>10} "
+          f"{'Max (ms)':>10}")
+    print("-" * 80)
+    for phase in PHASES:
+        values = [run[phase] * 1000 for run in runs]
+        print(f"{phase:<16} {statistics.median(values):>12.1f} "
+              f"{min(values):>10.1f} {max(values):>10.1f}")
+    load_to_result = [
+        (run['set target'] + run['first result']) * 1000 for run in runs
+    ]
+    print("-" * 80)
+    print(f"Plugin load to first result: "
+          f"{statistics.median(load_to_result):.1f} ms (median)")
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,72 @@
+#!/usr/bin/env python3
+"""
+Small-Kernel Throughput Benchmark
+
+Runs many short kernels back to back, as a sampling service would, and
+reports the throughput (kernels per second) for 10 to 20 qubit circuits.
+Each kernel allocates its register, applies a couple of layers of gates and
+is sampled; between kernels the backend keeps its cuTensorNet handle and
+reuses the state object of the previous register of the same width.
+
+Usage:
+    python throughput_benchmark.py [--target formotensor] [--kernels 1000]
+"""
+
+import argparse
+import time
+
+import cudaq
+import numpy as np
+
+
+@cudaq.kernel
+def layered(num_qubits: int, angles: list[float]):
+    q = cudaq.qvector(num_qubits)
+    for layer in range(2):
+        for i in range(num_qubits):
+            ry(angles[layer * num_qubits + i], q[i])
+        for i in range(layer % 2, num_qubits - 1, 2):
+            x.ctrl(q[i], q[i + 1])
+
+
+def measure_throughput(num_qubits, num_kernels, shots, rng):
+    angles = [
+        rng.uniform(0, np.pi, 2 * num_qubits).tolist() for _ in range(8)
+    ]
+    # Warm-up (plugin loading, device initialization)
+    cudaq.sample(layered, num_qubits, angles[0], shots_count=shots)
+    start = time.perf_counter()
+    for i in range(num_kernels):
+        cudaq.sample(layered,
+                     num_qubits,
+                     angles[i % len(angles)],
+                     shots_count=shots)
+    return num_kernels / (time.perf_counter() - start)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('--target', default='formotensor')
+    parser.add_argument('--kernels', type=int, default=1000)
+    parser.add_argument('--shots', type=int, default=100)
+    args = parser.parse_args()
+
+    cudaq.set_target(args.target)
+    rng = np.random.default_rng(1234)
+
+    print("=" * 80)
+    print(f"Small-Kernel Throughput: target '{args.target}', "
+          f"{args.kernels} kernels x {args.shots} shots")
+    print("=" * 80)
+    print()
+    print(f"{'Qubits':>7} {'Kernels/s':>12} {'Latency (ms)':>14}")
+    print("-" * 80)
+    for num_qubits in (10, 12, 14, 16, 18, 20):
+        throughput = measure_throughput(num_qubits, args.kernels, args.shots,
+                                        rng)
+        print(f"{num_qubits:>7} {throughput:>12.1f} "
+              f"{1000.0 / throughput:>14.3f}")
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,131 @@
+#!/usr/bin/env python3
+"""
+Warm-Start Contraction Planning Benchmark
+
+Growing-depth circuits (each one is the previous circuit plus a layer of
+gates), as in layer-by-layer QAOA or growing Trotter depth. Compares the time
+to compute an amplitude with a full contraction path search for every circuit
+against warm-started path finding, which seeds the path with the one of the
+previous circuit (CUDAQ_TENSORNET_PATH_WARM_START).
+
+Each configuration runs in its own process, since the backend reads its
+settings from the environment once.
+
+Usage:
+    python warm_start_benchmark.py [--qubits 40] [--depth 12]
+"""
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+import time
+
+CONFIGS = {
+    'full search': {
+        'CUDAQ_TENSORNET_PATH_OPTIMIZER': 'random-greedy',
+        'CUDAQ_TENSORNET_PATH_OPTIMIZER_TIME_BUDGET': '0.5',
+    },
+    'warm start': {
+        'CUDAQ_TENSORNET_PATH_OPTIMIZER': 'random-greedy',
+        'CUDAQ_TENSORNET_PATH_OPTIMIZER_TIME_BUDGET': '0.5',
+        'CUDAQ_TENSORNET_PATH_WARM_START': '1',
+    },
+}
+
+
+def run_worker(num_qubits, max_depth):
+    """Compute an amplitude of circuits of growing depth, one JSON line each"""
+    import cudaq
+    import numpy as np
+
+    cudaq.set_target("formotensor")
+
+    @cudaq.kernel
+    def layered(num_qubits: int, depth: int, angles: list[float]):
+        q = cudaq.qvector(num_qubits)
+        for layer in range(depth):
+            for i in range(num_qubits):
+                ry(angles[layer * num_qubits + i], q[i])
+            for i in range(layer % 2, num_qubits - 1, 2):
+                cz(q[i], q[i + 1])
+
+    rng = np.random.default_rng(1234)
+    angles = rng.uniform(0, np.pi, num_qubits * max_depth).tolist()
+    zeros = [0] * num_qubits
+    for depth in range(1, max_depth + 1):
+        state = cudaq.get_state(layered, num_qubits, depth, angles)
+        start = time.time()
+        amplitude = complex(state.amplitude(zeros))
+        elapsed = time.time() - start
+        print(json.dumps({
+            'depth': depth,
+            'time': elapsed,
+            'amplitude': [amplitude.real, amplitude.imag]
+        }),
+              flush=True)
+
+
+def run_config(name, num_qubits, max_depth):
+    env = dict(os.environ)
+    env.update(CONFIGS[name])
+    output = subprocess.run([
+        sys.executable, __file__, '--worker', '--qubits',
+        str(num_qubits), '--depth',
+        str(max_depth)
+    ],
+                            env=env,
+                            check=True,
+                            capture_output=True,
+                            text=True).stdout
+    return [json.loads(line) for line in output.splitlines() if line]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('--qubits', type=int, default=40)
+    parser.add_argument('--depth', type=int, default=12)
+    parser.add_argument('--worker', action='store_true', help=argparse.SUPPRESS)
+    args = parser.parse_args()
+
+    if args.worker:
+        run_worker(args.qubits, args.depth)
+        return
+
+    print("=" * 80)
+    print(f"Warm-Start Planning: {args.qubits} qubits, depth 1 to {args.depth}")
+    print("=" * 80)
+    print()
+
+    results = {
+        name: run_config(name, args.qubits, args.depth) for name in CONFIGS
+    }
+
+    full, warm = results['full search'], results['warm start']
+    print(f"{'Depth':>6} {'Full search (ms)':>18} {'Warm start (ms)':>17} "
+          f"{'Speedup':>9} {'Max diff':>10}")
+    print("-" * 80)
+    all_match = True
+    for full_run, warm_run in zip(full, warm):
+        full_amp = complex(*full_run['amplitude'])
+        warm_amp = complex(*warm_run['amplitude'])
+        diff = abs(full_amp - warm_amp)
+        all_match = all_match and diff < 1e-6
+        print(f"{full_run['depth']:>6} {full_run['time'] * 1000:>18.3f} "
+              f"{warm_run['time'] * 1000:>17.3f} "
+              f"{full_run['time'] / warm_run['time']:>8.2f}x {diff:>10.2e}")
+
+    # The first circuit has no previous network to warm-start from.
+    full_total = sum(run['time'] for run in full[1:])
+    warm_total = sum(run['time'] for run in warm[1:])
+    print("-" * 80)
+    print(f"Total (depth >= 2): full search {full_total:.3f} s, "
+          f"warm start {warm_total:.3f} s "
+          f"({full_total / warm_total:.2f}x)")
+    print(f"Amplitudes: {'✓ PASS' if all_match else '✗ FAIL'}")
+    sys.exit(0 if all_match else 1)
+
+
+if __name__ == '__main__':
+    main()
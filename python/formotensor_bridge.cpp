@@ -9,7 +9,10 @@
 #include <pybind11/stl.h>
 #include <pybind11/numpy.h>
 #include <pybind11/complex.h>
+#include <algorithm>
 #include <complex>
+#include <dlfcn.h>
+#include <tuple>
 #include <vector>
 
 // Conditionally include CUDA
@@ -17,6 +20,11 @@
 #include <cuda_runtime.h>
 #endif
 
+// Host-side contraction cost estimates (no GPU required)
+#ifdef FORMOTENSOR_HAVE_PATH_OPTIMIZER
+#include "path_optimizer.h"
+#endif
+
 namespace py = pybind11;
 
 // Simplified tensor information structure
@@ -47,6 +55,279 @@ struct GateTopology {
           is_adjoint(adjoint), is_unitary(unitary), tensor_idx(idx) {}
 };
 
+// Gate of a parameterized circuit for parameter_shift_gradient
+struct ParameterizedGate {
+    std::string name;                // h, x, y, z, s, t, sdg, tdg, rx, ry, rz, r1
+    size_t target;
+    std::vector<size_t> controls;
+    double angle;                    // Fixed angle (offset)
+    int64_t parameter;               // Parameter index (-1 if fixed)
+    double scale;                    // Parameter scale
+
+    ParameterizedGate() : target(0), angle(0.0), parameter(-1), scale(1.0) {}
+
+    ParameterizedGate(const std::string& gate_name, size_t target_qubit,
+                      const std::vector<size_t>& control_qubits,
+                      double gate_angle, int64_t parameter_idx,
+                      double parameter_scale)
+        : name(gate_name), target(target_qubit), controls(control_qubits),
+          angle(gate_angle), parameter(parameter_idx),
+          scale(parameter_scale) {}
+};
+
+// Signature of the gradient entry points of the formotensor backend
+// (formotensor_parameter_shift_gradient, formotensor_adjoint_gradient in
+// simulator_tensornet.h)
+using GradientFn = const char* (*)(
+    size_t, size_t, const char* const*, const size_t*, const size_t*,
+    const size_t*, const double*, const int64_t*, const double*, size_t,
+    const char* const*, const double*, size_t, const double*, double*,
+    double*);
+
+// Signature of formotensor_local_matrix_expectation
+using LocalMatrixExpectationFn = const char* (*)(
+    size_t, size_t, const char* const*, const size_t*, const size_t*,
+    const size_t*, const double*, const int64_t*, const double*, size_t,
+    const size_t*, const size_t*, const double*, const double*, size_t,
+    const double*, double*);
+
+// Signature of formotensor_correlation_matrices (and of its MPS variant)
+using CorrelationMatricesFn = const char* (*)(
+    size_t, size_t, const char* const*, const size_t*, const size_t*,
+    const size_t*, const double*, const int64_t*, const double*, const char*,
+    size_t, const double*, void**, char*, double**, double**);
+using FreeCorrelationMatricesFn = void (*)(void*);
+
+// Signature of formotensor_explain
+using ExplainFn = const char* (*)(
+    const char*, size_t, size_t, const size_t*, const size_t*, const int*,
+    size_t, const size_t*, size_t, const char* const*, const double*, double*,
+    double*, int64_t*, int64_t*, double*, int*);
+
+// Resolve an entry point of a formotensor backend library, preferably from the
+// instance already loaded by CUDA-Q (`cudaq.set_target`), so that both share
+// the cuTensorNet handle.
+static void* get_backend_symbol(
+    const char* symbol,
+    const std::string& library = "libnvqir-formotensor.so") {
+    if (auto* sym = dlsym(RTLD_DEFAULT, symbol)) {
+        return sym;
+    }
+    void* lib = dlopen(library.c_str(), RTLD_NOW | RTLD_NOLOAD);
+    if (!lib) {
+        lib = dlopen(library.c_str(), RTLD_NOW);
+    }
+    if (!lib) {
+        throw std::runtime_error(
+            std::string("Cannot load the formotensor backend: ") + dlerror());
+    }
+    auto* sym = dlsym(lib, symbol);
+    if (!sym) {
+        throw std::runtime_error(
+            "The formotensor backend does not provide " + std::string(symbol));
+    }
+    return sym;
+}
+
+static GradientFn get_gradient_fn(const char* symbol) {
+    return reinterpret_cast<GradientFn>(get_backend_symbol(symbol));
+}
+
+// Gates of a circuit as the parallel arrays of the backend entry points
+struct GateArrays {
+    std::vector<const char*> names;
+    std::vector<size_t> control_offsets{0};
+    std::vector<size_t> controls;
+    std::vector<size_t> targets;
+    std::vector<double> angles;
+    std::vector<int64_t> parameter_indices;
+    std::vector<double> scales;
+
+    explicit GateArrays(const std::vector<ParameterizedGate>& gates) {
+        for (const auto& gate : gates) {
+            names.push_back(gate.name.c_str());
+            controls.insert(controls.end(), gate.controls.begin(),
+                            gate.controls.end());
+            control_offsets.push_back(controls.size());
+            targets.push_back(gate.target);
+            angles.push_back(gate.angle);
+            parameter_indices.push_back(gate.parameter);
+            scales.push_back(gate.scale);
+        }
+    }
+};
+
+// Expectation value of an observable (list of (Pauli word, coefficient)) and
+// its gradient with respect to the circuit parameters, computed by the
+// backend entry point `symbol`.
+static std::pair<double, std::vector<double>> compute_gradient(
+    const char* symbol, size_t num_qubits,
+    const std::vector<ParameterizedGate>& gates,
+    const std::vector<std::pair<std::string, double>>& observable,
+    const std::vector<double>& parameters) {
+    const GateArrays arrays(gates);
+    std::vector<const char*> words;
+    std::vector<double> coefficients;
+    for (const auto& [word, coefficient] : observable) {
+        words.push_back(word.c_str());
+        coefficients.push_back(coefficient);
+    }
+
+    auto fn = get_gradient_fn(symbol);
+    double expectation = 0.0;
+    std::vector<double> gradient(parameters.size(), 0.0);
+    const char* error = nullptr;
+    {
+        py::gil_scoped_release release;
+        error = fn(num_qubits, gates.size(), arrays.names.data(),
+                   arrays.control_offsets.data(), arrays.controls.data(),
+                   arrays.targets.data(), arrays.angles.data(),
+                   arrays.parameter_indices.data(), arrays.scales.data(),
+                   words.size(), words.data(), coefficients.data(),
+                   parameters.size(), parameters.data(), &expectation,
+                   gradient.data());
+    }
+    if (error) {
+        throw std::runtime_error(error);
+    }
+    return {expectation, gradient};
+}
+
+using LocalMatrix =
+    py::array_t<std::complex<double>, py::array::c_style | py::array::forcecast>;
+
+// Expectation value of a sum of dense local matrices (list of (qubits,
+// matrix, coefficient)), each contracted as a single tensor.
+static std::complex<double> local_matrix_expectation(
+    size_t num_qubits, const std::vector<ParameterizedGate>& gates,
+    const std::vector<std::tuple<std::vector<size_t>, LocalMatrix,
+                                 std::complex<double>>>& terms,
+    const std::vector<double>& parameters) {
+    const GateArrays arrays(gates);
+    std::vector<size_t> qubit_offsets{0};
+    std::vector<size_t> qubits;
+    std::vector<double> matrices;
+    std::vector<double> coefficients;
+    for (const auto& [term_qubits, matrix, coefficient] : terms) {
+        if (term_qubits.size() >= 8 * sizeof(size_t)) {
+            throw std::invalid_argument("Too many qubits in a local term");
+        }
+        const auto dim = static_cast<py::ssize_t>(size_t{1}
+                                                  << term_qubits.size());
+        if (matrix.ndim() != 2 || matrix.shape(0) != dim ||
+            matrix.shape(1) != dim) {
+            throw std::invalid_argument(
+                "The matrix of a term on " +
+                std::to_string(term_qubits.size()) + " qubits must be " +
+                std::to_string(dim) + " x " + std::to_string(dim));
+        }
+        qubits.insert(qubits.end(), term_qubits.begin(), term_qubits.end());
+        qubit_offsets.push_back(qubits.size());
+        const auto* data = matrix.data();
+        for (py::ssize_t i = 0; i < matrix.size(); ++i) {
+            matrices.push_back(data[i].real());
+            matrices.push_back(data[i].imag());
+        }
+        coefficients.push_back(coefficient.real());
+        coefficients.push_back(coefficient.imag());
+    }
+
+    auto fn = reinterpret_cast<LocalMatrixExpectationFn>(
+        get_backend_symbol("formotensor_local_matrix_expectation"));
+    double expectation[2] = {0.0, 0.0};
+    const char* error = nullptr;
+    {
+        py::gil_scoped_release release;
+        error = fn(num_qubits, gates.size(), arrays.names.data(),
+                   arrays.control_offsets.data(), arrays.controls.data(),
+                   arrays.targets.data(), arrays.angles.data(),
+                   arrays.parameter_indices.data(), arrays.scales.data(),
+                   terms.size(), qubit_offsets.data(), qubits.data(),
+                   matrices.data(), coefficients.data(), parameters.size(),
+                   parameters.data(), expectation);
+    }
+    if (error) {
+        throw std::runtime_error(error);
+    }
+    return {expectation[0], expectation[1]};
+}
+
+// One- and two-point correlators of Pauli pairs (e.g., "ZZXX"), as a dict
+// from each pair ("ZZ": (N, N) matrix) and each Pauli of the pairs ("Z":
+// vector of length N) to views of the buffers of the backend, which are owned
+// by a capsule (no copy).
+static py::dict correlation_matrices(
+    size_t num_qubits, const std::vector<ParameterizedGate>& gates,
+    const std::string& pairs, const std::vector<double>& parameters,
+    const std::string& backend) {
+    if (backend != "formotensor" && backend != "formotensor-mps") {
+        throw std::invalid_argument(
+            "Unknown backend '" + backend +
+            "' (expecting formotensor or formotensor-mps)");
+    }
+    const bool mps = backend == "formotensor-mps";
+    const std::string library = "libnvqir-" + backend + ".so";
+    auto fn = reinterpret_cast<CorrelationMatricesFn>(get_backend_symbol(
+        mps ? "formotensor_mps_correlation_matrices"
+            : "formotensor_correlation_matrices",
+        library));
+    auto free_fn = reinterpret_cast<FreeCorrelationMatricesFn>(
+        get_backend_symbol(mps ? "formotensor_mps_free_correlation_matrices"
+                               : "formotensor_free_correlation_matrices",
+                           library));
+
+    const GateArrays arrays(gates);
+    void* result = nullptr;
+    char kinds[4] = {};
+    double* one_point = nullptr;
+    double* two_point = nullptr;
+    const char* error = nullptr;
+    {
+        py::gil_scoped_release release;
+        error = fn(num_qubits, gates.size(), arrays.names.data(),
+                   arrays.control_offsets.data(), arrays.controls.data(),
+                   arrays.targets.data(), arrays.angles.data(),
+                   arrays.parameter_indices.data(), arrays.scales.data(),
+                   pairs.c_str(), parameters.size(), parameters.data(),
+                   &result, kinds, &one_point, &two_point);
+    }
+    if (error) {
+        throw std::runtime_error(error);
+    }
+
+    py::capsule owner(result, free_fn);
+    const auto n = static_cast<py::ssize_t>(num_qubits);
+    py::dict correlators;
+    for (size_t p = 0; 2 * p < pairs.size(); ++p) {
+        correlators[py::str(pairs.substr(2 * p, 2))] = py::array_t<double>(
+            {n, n}, two_point + p * num_qubits * num_qubits, owner);
+    }
+    for (size_t k = 0; kinds[k] != '\0'; ++k) {
+        correlators[py::str(std::string(1, kinds[k]))] =
+            py::array_t<double>({n}, one_point + k * num_qubits, owner);
+    }
+    return correlators;
+}
+
+// All the shifted circuits evaluated on a single network and prepared
+// expectation.
+static std::pair<double, std::vector<double>> parameter_shift_gradient(
+    size_t num_qubits, const std::vector<ParameterizedGate>& gates,
+    const std::vector<std::pair<std::string, double>>& observable,
+    const std::vector<double>& parameters) {
+    return compute_gradient("formotensor_parameter_shift_gradient",
+                            num_qubits, gates, observable, parameters);
+}
+
+// One contraction and backward pass for the whole observable (as an MPO).
+static std::pair<double, std::vector<double>> adjoint_gradient(
+    size_t num_qubits, const std::vector<ParameterizedGate>& gates,
+    const std::vector<std::pair<std::string, double>>& observable,
+    const std::vector<double>& parameters) {
+    return compute_gradient("formotensor_adjoint_gradient", num_qubits, gates,
+                            observable, parameters);
+}
+
 // Helper functions to work with Python State objects
 // These functions use Python API to call methods on cudaq.State objects
 class TensorNetworkHelper {
@@ -385,6 +666,187 @@ public:
     }
 };
 
+#ifdef FORMOTENSOR_HAVE_PATH_OPTIMIZER
+// Estimate of a query on a circuit by the formotensor backend
+// (formotensor_explain), on its GPU with its own path optimizer settings.
+static nvqir::ContractionEstimate explain_circuit_on_device(
+    size_t num_qubits, const std::vector<nvqir::CircuitOp>& ops,
+    const std::string& query, const std::vector<int32_t>& qubits,
+    const std::vector<std::pair<std::string, double>>& observable) {
+    std::vector<size_t> op_qubit_offsets{0};
+    std::vector<size_t> op_qubits;
+    std::vector<int> op_adjoints;
+    for (const auto& op : ops) {
+        op_qubits.insert(op_qubits.end(), op.qubits.begin(), op.qubits.end());
+        op_qubit_offsets.push_back(op_qubits.size());
+        op_adjoints.push_back(op.isAdjoint ? 1 : 0);
+    }
+    const std::vector<size_t> query_qubits(qubits.begin(), qubits.end());
+    std::vector<const char*> words;
+    std::vector<double> coefficients;
+    for (const auto& [word, coefficient] : observable) {
+        words.push_back(word.c_str());
+        coefficients.push_back(coefficient);
+    }
+
+    auto fn = reinterpret_cast<ExplainFn>(
+        get_backend_symbol("formotensor_explain"));
+    nvqir::ContractionEstimate estimate;
+    double largest_intermediate = -1.0;
+    int64_t num_slices = -1;
+    int fits_workspace = 1;
+    const char* error = nullptr;
+    {
+        py::gil_scoped_release release;
+        error = fn(query.c_str(), num_qubits, ops.size(),
+                   op_qubit_offsets.data(), op_qubits.data(),
+                   op_adjoints.data(), query_qubits.size(),
+                   query_qubits.data(), words.size(), words.data(),
+                   coefficients.data(), &estimate.flops,
+                   &largest_intermediate, &estimate.workspaceSize,
+                   &num_slices, &estimate.pathFindingSeconds,
+                   &fits_workspace);
+    }
+    if (error) {
+        throw std::runtime_error(error);
+    }
+    if (largest_intermediate >= 0.0) {
+        estimate.largestIntermediate = largest_intermediate;
+    }
+    if (num_slices >= 0) {
+        estimate.numSlices = num_slices;
+    }
+    estimate.fitsWorkspace = fits_workspace != 0;
+    return estimate;
+}
+
+// Estimate the cost of a query on a circuit (given by its gate topologies)
+// before running it: on the GPU by the formotensor backend if available, or
+// without any GPU, with the host path optimizer, e.g., to route or reject
+// jobs before submitting them.
+static nvqir::ContractionEstimate explain_circuit(
+    size_t num_qubits, const std::vector<GateTopology>& gates,
+    const std::string& query, const std::vector<int32_t>& qubits,
+    const std::string& optimizer, double time_budget,
+    const std::string& precision, int64_t workspace_limit,
+    const std::vector<std::pair<std::string, double>>& observable,
+    const std::string& device) {
+    std::vector<nvqir::CircuitOp> ops;
+    for (const auto& gate : gates) {
+        nvqir::CircuitOp op;
+        op.qubits = gate.control_qubits;
+        op.qubits.insert(op.qubits.end(), gate.target_qubits.begin(),
+                         gate.target_qubits.end());
+        op.isAdjoint = gate.is_adjoint;
+        if (op.qubits.empty()) {
+            throw std::invalid_argument(
+                "Gate topology " + std::to_string(gate.tensor_idx) +
+                " has no qubits");
+        }
+        ops.push_back(std::move(op));
+    }
+
+    if (device != "auto" && device != "gpu" && device != "host") {
+        throw std::invalid_argument(
+            "Unknown device '" + device + "', expecting 'auto', 'gpu' or "
+            "'host'");
+    }
+    // Without an observable, an expectation of a product on the operator
+    // qubits (all qubits by default), as estimated on the host.
+    auto device_observable = observable;
+    if (query == "expectation" && device_observable.empty()) {
+        std::string word(num_qubits, 'I');
+        for (size_t q = 0; q < num_qubits; ++q) {
+            if (qubits.empty() ||
+                std::find(qubits.begin(), qubits.end(),
+                          static_cast<int32_t>(q)) != qubits.end()) {
+                word[q] = 'Z';
+            }
+        }
+        device_observable.emplace_back(word, 1.0);
+    }
+    const auto on_device = [&]() {
+        auto estimate = explain_circuit_on_device(num_qubits, ops, query,
+                                                  qubits, device_observable);
+        if (workspace_limit > 0) {
+            estimate.fitsWorkspace = estimate.fitsWorkspace &&
+                                     estimate.workspaceSize <= workspace_limit;
+        }
+        return estimate;
+    };
+    if (device == "gpu") {
+        return on_device();
+    }
+    if (device == "auto" && precision == "fp64") {
+        // Falls back to the host estimate without the backend or a GPU.
+        try {
+            return on_device();
+        } catch (const std::exception&) {
+        }
+    }
+
+    std::vector<int32_t> all_qubits(num_qubits);
+    for (size_t q = 0; q < num_qubits; ++q) {
+        all_qubits[q] = static_cast<int32_t>(q);
+    }
+
+    nvqir::NetworkTopology topology;
+    if (query == "amplitudes") {
+        // Projected qubits; the other qubits are left open.
+        topology = nvqir::buildCircuitTopology(num_qubits, ops, qubits);
+    } else if (query == "rdm") {
+        topology = nvqir::buildDoubleLayerTopology(
+            nvqir::buildCircuitTopology(num_qubits, ops, {}), qubits);
+    } else if (query == "expectation") {
+        // Operator qubits: those of the observable as a single product, or
+        // the given ones (all qubits by default)
+        std::vector<int32_t> operator_qubits = qubits.empty() ? all_qubits
+                                                              : qubits;
+        if (!observable.empty()) {
+            operator_qubits.clear();
+            for (size_t q = 0; q < num_qubits; ++q) {
+                for (const auto& [word, coefficient] : observable) {
+                    if (q < word.size() && word[q] != 'I') {
+                        operator_qubits.push_back(static_cast<int32_t>(q));
+                        break;
+                    }
+                }
+            }
+        }
+        topology = nvqir::buildDoubleLayerTopology(
+            nvqir::buildCircuitTopology(num_qubits, ops, {}), {},
+            operator_qubits);
+    } else {
+        throw std::invalid_argument(
+            "Unsupported query '" + query +
+            "', expecting 'amplitudes', 'rdm' or 'expectation'");
+    }
+
+    nvqir::PathOptimizerOptions options;
+    if (auto kind = nvqir::parsePathOptimizerKind(optimizer)) {
+        options.kind = *kind;
+    } else {
+        throw std::invalid_argument(
+            "Unknown path optimizer '" + optimizer +
+            "', expecting 'greedy', 'bisection', 'random-greedy' or "
+            "'optimal'");
+    }
+    options.timeBudgetSeconds = time_budget;
+
+    if (precision != "fp64" && precision != "fp32") {
+        throw std::invalid_argument(
+            "Unknown precision '" + precision + "', expecting 'fp64' or 'fp32'");
+    }
+    const size_t element_size = precision == "fp32"
+                                    ? sizeof(std::complex<float>)
+                                    : sizeof(std::complex<double>);
+    auto estimate = nvqir::estimateContraction(topology, options, element_size);
+    estimate.fitsWorkspace =
+        workspace_limit <= 0 || estimate.workspaceSize <= workspace_limit;
+    return estimate;
+}
+#endif
+
 // Python module definition
 PYBIND11_MODULE(formotensor_bridge, m) {
     m.doc() = "FormoTensor Python Bridge - Extract Tensor Networks from CUDA-Q\n\n"
@@ -476,6 +938,134 @@ PYBIND11_MODULE(formotensor_bridge, m) {
                    "Check if the state object provides topology information",
                    py::arg("state"));
     
+    // Parameter-shift gradients
+    py::class_<ParameterizedGate>(m, "ParameterizedGate")
+        .def(py::init<const std::string&, size_t, const std::vector<size_t>&,
+                      double, int64_t, double>(),
+             py::arg("name"), py::arg("target"),
+             py::arg("controls") = std::vector<size_t>{},
+             py::arg("angle") = 0.0, py::arg("parameter") = -1,
+             py::arg("scale") = 1.0)
+        .def_readwrite("name", &ParameterizedGate::name,
+                      "Gate name (h, x, y, z, s, t, sdg, tdg, rx, ry, rz, r1)")
+        .def_readwrite("target", &ParameterizedGate::target,
+                      "Target qubit index")
+        .def_readwrite("controls", &ParameterizedGate::controls,
+                      "Control qubit indices")
+        .def_readwrite("angle", &ParameterizedGate::angle,
+                      "Fixed rotation angle (offset)")
+        .def_readwrite("parameter", &ParameterizedGate::parameter,
+                      "Index of the parameter of the angle (-1 if fixed)")
+        .def_readwrite("scale", &ParameterizedGate::scale,
+                      "Scale of the parameter in the angle");
+
+    m.def("parameter_shift_gradient", &parameter_shift_gradient,
+          "Expectation value and parameter-shift gradient of an observable\n\n"
+          "The circuit is given by its number of qubits and gates, whose\n"
+          "angle is `angle + scale * parameters[parameter]`; only\n"
+          "uncontrolled rx, ry, rz and r1 gates may depend on a parameter.\n"
+          "The observable is a list of (Pauli word, coefficient) pairs, with\n"
+          "one letter per qubit. The network is built once on the formotensor\n"
+          "backend and all the 2P+1 shifted circuits share one prepared\n"
+          "expectation. Returns (expectation, gradient).",
+          py::arg("num_qubits"), py::arg("gates"), py::arg("observable"),
+          py::arg("parameters"));
+
+    m.def("adjoint_gradient", &adjoint_gradient,
+          "Expectation value and adjoint-mode gradient of an observable\n\n"
+          "Same arguments and result as parameter_shift_gradient. The\n"
+          "network, closed by the MPO of the whole observable, is contracted\n"
+          "once and a single backward pass yields the derivatives with\n"
+          "respect to all the parameterized gates: about 3 contractions,\n"
+          "regardless of the number of terms and parameters.",
+          py::arg("num_qubits"), py::arg("gates"), py::arg("observable"),
+          py::arg("parameters"));
+
+    m.def("local_matrix_expectation", &local_matrix_expectation,
+          "Expectation value of a sum of dense local matrices\n\n"
+          "The circuit is given as for parameter_shift_gradient. Each term\n"
+          "is a (qubits, matrix, coefficient) tuple: a 2^k x 2^k matrix on\n"
+          "k distinct qubits (the first one being the most significant bit\n"
+          "of its indices), e.g., a projector or a number operator. Each\n"
+          "term is a single tensor of the network operator, instead of the\n"
+          "up to 4^k Pauli strings of its expansion. Returns a complex\n"
+          "number (real for Hermitian terms and real coefficients).",
+          py::arg("num_qubits"), py::arg("gates"), py::arg("terms"),
+          py::arg("parameters") = std::vector<double>{});
+
+    m.def("correlation_matrices", &correlation_matrices,
+          "One- and two-point Pauli correlators in a single call\n\n"
+          "The circuit is given as for parameter_shift_gradient, and the\n"
+          "Pauli pairs as consecutive letters, e.g., 'ZZXX' for <Z_i Z_j>\n"
+          "and <X_i X_j>. Returns a dict from each pair to its N x N matrix\n"
+          "(the diagonal holds 1 for identical Paulis and 0 otherwise) and\n"
+          "from each Pauli of the pairs to its N one-point correlators. The\n"
+          "arrays are views of the result buffers of the backend (no copy).\n"
+          "On 'formotensor', all the correlators share a single\n"
+          "prepared expectation; on 'formotensor-mps', they are computed\n"
+          "from the factorized state with cached environments.",
+          py::arg("num_qubits"), py::arg("gates"), py::arg("pairs"),
+          py::arg("parameters") = std::vector<double>{},
+          py::arg("backend") = "formotensor");
+
+#ifdef FORMOTENSOR_HAVE_PATH_OPTIMIZER
+    // Host-side cost estimates
+    py::class_<nvqir::ContractionEstimate>(m, "ContractionEstimate")
+        .def(py::init<>())
+        .def_readonly("flops", &nvqir::ContractionEstimate::flops,
+                     "Number of floating point operations")
+        .def_readonly("largest_intermediate",
+                     &nvqir::ContractionEstimate::largestIntermediate,
+                     "Number of elements of the largest intermediate tensor "
+                     "(None if unknown)")
+        .def_readonly("workspace_size",
+                     &nvqir::ContractionEstimate::workspaceSize,
+                     "Required workspace size in bytes")
+        .def_readonly("num_slices", &nvqir::ContractionEstimate::numSlices,
+                     "Number of slices (None if unknown)")
+        .def_readonly("path_finding_seconds",
+                     &nvqir::ContractionEstimate::pathFindingSeconds,
+                     "Time spent finding the contraction path")
+        .def_readonly("fits_workspace",
+                     &nvqir::ContractionEstimate::fitsWorkspace,
+                     "Whether the workspace fits the workspace limit")
+        .def("__repr__", [](const nvqir::ContractionEstimate& estimate) {
+            return "<ContractionEstimate: flops=" +
+                   std::to_string(estimate.flops) +
+                   ", workspace_size=" +
+                   std::to_string(estimate.workspaceSize) +
+                   ", fits_workspace=" +
+                   (estimate.fitsWorkspace ? "True" : "False") + ">";
+        });
+
+    m.def("explain_circuit", &explain_circuit,
+          "Estimate the cost of a query on a circuit without executing it\n\n"
+          "The circuit is given by its number of qubits and gate topologies\n"
+          "(e.g., from TensorNetworkHelper.get_all_topologies). Queries:\n"
+          "  'amplitudes'  - `qubits` are the projected qubits\n"
+          "  'rdm'         - `qubits` are the reduced density matrix qubits\n"
+          "  'expectation' - `observable` is a list of (Pauli word,\n"
+          "                  coefficient); without it, `qubits` are the\n"
+          "                  operator qubits (default: all)\n"
+          "  'sample'      - `qubits` are the measured qubits (GPU only)\n"
+          "With device='gpu', the formotensor backend (fp64) estimates the\n"
+          "query on its GPU, following the route observe would take for an\n"
+          "expectation. With device='host', the contraction path is found on\n"
+          "the host with the given optimizer ('greedy', 'bisection',\n"
+          "'random-greedy', 'optimal'), the observable taken as a single\n"
+          "product; host paths are not sliced: the workspace size is the\n"
+          "peak memory of the path, compared to `workspace_limit` (bytes,\n"
+          "0 = no limit). device='auto' uses the GPU if available.",
+          py::arg("num_qubits"), py::arg("gates"),
+          py::arg("query") = "amplitudes",
+          py::arg("qubits") = std::vector<int32_t>{},
+          py::arg("optimizer") = "greedy", py::arg("time_budget") = 1.0,
+          py::arg("precision") = "fp64", py::arg("workspace_limit") = 0,
+          py::arg("observable") =
+              std::vector<std::pair<std::string, double>>{},
+          py::arg("device") = "auto");
+#endif
+
     // Version info
     m.attr("__version__") = "0.3.0";
 }
@@ -0,0 +1,277 @@
+/*******************************************************************************
+ * Copyright (c) 2022 - 2025 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#include "correlation_matrix.h"
+#include "common/Logger.h"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <optional>
+#include <stdexcept>
+
+namespace nvqir {
+namespace {
+using Environment = std::vector<std::complex<double>>;
+
+// Call `visit(string, slots)` for each product of `getCorrelatorStrings`,
+// with the indices of the entries it determines (into `onePoint`, then into
+// `twoPoint` offset by the size of `onePoint`).
+template <typename Visitor>
+void visitCorrelators(const CorrelationMatrices &matrices, Visitor &&visit) {
+  const std::size_t n = matrices.numQubits;
+  for (std::size_t k = 0; k < matrices.kinds.size(); ++k)
+    for (std::size_t i = 0; i < n; ++i) {
+      const std::array<std::size_t, 1> slots{k * n + i};
+      visit(PauliString{{static_cast<int32_t>(i), matrices.kinds[k]}},
+            std::span<const std::size_t>(slots));
+    }
+  const std::size_t offset = matrices.onePoint.size();
+  for (std::size_t p = 0; p < matrices.pairs.size(); ++p) {
+    const auto [first, second] = matrices.pairs[p];
+    for (std::size_t i = 0; i < n; ++i)
+      for (std::size_t j = first == second ? i + 1 : 0; j < n; ++j) {
+        if (i == j)
+          continue;
+        const std::array<std::size_t, 2> slots{
+            offset + (p * n + i) * n + j, offset + (p * n + j) * n + i};
+        visit(PauliString{{static_cast<int32_t>(i), first},
+                          {static_cast<int32_t>(j), second}},
+              std::span<const std::size_t>(slots).first(
+                  first == second ? 2 : 1));
+      }
+  }
+}
+
+// Row-major matrix (row: output index) of `pauli`.
+std::array<std::complex<double>, 4> getPauliMatrix(PauliKind pauli) {
+  using namespace std::complex_literals;
+  switch (pauli) {
+  case PauliKind::I:
+    return {1.0, 0.0, 0.0, 1.0};
+  case PauliKind::X:
+    return {0.0, 1.0, 1.0, 0.0};
+  case PauliKind::Y:
+    return {0.0, -1i, 1i, 0.0};
+  case PauliKind::Z:
+    return {1.0, 0.0, 0.0, -1.0};
+  }
+  __builtin_unreachable();
+}
+
+// Left environment past `site` from the one before it (D x D, column-major
+// with the ket bond first), with `pauli` applied on the site:
+// E'(b, b') = sum E(a, a') A(a, p, b) O(q, p) conj(A(a', q, b')).
+Environment transferLeft(const HostMps &mps, std::size_t site,
+                         const Environment &env, PauliKind pauli) {
+  const int64_t dl = mps.leftBondDim(site);
+  const int64_t dr = mps.rightBondDim(site);
+  const auto &tensor = mps.tensors[site];
+  const auto at = [&](int64_t l, int64_t p, int64_t r) {
+    return tensor[l + dl * (p + 2 * r)];
+  };
+  // X(a', p, b) = sum_a E(a, a') A(a, p, b)
+  Environment x(dl * 2 * dr, 0.0);
+  for (int64_t b = 0; b < dr; ++b)
+    for (int64_t p = 0; p < 2; ++p)
+      for (int64_t ap = 0; ap < dl; ++ap) {
+        std::complex<double> sum = 0.0;
+        for (int64_t a = 0; a < dl; ++a)
+          sum += env[a + dl * ap] * at(a, p, b);
+        x[ap + dl * (p + 2 * b)] = sum;
+      }
+  if (pauli != PauliKind::I) {
+    const auto op = getPauliMatrix(pauli);
+    for (int64_t b = 0; b < dr; ++b)
+      for (int64_t ap = 0; ap < dl; ++ap) {
+        const auto x0 = x[ap + dl * (2 * b)];
+        const auto x1 = x[ap + dl * (1 + 2 * b)];
+        x[ap + dl * (2 * b)] = op[0] * x0 + op[1] * x1;
+        x[ap + dl * (1 + 2 * b)] = op[2] * x0 + op[3] * x1;
+      }
+  }
+  // E'(b, b') = sum_{a', q} X(a', q, b) conj(A(a', q, b'))
+  Environment result(dr * dr, 0.0);
+  for (int64_t bp = 0; bp < dr; ++bp)
+    for (int64_t b = 0; b < dr; ++b) {
+      std::complex<double> sum = 0.0;
+      for (int64_t q = 0; q < 2; ++q)
+        for (int64_t ap = 0; ap < dl; ++ap)
+          sum += x[ap + dl * (q + 2 * b)] * std::conj(at(ap, q, bp));
+      result[b + dr * bp] = sum;
+    }
+  return result;
+}
+
+// Right environment before `site` from the one after it:
+// R'(a, a') = sum A(a, p, b) conj(A(a', p, b')) R(b, b').
+Environment transferRight(const HostMps &mps, std::size_t site,
+                          const Environment &env) {
+  const int64_t dl = mps.leftBondDim(site);
+  const int64_t dr = mps.rightBondDim(site);
+  const auto &tensor = mps.tensors[site];
+  const auto at = [&](int64_t l, int64_t p, int64_t r) {
+    return tensor[l + dl * (p + 2 * r)];
+  };
+  // Z(a, p, b') = sum_b A(a, p, b) R(b, b')
+  Environment z(dl * 2 * dr, 0.0);
+  for (int64_t bp = 0; bp < dr; ++bp)
+    for (int64_t b = 0; b < dr; ++b) {
+      const auto r = env[b + dr * bp];
+      for (int64_t p = 0; p < 2; ++p)
+        for (int64_t a = 0; a < dl; ++a)
+          z[a + dl * (p + 2 * bp)] += at(a, p, b) * r;
+    }
+  Environment result(dl * dl, 0.0);
+  for (int64_t ap = 0; ap < dl; ++ap)
+    for (int64_t a = 0; a < dl; ++a) {
+      std::complex<double> sum = 0.0;
+      for (int64_t bp = 0; bp < dr; ++bp)
+        for (int64_t p = 0; p < 2; ++p)
+          sum += z[a + dl * (p + 2 * bp)] * std::conj(at(ap, p, bp));
+      result[a + dl * ap] = sum;
+    }
+  return result;
+}
+
+// Full contraction of a left and a right environment of the same bond.
+double contractEnvironments(const Environment &left,
+                            const Environment &right) {
+  assert(left.size() == right.size());
+  std::complex<double> sum = 0.0;
+  for (std::size_t i = 0; i < left.size(); ++i)
+    sum += left[i] * right[i];
+  return sum.real();
+}
+} // namespace
+
+std::vector<PauliPair> parsePauliPairs(std::string_view letters) {
+  if (letters.size() % 2 != 0)
+    throw std::invalid_argument(fmt::format(
+        "Expecting Pauli pairs (two letters each), got '{}'.", letters));
+  const auto toPauli = [&](char letter) {
+    switch (letter) {
+    case 'X':
+      return PauliKind::X;
+    case 'Y':
+      return PauliKind::Y;
+    case 'Z':
+      return PauliKind::Z;
+    }
+    throw std::invalid_argument(fmt::format(
+        "Invalid Pauli '{}' in the pairs '{}' (expecting X, Y or Z).", letter,
+        letters));
+  };
+  std::vector<PauliPair> pairs;
+  for (std::size_t i = 0; i < letters.size(); i += 2)
+    pairs.emplace_back(toPauli(letters[i]), toPauli(letters[i + 1]));
+  return pairs;
+}
+
+CorrelationMatrices makeCorrelationMatrices(std::span<const PauliPair> pairs,
+                                            std::size_t numQubits) {
+  CorrelationMatrices matrices;
+  matrices.numQubits = numQubits;
+  matrices.pairs.assign(pairs.begin(), pairs.end());
+  for (const auto pauli : {PauliKind::X, PauliKind::Y, PauliKind::Z})
+    if (std::any_of(pairs.begin(), pairs.end(), [&](const PauliPair &pair) {
+          return pair.first == pauli || pair.second == pauli;
+        }))
+      matrices.kinds.emplace_back(pauli);
+  for (const auto &[first, second] : pairs)
+    if (first == PauliKind::I || second == PauliKind::I)
+      throw std::invalid_argument(
+          "Correlator pairs must not involve the identity.");
+  matrices.onePoint.assign(matrices.kinds.size() * numQubits, 0.0);
+  matrices.twoPoint.assign(pairs.size() * numQubits * numQubits, 0.0);
+  for (std::size_t p = 0; p < pairs.size(); ++p)
+    for (std::size_t i = 0; i < numQubits; ++i)
+      matrices.at(p, i, i) = pairs[p].first == pairs[p].second ? 1.0 : 0.0;
+  return matrices;
+}
+
+std::vector<PauliString>
+getCorrelatorStrings(const CorrelationMatrices &matrices) {
+  std::vector<PauliString> strings;
+  visitCorrelators(matrices, [&](PauliString &&string,
+                                 std::span<const std::size_t>) {
+    strings.emplace_back(std::move(string));
+  });
+  return strings;
+}
+
+void setCorrelatorValues(CorrelationMatrices &matrices,
+                         std::span<const double> values) {
+  const std::size_t offset = matrices.onePoint.size();
+  std::size_t valueIdx = 0;
+  visitCorrelators(matrices, [&](PauliString &&,
+                                 std::span<const std::size_t> slots) {
+    assert(valueIdx < values.size());
+    for (const auto slot : slots)
+      (slot < offset ? matrices.onePoint[slot]
+                     : matrices.twoPoint[slot - offset]) = values[valueIdx];
+    ++valueIdx;
+  });
+  assert(valueIdx == values.size());
+}
+
+void computeMpsCorrelations(const HostMps &mps,
+                            CorrelationMatrices &matrices) {
+  const std::size_t n = mps.numSites();
+  if (n != matrices.numQubits)
+    throw std::invalid_argument("The MPS does not match the number of qubits "
+                                "of the correlation matrices.");
+  if (n == 0)
+    return;
+  // left[i] is the environment of the bond before site i, right[i] that of
+  // the bond after it.
+  std::vector<Environment> left(n), right(n);
+  left[0] = {1.0};
+  for (std::size_t site = 1; site < n; ++site)
+    left[site] = transferLeft(mps, site - 1, left[site - 1], PauliKind::I);
+  right[n - 1] = {1.0};
+  for (std::size_t site = n - 1; site > 0; --site)
+    right[site - 1] = transferRight(mps, site, right[site]);
+  const double norm = contractEnvironments(
+      transferLeft(mps, 0, left[0], PauliKind::I), right[0]);
+  if (!(norm > 0.0))
+    throw std::runtime_error("Cannot compute correlators of a zero state.");
+
+  for (std::size_t k = 0; k < matrices.kinds.size(); ++k) {
+    const PauliKind first = matrices.kinds[k];
+    for (std::size_t i = 0; i < n; ++i) {
+      // Transfer of `first` on site i, carried to the right through
+      // identities.
+      Environment env = transferLeft(mps, i, left[i], first);
+      matrices.onePoint[k * n + i] =
+          contractEnvironments(env, right[i]) / norm;
+      for (std::size_t j = i + 1; j < n; ++j) {
+        // <first_i P_j>, computed once per Pauli P.
+        std::array<std::optional<double>, 4> closed;
+        const auto closeWith = [&](PauliKind pauli) {
+          auto &value = closed[static_cast<std::size_t>(pauli)];
+          if (!value)
+            value = contractEnvironments(transferLeft(mps, j, env, pauli),
+                                         right[j]) /
+                    norm;
+          return *value;
+        };
+        for (std::size_t p = 0; p < matrices.pairs.size(); ++p) {
+          const auto [a, b] = matrices.pairs[p];
+          // <A_i B_j>, and <A_j B_i> = <B_i A_j>.
+          if (a == first)
+            matrices.at(p, i, j) = closeWith(b);
+          if (b == first)
+            matrices.at(p, j, i) = closeWith(a);
+        }
+        if (j + 1 < n)
+          env = transferLeft(mps, j, env, PauliKind::I);
+      }
+    }
+  }
+}
+} // namespace nvqir
@@ -0,0 +1,97 @@
+/****************************************************************-*- C++ -*-****
+ * Copyright (c) 2022 - 2025 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#pragma once
+
+#include "pauli_grouping.h"
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace nvqir {
+
+/// @brief Paulis (A, B) of the two-point correlators <A_i B_j>, e.g.,
+/// (Z, Z) or (X, Y).
+using PauliPair = std::pair<PauliKind, PauliKind>;
+
+/// @brief Pairs given as consecutive Pauli letters, e.g., "ZZXY" for (Z, Z)
+/// and (X, Y). Throws `std::invalid_argument` on other letters (including
+/// `I`) or an odd number of letters.
+std::vector<PauliPair> parsePauliPairs(std::string_view letters);
+
+/// @brief One- and two-point Pauli correlators of a state of `numQubits`
+/// qubits, as dense row-major arrays.
+struct CorrelationMatrices {
+  std::size_t numQubits = 0;
+  // Paulis of the one-point correlators (the distinct Paulis of the pairs, in
+  // X, Y, Z order), and <P_i> at `onePoint[k * numQubits + i]` for
+  // `P = kinds[k]`.
+  std::vector<PauliKind> kinds;
+  std::vector<double> onePoint;
+  // Requested pairs, and for pair `p = (A, B)` the N x N matrix of <A_i B_j>
+  // at `twoPoint[(p * numQubits + i) * numQubits + j]`. Its diagonal holds
+  // the symmetrized product (A B + B A) / 2 on one qubit, i.e., 1 if A == B
+  // and 0 otherwise.
+  std::vector<PauliPair> pairs;
+  std::vector<double> twoPoint;
+
+  double &at(std::size_t pair, std::size_t i, std::size_t j) {
+    return twoPoint[(pair * numQubits + i) * numQubits + j];
+  }
+};
+
+/// @brief Correlation matrices of `pairs` on `numQubits` qubits, with the
+/// diagonals set and the other correlators zero. Throws
+/// `std::invalid_argument` if a pair involves the identity.
+CorrelationMatrices makeCorrelationMatrices(std::span<const PauliPair> pairs,
+                                            std::size_t numQubits);
+
+/// @brief Pauli products whose expectations determine `matrices`: the
+/// one-point products, then per pair `(A, B)` the products `A_i B_j` for
+/// `i != j` (only `i < j` if A == B, by symmetry).
+std::vector<PauliString>
+getCorrelatorStrings(const CorrelationMatrices &matrices);
+
+/// @brief Fill `matrices` with the expectations of the products of
+/// `getCorrelatorStrings` (same order).
+void setCorrelatorValues(CorrelationMatrices &matrices,
+                         std::span<const double> values);
+
+/// @brief Matrix product state (open boundaries) copied to the host, one site
+/// per qubit. The tensor of each site is column-major with modes (left bond,
+/// physical, right bond), i.e., element `(l, p, r)` at `l + Dl * (p + 2 * r)`,
+/// with bond dimension 1 at the edges; this is the layout of finalized
+/// cuTensorNet MPS tensors (whose edge tensors simply omit the trivial mode).
+struct HostMps {
+  // Bond dimension between sites `i` and `i + 1`.
+  std::vector<int64_t> bondDims;
+  std::vector<std::vector<std::complex<double>>> tensors;
+
+  std::size_t numSites() const { return tensors.size(); }
+  int64_t leftBondDim(std::size_t site) const {
+    return site == 0 ? 1 : bondDims[site - 1];
+  }
+  int64_t rightBondDim(std::size_t site) const {
+    return site + 1 == numSites() ? 1 : bondDims[site];
+  }
+};
+
+/// @brief Fill `matrices` from `mps` (not necessarily normalized or in
+/// canonical form) with environment caching: one sweep from each end
+/// computes the left and right environments of all the bonds, then each
+/// correlator row `i` is a single sweep from site `i` to the right, reusing
+/// the transfer of the operator at `i` for all `j > i`. That is O(N^2)
+/// transfer-matrix contractions of O(D^3) each (D the bond dimension) per
+/// distinct Pauli, instead of one full contraction per correlator.
+void computeMpsCorrelations(const HostMps &mps,
+                            CorrelationMatrices &matrices);
+} // namespace nvqir
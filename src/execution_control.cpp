@@ -0,0 +1,165 @@
+/*******************************************************************************
+ * Copyright (c) 2022 - 2025 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#include "execution_control.h"
+#include "common/Logger.h"
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace nvqir {
+namespace {
+constexpr auto noDeadline = ExecutionControl::Clock::duration::max().count();
+
+std::atomic<ExecutionControl *> g_currentControl{nullptr};
+
+// Number of queries in progress on this thread.
+thread_local std::size_t t_queryDepth = 0;
+} // namespace
+
+void ExecutionControl::setDeadline(Clock::time_point deadline) {
+  m_deadline.store(deadline.time_since_epoch().count(),
+                   std::memory_order_relaxed);
+}
+
+void ExecutionControl::setTimeout(double seconds) {
+  setDeadline(Clock::now() +
+              std::chrono::duration_cast<Clock::duration>(
+                  std::chrono::duration<double>(std::max(seconds, 0.0))));
+}
+
+void ExecutionControl::clearDeadline() {
+  m_deadline.store(noDeadline, std::memory_order_relaxed);
+}
+
+std::optional<ExecutionControl::Clock::time_point>
+ExecutionControl::getDeadline() const {
+  const auto deadline = m_deadline.load(std::memory_order_relaxed);
+  if (deadline == noDeadline)
+    return std::nullopt;
+  return Clock::time_point(Clock::duration(deadline));
+}
+
+bool ExecutionControl::shouldStop() const {
+  if (isCancelled())
+    return true;
+  const auto deadline = m_deadline.load(std::memory_order_relaxed);
+  return deadline != noDeadline &&
+         Clock::now().time_since_epoch().count() >= deadline;
+}
+
+ExecutionProgress ExecutionControl::getProgress() const {
+  ExecutionProgress progress;
+  progress.slicesDone = m_slicesDone.load(std::memory_order_relaxed);
+  progress.trajectoriesDone =
+      m_trajectoriesDone.load(std::memory_order_relaxed);
+  progress.shotsDone = m_shotsDone.load(std::memory_order_relaxed);
+  return progress;
+}
+
+void ExecutionControl::reset() {
+  m_cancelled.store(false, std::memory_order_relaxed);
+  m_partial.store(false, std::memory_order_relaxed);
+  m_slicesDone.store(0, std::memory_order_relaxed);
+  m_trajectoriesDone.store(0, std::memory_order_relaxed);
+  m_shotsDone.store(0, std::memory_order_relaxed);
+}
+
+ExecutionControl *ExecutionControl::current() {
+  return g_currentControl.load(std::memory_order_acquire);
+}
+
+ScopedExecutionControl::ScopedExecutionControl(ExecutionControl &control)
+    : m_previous(g_currentControl.exchange(&control,
+                                           std::memory_order_acq_rel)) {}
+
+ScopedExecutionControl::~ScopedExecutionControl() {
+  g_currentControl.store(m_previous, std::memory_order_release);
+}
+
+QueryExecutionControl::QueryExecutionControl()
+    : m_control(ExecutionControl::current()), m_depth(t_queryDepth++) {
+  if (!m_control) {
+    if (const auto &timeLimit = getDefaultQueryTimeLimit()) {
+      m_default.emplace(*timeLimit);
+      m_scope.emplace(*m_default);
+      m_control = &*m_default;
+    }
+  }
+  if (m_control) {
+    m_wasPartial = m_control->isPartial();
+    m_start = m_control->getProgress();
+  }
+}
+
+QueryExecutionControl::~QueryExecutionControl() {
+  --t_queryDepth;
+  if (m_depth > 0)
+    return;
+  if (const auto progress = getPartialProgress())
+    CUDAQ_WARN("Query stopped early by its execution control after {} "
+               "slices, {} trajectories and {} shots: the results are "
+               "partial.",
+               progress->slicesDone, progress->trajectoriesDone,
+               progress->shotsDone);
+}
+
+std::optional<ExecutionProgress>
+QueryExecutionControl::getPartialProgress() const {
+  if (!m_control || m_wasPartial || !m_control->isPartial())
+    return std::nullopt;
+  const auto progress = m_control->getProgress();
+  ExecutionProgress queryProgress;
+  queryProgress.slicesDone = progress.slicesDone - m_start.slicesDone;
+  queryProgress.trajectoriesDone =
+      progress.trajectoriesDone - m_start.trajectoriesDone;
+  queryProgress.shotsDone = progress.shotsDone - m_start.shotsDone;
+  return queryProgress;
+}
+
+const std::optional<double> &getDefaultQueryTimeLimit() {
+  static const std::optional<double> timeLimit =
+      []() -> std::optional<double> {
+    auto *envVal = std::getenv("CUDAQ_TENSORNET_TIME_LIMIT");
+    if (!envVal)
+      return std::nullopt;
+    char *end = nullptr;
+    const double seconds = std::strtod(envVal, &end);
+    if (end == envVal || *end != '\0' || !(seconds > 0.0))
+      throw std::runtime_error(fmt::format(
+          "Invalid CUDAQ_TENSORNET_TIME_LIMIT environment variable setting. "
+          "Expecting a positive number of seconds, got '{}'.",
+          envVal));
+    CUDAQ_INFO("Using a time limit of {} seconds per query.", seconds);
+    return seconds;
+  }();
+  return timeLimit;
+}
+
+bool stopRequested(ExecutionControl *control) {
+  if (!control || !control->shouldStop())
+    return false;
+  control->markPartial();
+  return true;
+}
+
+std::size_t getShotBatchSize(std::size_t shots,
+                             const ExecutionControl *control) {
+  constexpr std::size_t maxBatches = 16;
+  if (!control)
+    return std::max<std::size_t>(shots, 1);
+  return std::max<std::size_t>((shots + maxBatches - 1) / maxBatches, 1);
+}
+
+int64_t getSliceGroupSize(int64_t numSlices, const ExecutionControl *control) {
+  constexpr int64_t maxGroups = 32;
+  if (!control)
+    return std::max<int64_t>(numSlices, 1);
+  return std::max<int64_t>((numSlices + maxGroups - 1) / maxGroups, 1);
+}
+} // namespace nvqir
@@ -0,0 +1,168 @@
+/****************************************************************-*- C++ -*-****
+ * Copyright (c) 2022 - 2025 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace nvqir {
+
+/// @brief Progress of the queries run under an `ExecutionControl`.
+struct ExecutionProgress {
+  // Contracted slices of sliced network contractions.
+  std::size_t slicesDone = 0;
+  // Completed noise trajectories (sampling or expectation values).
+  std::size_t trajectoriesDone = 0;
+  // Drawn shots.
+  std::size_t shotsDone = 0;
+};
+
+/// @brief Deadline, cancellation token and progress counters of long-running
+/// queries. The simulator checks it between slices, trajectories and shot
+/// batches; once it should stop, the query returns what it has computed so
+/// far (e.g., the counts of the shots drawn so far, or the expectation value
+/// averaged over the trajectories run so far) and the control is marked as
+/// partial.
+///
+/// All members may be called from any thread, e.g., `cancel` from a thread
+/// other than the one running the query.
+class ExecutionControl {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  ExecutionControl() = default;
+  /// @brief Control with a deadline `timeoutSeconds` from now.
+  explicit ExecutionControl(double timeoutSeconds) {
+    setTimeout(timeoutSeconds);
+  }
+  ExecutionControl(const ExecutionControl &) = delete;
+  ExecutionControl &operator=(const ExecutionControl &) = delete;
+
+  void setDeadline(Clock::time_point deadline);
+  /// @brief Set the deadline `seconds` from now.
+  void setTimeout(double seconds);
+  void clearDeadline();
+  std::optional<Clock::time_point> getDeadline() const;
+
+  /// @brief Request the queries to stop as soon as possible.
+  void cancel() { m_cancelled.store(true, std::memory_order_relaxed); }
+  bool isCancelled() const {
+    return m_cancelled.load(std::memory_order_relaxed);
+  }
+
+  /// @brief True if the queries should stop: cancelled or past the deadline.
+  bool shouldStop() const;
+
+  void addSlices(std::size_t count) {
+    m_slicesDone.fetch_add(count, std::memory_order_relaxed);
+  }
+  void addTrajectories(std::size_t count) {
+    m_trajectoriesDone.fetch_add(count, std::memory_order_relaxed);
+  }
+  void addShots(std::size_t count) {
+    m_shotsDone.fetch_add(count, std::memory_order_relaxed);
+  }
+  ExecutionProgress getProgress() const;
+
+  /// @brief Mark the results as partial, i.e., a query stopped early.
+  void markPartial() { m_partial.store(true, std::memory_order_relaxed); }
+  bool isPartial() const { return m_partial.load(std::memory_order_relaxed); }
+
+  /// @brief Clear the cancellation, the partial flag and the progress
+  /// counters (the deadline is kept).
+  void reset();
+
+  /// @brief Control of the queries of the process, or null if none is
+  /// installed (see `ScopedExecutionControl`).
+  static ExecutionControl *current();
+
+private:
+  // Deadline in clock ticks since the epoch (no deadline: max).
+  std::atomic<Clock::rep> m_deadline{Clock::duration::max().count()};
+  std::atomic<bool> m_cancelled{false};
+  std::atomic<bool> m_partial{false};
+  std::atomic<std::size_t> m_slicesDone{0};
+  std::atomic<std::size_t> m_trajectoriesDone{0};
+  std::atomic<std::size_t> m_shotsDone{0};
+};
+
+/// @brief Install an execution control for the lifetime of this object (the
+/// previously installed one is restored on destruction).
+class ScopedExecutionControl {
+public:
+  explicit ScopedExecutionControl(ExecutionControl &control);
+  ~ScopedExecutionControl();
+  ScopedExecutionControl(const ScopedExecutionControl &) = delete;
+  ScopedExecutionControl &operator=(const ScopedExecutionControl &) = delete;
+
+private:
+  ExecutionControl *m_previous;
+};
+
+/// @brief Register of the observe result entry of a query stopped early by
+/// its execution control: its counts are the slices, trajectories and shots
+/// actually run (keys `slices`, `trajectories` and `shots`).
+inline constexpr const char *g_partialResultRegister = "__partial__";
+
+/// @brief Execution control of a query: the installed one, if any, or else a
+/// control with the default time limit of the process.
+///
+/// `CUDAQ_TENSORNET_TIME_LIMIT` sets a default time limit (in seconds) per
+/// sampling or expectation value query, applied when no control is
+/// installed. The outermost query stopped early logs a warning on
+/// destruction, since nothing else may see the partial flag of a default
+/// control.
+class QueryExecutionControl {
+public:
+  QueryExecutionControl();
+  ~QueryExecutionControl();
+  QueryExecutionControl(const QueryExecutionControl &) = delete;
+  QueryExecutionControl &operator=(const QueryExecutionControl &) = delete;
+
+  /// @brief The control of the query, or null if it is unbounded.
+  ExecutionControl *get() const { return m_control; }
+
+  /// @brief Progress of the query if its control stopped it early (i.e., the
+  /// control was marked as partial during the query), else none.
+  std::optional<ExecutionProgress> getPartialProgress() const;
+
+private:
+  std::optional<ExecutionControl> m_default;
+  std::optional<ScopedExecutionControl> m_scope;
+  ExecutionControl *m_control = nullptr;
+  // State of the control when the query started.
+  bool m_wasPartial = false;
+  ExecutionProgress m_start;
+  // Depth of nested queries (e.g., the sampling of each measurement basis of
+  // a shot-based observe), of which only the outermost one logs.
+  std::size_t m_depth = 0;
+};
+
+/// @brief Default time limit of a query, if any (see
+/// `QueryExecutionControl`).
+const std::optional<double> &getDefaultQueryTimeLimit();
+
+/// @brief True if the query run under `control` (possibly null) should stop.
+/// Marks the control as partial if so.
+bool stopRequested(ExecutionControl *control);
+
+/// @brief Number of shots drawn per batch, so that the control can be checked
+/// between batches: all shots at once without a control, else up to 16
+/// batches.
+std::size_t getShotBatchSize(std::size_t shots,
+                             const ExecutionControl *control);
+
+/// @brief Number of slices contracted per group, so that the control can be
+/// checked between groups: all slices at once without a control, else up to
+/// 32 groups.
+int64_t getSliceGroupSize(int64_t numSlices, const ExecutionControl *control);
+} // namespace nvqir
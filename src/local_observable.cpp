@@ -0,0 +1,43 @@
+/*******************************************************************************
+ * Copyright (c) 2022 - 2025 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#include "local_observable.h"
+#include "common/Logger.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace nvqir {
+
+void validateLocalMatrixTerms(std::span<const LocalMatrixTerm> terms,
+                              std::size_t numQubits) {
+  for (std::size_t termIdx = 0; termIdx < terms.size(); ++termIdx) {
+    const auto &term = terms[termIdx];
+    // The matrix of more qubits than that would not fit in memory anyway.
+    if (term.qubits.size() > 30)
+      throw std::invalid_argument(fmt::format(
+          "Term {} acts on {} qubits, too many for a dense matrix.", termIdx,
+          term.qubits.size()));
+    for (std::size_t i = 0; i < term.qubits.size(); ++i) {
+      if (term.qubits[i] >= numQubits)
+        throw std::invalid_argument(
+            fmt::format("Term {} acts on qubit {} of a {}-qubit state.",
+                        termIdx, term.qubits[i], numQubits));
+      if (std::find(term.qubits.begin(), term.qubits.begin() + i,
+                    term.qubits[i]) != term.qubits.begin() + i)
+        throw std::invalid_argument(fmt::format(
+            "Term {} acts twice on qubit {}.", termIdx, term.qubits[i]));
+    }
+    const std::size_t dim = std::size_t{1} << term.qubits.size();
+    if (term.matrix.size() != dim * dim)
+      throw std::invalid_argument(fmt::format(
+          "Term {} acts on {} qubits, but its matrix has {} elements "
+          "(expecting {}).",
+          termIdx, term.qubits.size(), term.matrix.size(), dim * dim));
+  }
+}
+} // namespace nvqir
@@ -0,0 +1,37 @@
+/****************************************************************-*- C++ -*-****
+ * Copyright (c) 2022 - 2025 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#pragma once
+
+#include <complex>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace nvqir {
+
+/// @brief Term of an observable given as a dense matrix on a few qubits
+/// (e.g., a projector, a number operator or a general k-local Hermitian
+/// operator). It is appended to the network operator as a single tensor,
+/// instead of the up to 4^k Pauli products of its expansion.
+struct LocalMatrixTerm {
+  // Distinct qubits acted on (none for a constant term).
+  std::vector<std::size_t> qubits;
+  // Row-major 2^k x 2^k matrix on the k qubits, in the layout of gate
+  // matrices: `qubits[0]` is the most significant bit of the row and column
+  // indices.
+  std::vector<std::complex<double>> matrix;
+  std::complex<double> coefficient = 1.0;
+};
+
+/// @brief Check the terms of an observable on `numQubits` qubits: distinct
+/// qubits in range, and matrices of 4^k elements for k qubits. Throws
+/// `std::invalid_argument` otherwise.
+void validateLocalMatrixTerms(std::span<const LocalMatrixTerm> terms,
+                              std::size_t numQubits);
+} // namespace nvqir
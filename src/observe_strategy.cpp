@@ -0,0 +1,96 @@
+/*******************************************************************************
+ * Copyright (c) 2022 - 2025 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#include "observe_strategy.h"
+#include "common/Logger.h"
+#include <algorithm>
+#include <cstdlib>
+#include <numeric>
+#include <stdexcept>
+
+namespace nvqir {
+namespace {
+// Observables with at least that many terms are evaluated per term.
+constexpr std::size_t minTermsPerTermMode = 32;
+// Observables whose terms all act on at most that many qubits are evaluated
+// from reduced density matrices.
+constexpr std::size_t maxLocalTermWeight = 3;
+// Observables of MPS states with at least that many terms are evaluated as an
+// MPO.
+constexpr std::size_t minTermsMpoMode = 16;
+} // namespace
+
+std::optional<ObserveMode> parseObserveMode(std::string_view name) {
+  if (name == "auto")
+    return ObserveMode::Auto;
+  if (name == "operator")
+    return ObserveMode::Operator;
+  if (name == "per-term")
+    return ObserveMode::PerTerm;
+  if (name == "grouped")
+    return ObserveMode::Grouped;
+  if (name == "local")
+    return ObserveMode::Local;
+  if (name == "mpo")
+    return ObserveMode::Mpo;
+  if (name == "pauli-propagation")
+    return ObserveMode::PauliPropagation;
+  return std::nullopt;
+}
+
+ObserveMode getObserveModeSetting() {
+  static const ObserveMode mode = []() {
+    auto *envVal = std::getenv("CUDAQ_TENSORNET_OBSERVE_MODE");
+    if (!envVal)
+      return ObserveMode::Auto;
+    auto mode = parseObserveMode(envVal);
+    if (!mode)
+      throw std::runtime_error(fmt::format(
+          "Invalid CUDAQ_TENSORNET_OBSERVE_MODE environment variable setting. "
+          "Expecting one of 'auto', 'operator', 'per-term', 'grouped', "
+          "'local', 'mpo' or 'pauli-propagation', got '{}'.",
+          envVal));
+    CUDAQ_INFO("Using observe mode '{}'.", envVal);
+    return *mode;
+  }();
+  return mode;
+}
+
+ObserveMode chooseObserveMode(std::size_t numQubits,
+                              const std::vector<std::size_t> &termWeights) {
+  if (termWeights.size() <= 1)
+    return ObserveMode::Operator;
+  if (std::all_of(termWeights.begin(), termWeights.end(),
+                  [](std::size_t weight) {
+                    return weight <= maxLocalTermWeight;
+                  }))
+    return ObserveMode::Local;
+  if (termWeights.size() >= minTermsPerTermMode)
+    return ObserveMode::PerTerm;
+  // Terms acting on more than half of the qubits (on average): their light
+  // cones span most of the network anyway.
+  const std::size_t totalWeight =
+      std::accumulate(termWeights.begin(), termWeights.end(), std::size_t{0});
+  if (2 * totalWeight > numQubits * termWeights.size())
+    return ObserveMode::PerTerm;
+  return ObserveMode::Operator;
+}
+
+ObserveMode chooseMpsObserveMode(std::size_t numQubits,
+                                 const std::vector<std::size_t> &termWeights) {
+  if (termWeights.size() >= minTermsMpoMode)
+    return ObserveMode::Mpo;
+  return chooseObserveMode(numQubits, termWeights);
+}
+
+bool shouldGroupTerms(std::size_t numTerms, const PauliTermGrouping &grouping) {
+  const std::size_t numContractions =
+      grouping.groups.size() + grouping.ungrouped.size();
+  return 2 * numContractions <= numTerms;
+}
+} // namespace nvqir
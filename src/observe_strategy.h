@@ -0,0 +1,87 @@
+/****************************************************************-*- C++ -*-****
+ * Copyright (c) 2022 - 2025 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#pragma once
+
+#include "pauli_grouping.h"
+#include <cstddef>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace nvqir {
+
+/// @brief How the expectation value of an observable (sum of Pauli products)
+/// is evaluated.
+enum class ObserveMode {
+  // Choose per observable (see `chooseObserveMode`).
+  Auto,
+  // A single expectation of the whole operator: one pass, with the light cone
+  // of each term simplified by cuTensorNet, but only the total is known.
+  Operator,
+  // A single expectation object prepared once for a product of placeholder
+  // operators on all qubits, evaluated for each term by updating the
+  // placeholders: contraction intermediates of the state are reused across
+  // terms, and the expectation of each term is known.
+  PerTerm,
+  // Terms grouped into qubit-wise-commuting families, with a single reduced
+  // density matrix contracted per family (see `groupQubitWiseCommuting`); the
+  // expectation of each term is known.
+  Grouped,
+  // Terms grouped by support, with a single reduced density matrix contracted
+  // per distinct support (see `groupBySupport`); the expectation of each term
+  // is known.
+  Local,
+  // A single expectation of the observable compressed into a matrix product
+  // operator (see `buildPauliSumMpo`): one contraction whose cost depends on
+  // the bond dimension of the operator rather than on its number of terms,
+  // but only the total is known.
+  Mpo,
+  // The observable evolved backwards through the gates as a truncated sum of
+  // Pauli products and evaluated on |0...0> on the host (see
+  // `propagatePauliSum`): no contraction, with a cost set by the non-Clifford
+  // gates in the light cone of the observable, an error bound from the
+  // truncation, and only the total known. Circuits it does not apply to
+  // (noise, initial states, large gates) fall back to `Auto`.
+  PauliPropagation
+};
+
+/// @brief Parse an `ObserveMode` from its name (`auto`, `operator`,
+/// `per-term`, `grouped`, `local`, `mpo` or `pauli-propagation`).
+std::optional<ObserveMode> parseObserveMode(std::string_view name);
+
+/// @brief Observe mode configured from the environment.
+///
+/// `CUDAQ_TENSORNET_OBSERVE_MODE` is `auto` (default), `operator`, `per-term`,
+/// `grouped`, `local`, `mpo` or `pauli-propagation`.
+ObserveMode getObserveModeSetting();
+
+/// @brief Evaluation mode of an observable on `numQubits` qubits whose
+/// (non-identity) terms act on `termWeights` qubits each.
+///
+/// A single term is evaluated as a whole operator. Terms of low weight (at
+/// most 3 qubits, e.g., spin models or QAOA cost functions) are evaluated from
+/// the reduced density matrices of their supports. Otherwise, a few terms are
+/// evaluated as a whole operator so that each term only contracts its light
+/// cone, while many terms, or terms acting on most of the qubits (where light
+/// cones do not help), are evaluated per term, reusing the prepared network
+/// and its intermediates.
+ObserveMode chooseObserveMode(std::size_t numQubits,
+                              const std::vector<std::size_t> &termWeights);
+
+/// @brief Evaluation mode of an observable on an MPS state (same arguments
+/// as `chooseObserveMode`): many terms are evaluated as a single MPO, whose
+/// contraction with the MPS is a sweep over the qubits, as cheap as a few
+/// reduced density matrices; otherwise as `chooseObserveMode`.
+ObserveMode chooseMpsObserveMode(std::size_t numQubits,
+                                 const std::vector<std::size_t> &termWeights);
+
+/// @brief True if evaluating `numTerms` terms by the families of `grouping`
+/// saves enough contractions (at least half) over evaluating them per term.
+bool shouldGroupTerms(std::size_t numTerms, const PauliTermGrouping &grouping);
+} // namespace nvqir
@@ -0,0 +1,285 @@
+/*******************************************************************************
+ * Copyright (c) 2022 - 2025 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#include "parameterized_circuit.h"
+#include "common/Logger.h"
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace nvqir {
+namespace {
+bool isRotation(const std::string &name) {
+  return name == "rx" || name == "ry" || name == "rz" || name == "r1";
+}
+} // namespace
+
+std::vector<std::complex<double>> getCircuitGateMatrix(const std::string &name,
+                                                       double angle) {
+  using namespace std::complex_literals;
+  const double invSqrt2 = 1.0 / std::sqrt(2.0);
+  const double cosHalf = std::cos(angle / 2.0);
+  const double sinHalf = std::sin(angle / 2.0);
+  if (name == "h")
+    return {invSqrt2, invSqrt2, invSqrt2, -invSqrt2};
+  if (name == "x")
+    return {0.0, 1.0, 1.0, 0.0};
+  if (name == "y")
+    return {0.0, -1i, 1i, 0.0};
+  if (name == "z")
+    return {1.0, 0.0, 0.0, -1.0};
+  if (name == "s")
+    return {1.0, 0.0, 0.0, 1i};
+  if (name == "sdg")
+    return {1.0, 0.0, 0.0, -1i};
+  if (name == "t")
+    return {1.0, 0.0, 0.0, std::polar(1.0, M_PI / 4.0)};
+  if (name == "tdg")
+    return {1.0, 0.0, 0.0, std::polar(1.0, -M_PI / 4.0)};
+  if (name == "rx")
+    return {cosHalf, -1i * sinHalf, -1i * sinHalf, cosHalf};
+  if (name == "ry")
+    return {cosHalf, -sinHalf, sinHalf, cosHalf};
+  if (name == "rz")
+    return {std::polar(1.0, -angle / 2.0), 0.0, 0.0,
+            std::polar(1.0, angle / 2.0)};
+  if (name == "r1")
+    return {1.0, 0.0, 0.0, std::polar(1.0, angle)};
+  throw std::invalid_argument(fmt::format("Unknown circuit gate '{}'.", name));
+}
+
+std::vector<std::complex<double>>
+getCircuitGateDerivative(const std::string &name, double angle) {
+  using namespace std::complex_literals;
+  const double cosHalf = std::cos(angle / 2.0);
+  const double sinHalf = std::sin(angle / 2.0);
+  if (name == "rx")
+    return {-sinHalf / 2.0, -0.5i * cosHalf, -0.5i * cosHalf, -sinHalf / 2.0};
+  if (name == "ry")
+    return {-sinHalf / 2.0, -cosHalf / 2.0, cosHalf / 2.0, -sinHalf / 2.0};
+  if (name == "rz")
+    return {-0.5i * std::polar(1.0, -angle / 2.0), 0.0, 0.0,
+            0.5i * std::polar(1.0, angle / 2.0)};
+  if (name == "r1")
+    return {0.0, 0.0, 0.0, 1i * std::polar(1.0, angle)};
+  throw std::invalid_argument(
+      fmt::format("Circuit gate '{}' is not a rotation.", name));
+}
+
+double getGateAngle(const CircuitGate &gate,
+                    std::span<const double> parameters) {
+  if (!gate.parameterIndex)
+    return gate.angle;
+  return gate.angle + gate.angleScale * parameters[*gate.parameterIndex];
+}
+
+ParameterizedCircuit
+makeParameterizedCircuit(std::size_t numQubits, std::size_t numGates,
+                         const char *const *gateNames,
+                         const std::size_t *controlOffsets,
+                         const std::size_t *controls,
+                         const std::size_t *targets, const double *angles,
+                         const int64_t *parameterIndices,
+                         const double *angleScales) {
+  ParameterizedCircuit circuit;
+  circuit.numQubits = numQubits;
+  for (std::size_t gateIdx = 0; gateIdx < numGates; ++gateIdx) {
+    CircuitGate gate;
+    gate.name = gateNames[gateIdx];
+    gate.controls.assign(controls + controlOffsets[gateIdx],
+                         controls + controlOffsets[gateIdx + 1]);
+    gate.targets = {targets[gateIdx]};
+    gate.angle = angles[gateIdx];
+    if (parameterIndices[gateIdx] >= 0)
+      gate.parameterIndex = parameterIndices[gateIdx];
+    gate.angleScale = angleScales[gateIdx];
+    circuit.gates.emplace_back(std::move(gate));
+  }
+  return circuit;
+}
+
+void validateParameterizedCircuit(const ParameterizedCircuit &circuit,
+                                  std::size_t numParameters) {
+  for (std::size_t gateIdx = 0; gateIdx < circuit.gates.size(); ++gateIdx) {
+    const auto &gate = circuit.gates[gateIdx];
+    // Throws for unknown names.
+    getCircuitGateMatrix(gate.name, 0.0);
+    if (gate.targets.size() != 1)
+      throw std::invalid_argument(
+          fmt::format("Gate {} ('{}') must have a single target qubit.",
+                      gateIdx, gate.name));
+    for (const auto &qubits : {gate.controls, gate.targets})
+      for (std::size_t qubit : qubits)
+        if (qubit >= circuit.numQubits)
+          throw std::invalid_argument(fmt::format(
+              "Gate {} ('{}') acts on qubit {} of a {}-qubit circuit.",
+              gateIdx, gate.name, qubit, circuit.numQubits));
+    if (!gate.parameterIndex)
+      continue;
+    if (*gate.parameterIndex >= numParameters)
+      throw std::invalid_argument(
+          fmt::format("Gate {} ('{}') depends on parameter {}, but only {} "
+                      "parameters are given.",
+                      gateIdx, gate.name, *gate.parameterIndex,
+                      numParameters));
+    if (!isRotation(gate.name) || !gate.controls.empty())
+      throw std::invalid_argument(fmt::format(
+          "Gate {} ('{}') depends on a parameter, but only uncontrolled "
+          "rotations ('rx', 'ry', 'rz', 'r1') support the parameter-shift "
+          "rule.",
+          gateIdx, gate.name));
+  }
+}
+
+std::vector<double>
+combineParameterShifts(const ParameterizedCircuit &circuit,
+                       std::size_t numParameters,
+                       std::span<const double> plusExpVals,
+                       std::span<const double> minusExpVals) {
+  std::vector<double> gradient(numParameters, 0.0);
+  std::size_t shiftIdx = 0;
+  for (const auto &gate : circuit.gates) {
+    if (!gate.parameterIndex)
+      continue;
+    if (shiftIdx >= plusExpVals.size() || shiftIdx >= minusExpVals.size())
+      throw std::invalid_argument(
+          "Missing shifted expectation values for the parameterized gates.");
+    gradient[*gate.parameterIndex] +=
+        gate.angleScale *
+        (plusExpVals[shiftIdx] - minusExpVals[shiftIdx]) / 2.0;
+    ++shiftIdx;
+  }
+  return gradient;
+}
+
+namespace {
+using StateVector = std::vector<std::complex<double>>;
+
+// Apply the row-major single-qubit matrix `mat` on `target` (bit `target` of
+// the basis state indices), controlled by `controls`.
+void applyMatrix(StateVector &state,
+                 const std::vector<std::complex<double>> &mat,
+                 const std::vector<std::size_t> &controls, std::size_t target) {
+  std::size_t controlMask = 0;
+  for (std::size_t control : controls)
+    controlMask |= 1ull << control;
+  const std::size_t targetBit = 1ull << target;
+  for (std::size_t i = 0; i < state.size(); ++i) {
+    if ((i & targetBit) || (i & controlMask) != controlMask)
+      continue;
+    const auto amp0 = state[i];
+    const auto amp1 = state[i | targetBit];
+    state[i] = mat[0] * amp0 + mat[1] * amp1;
+    state[i | targetBit] = mat[2] * amp0 + mat[3] * amp1;
+  }
+}
+
+std::vector<std::complex<double>>
+adjointMatrix(const std::vector<std::complex<double>> &mat) {
+  return {std::conj(mat[0]), std::conj(mat[2]), std::conj(mat[1]),
+          std::conj(mat[3])};
+}
+
+// `sum_j coefficients[j] * terms[j] |state>`
+StateVector applyObservable(const StateVector &state,
+                            const std::vector<PauliString> &terms,
+                            std::span<const double> coefficients) {
+  using namespace std::complex_literals;
+  StateVector result(state.size());
+  for (std::size_t termIdx = 0; termIdx < terms.size(); ++termIdx) {
+    std::size_t flipMask = 0;
+    for (const auto &[qubit, pauli] : terms[termIdx])
+      if (pauli == PauliKind::X || pauli == PauliKind::Y)
+        flipMask |= 1ull << qubit;
+    for (std::size_t i = 0; i < state.size(); ++i) {
+      // P|i> = phase |i ^ flipMask>, with Y|0> = i|1> and Y|1> = -i|0>.
+      std::complex<double> phase = coefficients[termIdx];
+      for (const auto &[qubit, pauli] : terms[termIdx]) {
+        const bool bit = (i >> qubit) & 1;
+        if (pauli == PauliKind::Z && bit)
+          phase = -phase;
+        else if (pauli == PauliKind::Y)
+          phase *= bit ? -1i : 1i;
+      }
+      result[i ^ flipMask] += phase * state[i];
+    }
+  }
+  return result;
+}
+
+std::complex<double> innerProduct(const StateVector &bra,
+                                  const StateVector &ket) {
+  std::complex<double> result = 0.0;
+  for (std::size_t i = 0; i < bra.size(); ++i)
+    result += std::conj(bra[i]) * ket[i];
+  return result;
+}
+} // namespace
+
+ExpectationGradient
+computeAdjointGradientReference(const ParameterizedCircuit &circuit,
+                                const std::vector<PauliString> &terms,
+                                std::span<const double> coefficients,
+                                std::span<const double> parameters) {
+  if (circuit.numQubits > g_maxGradientReferenceQubits)
+    throw std::invalid_argument(fmt::format(
+        "Reference gradients are limited to {} qubits, got {}.",
+        g_maxGradientReferenceQubits, circuit.numQubits));
+  validateParameterizedCircuit(circuit, parameters.size());
+  StateVector phi(1ull << circuit.numQubits);
+  phi[0] = 1.0;
+  for (const auto &gate : circuit.gates)
+    applyMatrix(phi,
+                getCircuitGateMatrix(gate.name, getGateAngle(gate, parameters)),
+                gate.controls, gate.targets[0]);
+  StateVector lambda = applyObservable(phi, terms, coefficients);
+
+  ExpectationGradient result;
+  result.expectation = innerProduct(phi, lambda).real();
+  result.gradient.assign(parameters.size(), 0.0);
+  for (auto iter = circuit.gates.rbegin(); iter != circuit.gates.rend();
+       ++iter) {
+    const auto &gate = *iter;
+    const double angle = getGateAngle(gate, parameters);
+    const auto inverse = adjointMatrix(getCircuitGateMatrix(gate.name, angle));
+    // |phi> is the state before the gate, <lambda| the observable-weighted
+    // state propagated back to after the gate.
+    applyMatrix(phi, inverse, gate.controls, gate.targets[0]);
+    if (gate.parameterIndex) {
+      StateVector derivative = phi;
+      applyMatrix(derivative, getCircuitGateDerivative(gate.name, angle),
+                  gate.controls, gate.targets[0]);
+      result.gradient[*gate.parameterIndex] +=
+          gate.angleScale * 2.0 * innerProduct(lambda, derivative).real();
+    }
+    applyMatrix(lambda, inverse, gate.controls, gate.targets[0]);
+  }
+  return result;
+}
+
+std::optional<double> getGradientCheckTolerance() {
+  static const std::optional<double> tolerance =
+      []() -> std::optional<double> {
+    auto *envVal = std::getenv("CUDAQ_TENSORNET_GRADIENT_CHECK_TOLERANCE");
+    if (!envVal)
+      return std::nullopt;
+    char *end = nullptr;
+    const double value = std::strtod(envVal, &end);
+    if (end == envVal || *end != '\0' || !(value > 0.0))
+      throw std::runtime_error(fmt::format(
+          "Invalid CUDAQ_TENSORNET_GRADIENT_CHECK_TOLERANCE environment "
+          "variable setting. Expecting a positive tolerance, got '{}'.",
+          envVal));
+    CUDAQ_INFO("Checking gradients against the host reference (tolerance "
+               "{}).",
+               value);
+    return value;
+  }();
+  return tolerance;
+}
+} // namespace nvqir
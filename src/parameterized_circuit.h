@@ -0,0 +1,117 @@
+/****************************************************************-*- C++ -*-****
+ * Copyright (c) 2022 - 2025 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#pragma once
+
+#include "pauli_grouping.h"
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace nvqir {
+
+/// @brief Gate of a `ParameterizedCircuit`.
+struct CircuitGate {
+  // One of `h`, `x`, `y`, `z`, `s`, `t`, `sdg`, `tdg` or the rotations `rx`,
+  // `ry`, `rz` and `r1`.
+  std::string name;
+  std::vector<std::size_t> controls;
+  std::vector<std::size_t> targets;
+  // Rotation angle: `angle`, plus `angleScale * parameters[parameterIndex]`
+  // if the gate depends on a circuit parameter.
+  double angle = 0.0;
+  std::optional<std::size_t> parameterIndex;
+  double angleScale = 1.0;
+};
+
+/// @brief Circuit of single-qubit (possibly controlled) gates whose rotation
+/// angles may depend on a vector of parameters, for gradient evaluation.
+struct ParameterizedCircuit {
+  std::size_t numQubits = 0;
+  std::vector<CircuitGate> gates;
+};
+
+/// @brief Expectation value of an observable and its gradient with respect
+/// to the circuit parameters.
+struct ExpectationGradient {
+  double expectation = 0.0;
+  std::vector<double> gradient;
+};
+
+/// @brief Row-major matrix of the (uncontrolled) gate `name` with the given
+/// rotation angle (ignored for fixed gates).
+std::vector<std::complex<double>> getCircuitGateMatrix(const std::string &name,
+                                                       double angle);
+
+/// @brief Row-major derivative, with respect to the angle, of the matrix of
+/// the rotation `name` (see `getCircuitGateMatrix`).
+std::vector<std::complex<double>>
+getCircuitGateDerivative(const std::string &name, double angle);
+
+/// @brief Rotation angle of `gate` for the given circuit parameters.
+double getGateAngle(const CircuitGate &gate,
+                    std::span<const double> parameters);
+
+/// @brief Circuit of `numGates` single-target gates given as parallel arrays,
+/// as passed to the C entry points (e.g.,
+/// `formotensor_parameter_shift_gradient`): the controls of gate `g` are
+/// `controls[controlOffsets[g]]` to `controls[controlOffsets[g + 1] - 1]`, and
+/// a negative parameter index marks a fixed angle.
+ParameterizedCircuit
+makeParameterizedCircuit(std::size_t numQubits, std::size_t numGates,
+                         const char *const *gateNames,
+                         const std::size_t *controlOffsets,
+                         const std::size_t *controls,
+                         const std::size_t *targets, const double *angles,
+                         const int64_t *parameterIndices,
+                         const double *angleScales);
+
+/// @brief Check that `circuit` is valid for `numParameters` parameters: known
+/// gate names, qubits in range, and parameterized gates being uncontrolled
+/// rotations, for which the two-term parameter-shift rule is exact. Throws
+/// `std::invalid_argument` otherwise.
+void validateParameterizedCircuit(const ParameterizedCircuit &circuit,
+                                  std::size_t numParameters);
+
+/// @brief Gradient from the expectation values with the angle of each
+/// parameterized gate (in circuit order) shifted by +pi/2 (`plusExpVals`) and
+/// -pi/2 (`minusExpVals`): the sum, over the gates depending on a parameter,
+/// of `angleScale * (plus - minus) / 2`.
+std::vector<double>
+combineParameterShifts(const ParameterizedCircuit &circuit,
+                       std::size_t numParameters,
+                       std::span<const double> plusExpVals,
+                       std::span<const double> minusExpVals);
+
+/// @brief Largest circuit (number of qubits) accepted by
+/// `computeAdjointGradientReference`.
+inline constexpr std::size_t g_maxGradientReferenceQubits = 20;
+
+/// @brief Host reference of the expectation value of the observable
+/// `sum_j coefficients[j] * terms[j]` on the state prepared by `circuit` and
+/// its gradient, by adjoint differentiation on the state vector: the state and
+/// the observable-weighted state H|psi> are propagated backward through the
+/// gates once, collecting `2 Re <lambda| dU_k/dtheta |phi>` at each
+/// parameterized gate. For checking gradients on small circuits.
+ExpectationGradient
+computeAdjointGradientReference(const ParameterizedCircuit &circuit,
+                                const std::vector<PauliString> &terms,
+                                std::span<const double> coefficients,
+                                std::span<const double> parameters);
+
+/// @brief Tolerance of the check of device gradients against
+/// `computeAdjointGradientReference` (on circuits of at most
+/// `g_maxGradientReferenceQubits` qubits), or none if disabled (default).
+///
+/// `CUDAQ_TENSORNET_GRADIENT_CHECK_TOLERANCE` (positive number).
+std::optional<double> getGradientCheckTolerance();
+} // namespace nvqir
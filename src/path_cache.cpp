@@ -0,0 +1,184 @@
+/*******************************************************************************
+ * Copyright (c) 2022 - 2025 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#include "path_cache.h"
+#include "common/Logger.h"
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <unordered_map>
+
+namespace nvqir {
+namespace {
+constexpr char entryMagic[4] = {'F', 'T', 'P', 'C'};
+
+struct EntryHeader {
+  char magic[4];
+  uint32_t version;
+  uint64_t keyHi;
+  uint64_t keyLo;
+  uint64_t payloadSize;
+  uint64_t payloadChecksum;
+};
+
+uint64_t payloadChecksum(const char *data, std::size_t size) {
+  return FingerprintBuilder().addBytes(data, size).get().lo;
+}
+} // namespace
+
+Fingerprint computeTopologyKey(const NetworkTopology &topology,
+                               std::string_view queryKind) {
+  std::unordered_map<int32_t, int32_t> canonicalModes;
+  const auto canonicalMode = [&](int32_t mode) {
+    auto [iter, inserted] = canonicalModes.emplace(
+        mode, static_cast<int32_t>(canonicalModes.size()));
+    return iter->second;
+  };
+
+  FingerprintBuilder builder;
+  builder.add(queryKind).add(topology.inputModes.size());
+  for (std::size_t i = 0; i < topology.inputModes.size(); ++i) {
+    const auto &modes = topology.inputModes[i];
+    builder.add(modes.size());
+    for (const auto mode : modes)
+      builder.add(canonicalMode(mode));
+    builder.add(topology.inputExtents[i]);
+  }
+  builder.add(topology.outputModes.size());
+  for (const auto mode : topology.outputModes)
+    builder.add(canonicalMode(mode));
+  return builder.get();
+}
+
+PathCache::PathCache(std::filesystem::path directory)
+    : m_directory(std::move(directory)) {
+  std::error_code ec;
+  std::filesystem::create_directories(m_directory, ec);
+  if (ec)
+    throw std::runtime_error(
+        fmt::format("Failed to create contraction path cache directory '{}': "
+                    "{}.",
+                    m_directory.string(), ec.message()));
+}
+
+PathCache &PathCache::instance() {
+  static PathCache cache = []() {
+    if (auto *cacheDir = std::getenv("CUDAQ_TENSORNET_PATH_CACHE_DIR");
+        cacheDir && *cacheDir) {
+      CUDAQ_INFO("Using contraction path cache directory '{}'.", cacheDir);
+      return PathCache(cacheDir);
+    }
+    return PathCache();
+  }();
+  return cache;
+}
+
+std::filesystem::path PathCache::getEntryPath(const Fingerprint &key) const {
+  return m_directory /
+         fmt::format("{:016x}{:016x}.v{}.path", key.hi, key.lo, formatVersion);
+}
+
+std::vector<char> PathCache::encodeEntry(const Fingerprint &key,
+                                         const std::vector<char> &payload) {
+  EntryHeader header;
+  std::copy(std::begin(entryMagic), std::end(entryMagic), header.magic);
+  header.version = formatVersion;
+  header.keyHi = key.hi;
+  header.keyLo = key.lo;
+  header.payloadSize = payload.size();
+  header.payloadChecksum = payloadChecksum(payload.data(), payload.size());
+
+  std::vector<char> entry(sizeof(header) + payload.size());
+  std::memcpy(entry.data(), &header, sizeof(header));
+  std::copy(payload.begin(), payload.end(), entry.begin() + sizeof(header));
+  return entry;
+}
+
+std::optional<std::vector<char>>
+PathCache::decodeEntry(const Fingerprint &key, const std::vector<char> &entry) {
+  EntryHeader header;
+  if (entry.size() < sizeof(header))
+    return std::nullopt;
+  std::memcpy(&header, entry.data(), sizeof(header));
+  if (!std::equal(std::begin(entryMagic), std::end(entryMagic),
+                  header.magic) ||
+      header.version != formatVersion || header.keyHi != key.hi ||
+      header.keyLo != key.lo ||
+      header.payloadSize != entry.size() - sizeof(header))
+    return std::nullopt;
+
+  std::vector<char> payload(entry.begin() + sizeof(header), entry.end());
+  if (header.payloadChecksum != payloadChecksum(payload.data(), payload.size()))
+    return std::nullopt;
+  return payload;
+}
+
+std::optional<std::vector<char>> PathCache::load(const Fingerprint &key) {
+  if (!isEnabled())
+    return std::nullopt;
+  const auto entryPath = getEntryPath(key);
+  std::ifstream file(entryPath, std::ios::binary);
+  if (!file) {
+    std::scoped_lock lock(m_mutex);
+    ++m_stats.misses;
+    return std::nullopt;
+  }
+  const std::vector<char> entry((std::istreambuf_iterator<char>(file)),
+                                std::istreambuf_iterator<char>());
+  auto payload = decodeEntry(key, entry);
+  std::scoped_lock lock(m_mutex);
+  if (!payload) {
+    CUDAQ_INFO("Ignoring invalid contraction path cache entry '{}'.",
+               entryPath.string());
+    ++m_stats.invalid;
+    ++m_stats.misses;
+    return std::nullopt;
+  }
+  ++m_stats.hits;
+  return payload;
+}
+
+bool PathCache::store(const Fingerprint &key,
+                      const std::vector<char> &packedInfo) {
+  if (!isEnabled())
+    return false;
+  const auto entryPath = getEntryPath(key);
+  // Write to a uniquely named temporary file, then atomically rename it so
+  // that readers never observe a partially written entry.
+  auto tmpPath = entryPath;
+  tmpPath += fmt::format(".tmp{:08x}", std::random_device()());
+  const auto entry = encodeEntry(key, packedInfo);
+  {
+    std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+    if (!file.write(entry.data(), entry.size())) {
+      CUDAQ_INFO("Failed to write contraction path cache entry '{}'.",
+                 tmpPath.string());
+      std::error_code ec;
+      std::filesystem::remove(tmpPath, ec);
+      return false;
+    }
+  }
+  std::error_code ec;
+  std::filesystem::rename(tmpPath, entryPath, ec);
+  if (ec) {
+    CUDAQ_INFO("Failed to store contraction path cache entry '{}': {}.",
+               entryPath.string(), ec.message());
+    std::filesystem::remove(tmpPath, ec);
+    return false;
+  }
+  std::scoped_lock lock(m_mutex);
+  ++m_stats.stores;
+  return true;
+}
+
+PathCache::Stats PathCache::getStats() const {
+  std::scoped_lock lock(m_mutex);
+  return m_stats;
+}
+} // namespace nvqir
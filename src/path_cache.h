@@ -0,0 +1,92 @@
+/****************************************************************-*- C++ -*-****
+ * Copyright (c) 2022 - 2025 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#pragma once
+
+#include "result_memo.h"
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace nvqir {
+
+/// @brief Structure of a tensor network: modes and extents of the input
+/// tensors and the output modes (no tensor data).
+struct NetworkTopology {
+  std::vector<std::vector<int32_t>> inputModes;
+  std::vector<std::vector<int64_t>> inputExtents;
+  std::vector<int32_t> outputModes;
+};
+
+/// @brief Compute the key of a network topology for a given query kind.
+/// Modes are relabeled in order of first appearance, hence the key only
+/// depends on the connectivity and extents, not on the actual mode labels or
+/// tensor values.
+Fingerprint computeTopologyKey(const NetworkTopology &topology,
+                               std::string_view queryKind);
+
+/// @brief On-disk cache of packed contraction optimizer info (contraction
+/// path and slicing), keyed by the network topology.
+///
+/// Enabled by setting `CUDAQ_TENSORNET_PATH_CACHE_DIR` to a (writable)
+/// directory. Each entry is stored in its own file, written atomically (write
+/// to a temporary file then rename), so that concurrent processes can share
+/// the same cache directory.
+class PathCache {
+public:
+  /// Version of the on-disk entry format.
+  static constexpr uint32_t formatVersion = 1;
+
+  /// @brief Disabled cache.
+  PathCache() = default;
+  /// @brief Cache backed by the given directory (created if needed).
+  explicit PathCache(std::filesystem::path directory);
+
+  /// @brief Process-wide cache configured from the environment.
+  static PathCache &instance();
+
+  bool isEnabled() const { return !m_directory.empty(); }
+
+  /// @brief Load the packed optimizer info for a key.
+  /// Returns none if there is no (valid) entry for that key.
+  std::optional<std::vector<char>> load(const Fingerprint &key);
+
+  /// @brief Store the packed optimizer info for a key.
+  bool store(const Fingerprint &key, const std::vector<char> &packedInfo);
+
+  /// @brief Path of the file that holds the entry for a key.
+  std::filesystem::path getEntryPath(const Fingerprint &key) const;
+
+  struct Stats {
+    std::size_t hits = 0;
+    std::size_t misses = 0;
+    // Entries that exist but could not be decoded (corrupted, wrong key or
+    // format version).
+    std::size_t invalid = 0;
+    std::size_t stores = 0;
+  };
+  Stats getStats() const;
+
+  /// @brief Serialize an entry: header (magic, format version, key, payload
+  /// size and checksum) followed by the payload.
+  static std::vector<char> encodeEntry(const Fingerprint &key,
+                                       const std::vector<char> &payload);
+
+  /// @brief Deserialize an entry, validating the header against the expected
+  /// key. Returns none if the entry is invalid.
+  static std::optional<std::vector<char>>
+  decodeEntry(const Fingerprint &key, const std::vector<char> &entry);
+
+private:
+  std::filesystem::path m_directory;
+  mutable std::mutex m_mutex;
+  Stats m_stats;
+};
+} // namespace nvqir
@@ -0,0 +1,1006 @@
+/*******************************************************************************
+ * Copyright (c) 2022 - 2025 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#include "path_optimizer.h"
+#include "common/Logger.h"
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <deque>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <random>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace nvqir {
+namespace {
+/// Build a contraction tree one pairwise contraction at a time, keeping track
+/// of the modes of the live tensors and of the cost of the contractions.
+class TreeBuilder {
+public:
+  explicit TreeBuilder(const NetworkTopology &topology) {
+    if (topology.inputModes.size() != topology.inputExtents.size())
+      throw std::invalid_argument("Mismatched network modes and extents.");
+    for (std::size_t i = 0; i < topology.inputModes.size(); ++i) {
+      const auto &modes = topology.inputModes[i];
+      const auto &extents = topology.inputExtents[i];
+      if (modes.size() != extents.size())
+        throw std::invalid_argument(
+            fmt::format("Mismatched modes and extents of tensor {}.", i));
+      for (std::size_t j = 0; j < modes.size(); ++j) {
+        auto [iter, inserted] = m_extents.emplace(modes[j], extents[j]);
+        if (!inserted && iter->second != extents[j])
+          throw std::invalid_argument(fmt::format(
+              "Inconsistent extents of mode {} ({} vs. {}).", modes[j],
+              iter->second, extents[j]));
+      }
+      auto sortedModes = modes;
+      std::sort(sortedModes.begin(), sortedModes.end());
+      sortedModes.erase(std::unique(sortedModes.begin(), sortedModes.end()),
+                        sortedModes.end());
+      addTensor(std::move(sortedModes));
+    }
+    for (const auto mode : topology.outputModes)
+      ++m_modeCount[mode];
+    m_numInputs = static_cast<int32_t>(m_modes.size());
+    m_tree.peakMemory = m_liveSize;
+  }
+
+  int32_t numInputs() const { return m_numInputs; }
+  const std::vector<int32_t> &getModes(int32_t id) const { return m_modes[id]; }
+  double getSize(int32_t id) const { return m_sizes[id]; }
+  int64_t getExtent(int32_t mode) const { return m_extents.at(mode); }
+  bool isAlive(int32_t id) const {
+    return id >= 0 && id < static_cast<int32_t>(m_alive.size()) && m_alive[id];
+  }
+
+  double getModesSize(const std::vector<int32_t> &modes) const {
+    double size = 1.0;
+    for (const auto mode : modes)
+      size *= static_cast<double>(m_extents.at(mode));
+    return size;
+  }
+
+  /// Modes of the result of contracting `a` and `b`: modes that are still
+  /// needed by other tensors or by the output.
+  std::vector<int32_t> getResultModes(int32_t a, int32_t b) const {
+    const auto &modesA = m_modes[a];
+    const auto &modesB = m_modes[b];
+    std::vector<int32_t> result;
+    std::size_t i = 0, j = 0;
+    while (i < modesA.size() || j < modesB.size()) {
+      int32_t mode;
+      int32_t occurrences = 0;
+      if (j == modesB.size() || (i < modesA.size() && modesA[i] < modesB[j])) {
+        mode = modesA[i++];
+        occurrences = 1;
+      } else if (i == modesA.size() || modesB[j] < modesA[i]) {
+        mode = modesB[j++];
+        occurrences = 1;
+      } else {
+        mode = modesA[i++];
+        ++j;
+        occurrences = 2;
+      }
+      if (m_modeCount.at(mode) > occurrences)
+        result.emplace_back(mode);
+    }
+    return result;
+  }
+
+  int32_t contract(int32_t a, int32_t b) {
+    if (a == b || !isAlive(a) || !isAlive(b))
+      throw std::invalid_argument(
+          fmt::format("Invalid contraction ({}, {}).", a, b));
+    auto resultModes = getResultModes(a, b);
+    std::vector<int32_t> allModes;
+    std::set_union(m_modes[a].begin(), m_modes[a].end(), m_modes[b].begin(),
+                   m_modes[b].end(), std::back_inserter(allModes));
+    m_tree.flops += getModesSize(allModes);
+    for (const auto mode : m_modes[a])
+      --m_modeCount[mode];
+    for (const auto mode : m_modes[b])
+      --m_modeCount[mode];
+    m_alive[a] = false;
+    m_alive[b] = false;
+    const double sizeA = m_sizes[a];
+    const double sizeB = m_sizes[b];
+    const auto id = addTensor(std::move(resultModes));
+    // The operands are only released once the result has been computed.
+    m_tree.peakMemory = std::max(m_tree.peakMemory, m_liveSize);
+    m_liveSize -= sizeA + sizeB;
+    m_tree.largestIntermediate =
+        std::max(m_tree.largestIntermediate, m_sizes[id]);
+    m_tree.ssaPath.emplace_back(a, b);
+    return id;
+  }
+
+  ContractionTree getTree() const { return m_tree; }
+
+private:
+  int32_t addTensor(std::vector<int32_t> modes) {
+    for (const auto mode : modes)
+      ++m_modeCount[mode];
+    m_sizes.emplace_back(getModesSize(modes));
+    m_liveSize += m_sizes.back();
+    m_modes.emplace_back(std::move(modes));
+    m_alive.emplace_back(true);
+    return static_cast<int32_t>(m_modes.size() - 1);
+  }
+
+  std::unordered_map<int32_t, int64_t> m_extents;
+  // Number of live tensors (plus the output) that have each mode.
+  std::unordered_map<int32_t, int32_t> m_modeCount;
+  // Sorted modes, size and liveness of all tensors, indexed by SSA id.
+  std::vector<std::vector<int32_t>> m_modes;
+  std::vector<double> m_sizes;
+  std::vector<bool> m_alive;
+  int32_t m_numInputs = 0;
+  double m_liveSize = 0.0;
+  ContractionTree m_tree;
+};
+
+struct GreedyParams {
+  // Weight of the operand sizes in the cost of a contraction.
+  double alpha = 1.0;
+  // Scale of the noise added to the costs (randomized greedy).
+  double temperature = 0.0;
+  std::mt19937_64 *rng = nullptr;
+};
+
+/// Contract the given (live) tensors down to a single tensor, greedily
+/// picking the pair of tensors sharing a mode with the lowest cost
+/// `size(result) - alpha * (size(a) + size(b))`. Disconnected components are
+/// finally joined smallest first. Returns the id of the resulting tensor.
+int32_t contractGreedy(TreeBuilder &builder, const std::vector<int32_t> &ids,
+                       const GreedyParams &params) {
+  if (ids.empty())
+    throw std::invalid_argument("No tensor to contract.");
+  std::unordered_map<int32_t, std::vector<int32_t>> modeTensors;
+  for (const auto id : ids)
+    for (const auto mode : builder.getModes(id))
+      modeTensors[mode].emplace_back(id);
+
+  struct Candidate {
+    double cost;
+    int32_t a;
+    int32_t b;
+    bool operator>(const Candidate &other) const {
+      return cost > other.cost;
+    }
+  };
+  std::priority_queue<Candidate, std::vector<Candidate>, std::greater<>>
+      candidates;
+  std::extreme_value_distribution<double> gumbel;
+  const auto pushCandidates = [&](int32_t id) {
+    std::vector<int32_t> neighbors;
+    for (const auto mode : builder.getModes(id))
+      for (const auto other : modeTensors[mode])
+        if (other != id)
+          neighbors.emplace_back(other);
+    std::sort(neighbors.begin(), neighbors.end());
+    neighbors.erase(std::unique(neighbors.begin(), neighbors.end()),
+                    neighbors.end());
+    for (const auto other : neighbors) {
+      const double operandSize = builder.getSize(id) + builder.getSize(other);
+      double cost =
+          builder.getModesSize(builder.getResultModes(id, other)) -
+          params.alpha * operandSize;
+      if (params.rng && params.temperature > 0.0)
+        cost -= params.temperature * operandSize * gumbel(*params.rng);
+      candidates.push({cost, std::min(id, other), std::max(id, other)});
+    }
+  };
+  for (const auto id : ids)
+    pushCandidates(id);
+
+  std::unordered_set<int32_t> live(ids.begin(), ids.end());
+  while (!candidates.empty()) {
+    const auto [cost, a, b] = candidates.top();
+    candidates.pop();
+    // Stale candidate: one of the operands has already been contracted.
+    if (!live.count(a) || !live.count(b))
+      continue;
+    for (const auto id : {a, b}) {
+      for (const auto mode : builder.getModes(id)) {
+        auto &tensors = modeTensors[mode];
+        tensors.erase(std::find(tensors.begin(), tensors.end(), id));
+      }
+      live.erase(id);
+    }
+    const auto id = builder.contract(a, b);
+    live.insert(id);
+    for (const auto mode : builder.getModes(id))
+      modeTensors[mode].emplace_back(id);
+    pushCandidates(id);
+  }
+
+  // Outer products of the disconnected components, smallest first.
+  using SizedTensor = std::pair<double, int32_t>;
+  std::priority_queue<SizedTensor, std::vector<SizedTensor>, std::greater<>>
+      remaining;
+  for (const auto id : live)
+    remaining.emplace(builder.getSize(id), id);
+  while (remaining.size() > 1) {
+    const auto a = remaining.top().second;
+    remaining.pop();
+    const auto b = remaining.top().second;
+    remaining.pop();
+    const auto id = builder.contract(a, b);
+    remaining.emplace(builder.getSize(id), id);
+  }
+  return remaining.top().second;
+}
+
+/// Split the tensors into two balanced parts with a small cut (sum of the
+/// log2 extents of the modes shared by both parts): breadth-first growth from
+/// a peripheral tensor followed by greedy single-tensor moves.
+std::pair<std::vector<int32_t>, std::vector<int32_t>>
+bisect(const TreeBuilder &builder, const std::vector<int32_t> &ids) {
+  const std::size_t n = ids.size();
+  std::unordered_map<int32_t, std::size_t> localIndex;
+  for (std::size_t i = 0; i < n; ++i)
+    localIndex[ids[i]] = i;
+  // Modes shared by at least two of the tensors (hyperedges).
+  std::unordered_map<int32_t, std::vector<std::size_t>> modeTensors;
+  for (std::size_t i = 0; i < n; ++i)
+    for (const auto mode : builder.getModes(ids[i]))
+      modeTensors[mode].emplace_back(i);
+  std::vector<std::vector<int32_t>> tensorModes(n);
+  for (const auto &[mode, tensors] : modeTensors)
+    if (tensors.size() > 1)
+      for (const auto i : tensors)
+        tensorModes[i].emplace_back(mode);
+
+  const auto breadthFirst = [&](std::size_t start) {
+    std::vector<std::size_t> order;
+    std::vector<bool> visited(n, false);
+    for (std::size_t root = start, k = 0; order.size() < n;
+         root = k++ % n) {
+      if (visited[root])
+        continue;
+      std::deque<std::size_t> queue{root};
+      visited[root] = true;
+      while (!queue.empty()) {
+        const auto i = queue.front();
+        queue.pop_front();
+        order.emplace_back(i);
+        for (const auto mode : tensorModes[i])
+          for (const auto j : modeTensors[mode])
+            if (!visited[j]) {
+              visited[j] = true;
+              queue.emplace_back(j);
+            }
+      }
+    }
+    return order;
+  };
+
+  // The last tensor reached from an arbitrary one is a peripheral tensor.
+  const auto order = breadthFirst(breadthFirst(0).back());
+  std::vector<int> side(n, 1);
+  for (std::size_t k = 0; k < n / 2; ++k)
+    side[order[k]] = 0;
+
+  const std::size_t slack = std::max<std::size_t>(1, n / 10);
+  const std::size_t minPartSize = n / 2 > slack ? n / 2 - slack : 1;
+  std::size_t partSize[2] = {n / 2, n - n / 2};
+  const auto moveGain = [&](std::size_t i) {
+    double gain = 0.0;
+    const int from = side[i];
+    for (const auto mode : tensorModes[i]) {
+      std::size_t count[2] = {0, 0};
+      for (const auto j : modeTensors[mode])
+        ++count[side[j]];
+      const bool cutBefore = count[0] > 0 && count[1] > 0;
+      const bool cutAfter = count[from] > 1;
+      gain += (static_cast<int>(cutBefore) - static_cast<int>(cutAfter)) *
+              std::log2(static_cast<double>(builder.getExtent(mode)));
+    }
+    return gain;
+  };
+  constexpr int maxPasses = 4;
+  for (int pass = 0; pass < maxPasses; ++pass) {
+    bool improved = false;
+    std::vector<bool> locked(n, false);
+    for (;;) {
+      double bestGain = 0.0;
+      std::size_t best = n;
+      for (std::size_t i = 0; i < n; ++i) {
+        if (locked[i] || partSize[side[i]] <= minPartSize)
+          continue;
+        const double gain = moveGain(i);
+        if (gain > bestGain) {
+          bestGain = gain;
+          best = i;
+        }
+      }
+      if (best == n)
+        break;
+      --partSize[side[best]];
+      side[best] = 1 - side[best];
+      ++partSize[side[best]];
+      locked[best] = true;
+      improved = true;
+    }
+    if (!improved)
+      break;
+  }
+
+  std::pair<std::vector<int32_t>, std::vector<int32_t>> parts;
+  for (std::size_t i = 0; i < n; ++i)
+    (side[i] == 0 ? parts.first : parts.second).emplace_back(ids[i]);
+  return parts;
+}
+
+int32_t contractBisection(TreeBuilder &builder,
+                          const std::vector<int32_t> &ids,
+                          std::size_t leafSize) {
+  if (ids.size() <= std::max<std::size_t>(leafSize, 2))
+    return contractGreedy(builder, ids, GreedyParams());
+  const auto [left, right] = bisect(builder, ids);
+  const auto leftId = contractBisection(builder, left, leafSize);
+  const auto rightId = contractBisection(builder, right, leafSize);
+  return builder.contract(leftId, rightId);
+}
+
+/// Exhaustive search of the contraction tree with the lowest FLOP count, by
+/// dynamic programming over the subsets of tensors.
+void contractOptimal(TreeBuilder &builder, const NetworkTopology &topology) {
+  constexpr std::size_t maxNumTensors = 12;
+  const std::size_t n = topology.inputModes.size();
+  if (n > maxNumTensors)
+    throw std::invalid_argument(
+        fmt::format("Exhaustive contraction path search is limited to {} "
+                    "tensors, got {}.",
+                    maxNumTensors, n));
+  if (n < 2)
+    return;
+  // Total number of occurrences of each mode (including the output).
+  std::unordered_map<int32_t, int32_t> totalCount;
+  for (std::size_t i = 0; i < n; ++i)
+    for (const auto mode : builder.getModes(i))
+      ++totalCount[mode];
+  for (const auto mode : topology.outputModes)
+    ++totalCount[mode];
+
+  const std::size_t numSubsets = std::size_t(1) << n;
+  // Occurrences of the modes within each subset, then the modes of the tensor
+  // resulting from the contraction of the subset.
+  std::vector<std::vector<std::pair<int32_t, int32_t>>> subsetCounts(
+      numSubsets);
+  std::vector<std::vector<int32_t>> subsetModes(numSubsets);
+  for (std::size_t subset = 1; subset < numSubsets; ++subset) {
+    const std::size_t i = __builtin_ctzll(subset);
+    std::unordered_map<int32_t, int32_t> counts;
+    for (const auto &[mode, count] : subsetCounts[subset & (subset - 1)])
+      counts[mode] = count;
+    for (const auto mode : builder.getModes(i))
+      ++counts[mode];
+    auto &sorted = subsetCounts[subset];
+    sorted.assign(counts.begin(), counts.end());
+    std::sort(sorted.begin(), sorted.end());
+    for (const auto &[mode, count] : sorted)
+      if (count < totalCount[mode])
+        subsetModes[subset].emplace_back(mode);
+  }
+
+  std::vector<double> bestCost(numSubsets,
+                               std::numeric_limits<double>::infinity());
+  std::vector<std::size_t> bestSplit(numSubsets, 0);
+  for (std::size_t i = 0; i < n; ++i)
+    bestCost[std::size_t(1) << i] = 0.0;
+  for (std::size_t subset = 1; subset < numSubsets; ++subset) {
+    if ((subset & (subset - 1)) == 0)
+      continue;
+    // Enumerate unordered splits once: the first part holds the lowest tensor.
+    const std::size_t lowest = subset & (~subset + 1);
+    const std::size_t rest = subset ^ lowest;
+    for (std::size_t sub = rest;; sub = (sub - 1) & rest) {
+      const std::size_t first = sub | lowest;
+      const std::size_t second = subset ^ first;
+      if (second != 0) {
+        std::vector<int32_t> allModes;
+        std::set_union(subsetModes[first].begin(), subsetModes[first].end(),
+                       subsetModes[second].begin(), subsetModes[second].end(),
+                       std::back_inserter(allModes));
+        const double cost = bestCost[first] + bestCost[second] +
+                            builder.getModesSize(allModes);
+        if (cost < bestCost[subset]) {
+          bestCost[subset] = cost;
+          bestSplit[subset] = first;
+        }
+      }
+      if (sub == 0)
+        break;
+    }
+  }
+
+  const auto build = [&](auto &&self, std::size_t subset) -> int32_t {
+    if ((subset & (subset - 1)) == 0)
+      return __builtin_ctzll(subset);
+    const auto first = bestSplit[subset];
+    const auto a = self(self, first);
+    const auto b = self(self, subset ^ first);
+    return builder.contract(a, b);
+  };
+  build(build, numSubsets - 1);
+}
+
+std::vector<int32_t> allTensors(const TreeBuilder &builder) {
+  std::vector<int32_t> ids(builder.numInputs());
+  for (int32_t i = 0; i < builder.numInputs(); ++i)
+    ids[i] = i;
+  return ids;
+}
+
+bool isBetter(const ContractionTree &lhs, const ContractionTree &rhs) {
+  if (lhs.flops != rhs.flops)
+    return lhs.flops < rhs.flops;
+  return lhs.peakMemory < rhs.peakMemory;
+}
+} // namespace
+
+PathFindingBudget PathFindingConfig::getBudget(std::size_t numTensors) const {
+  if (numHyperSamples)
+    return PathFindingBudget{*numHyperSamples, std::nullopt, false};
+  // Both the time per hyper sample and the spread of the path costs grow with
+  // the size of the network: a few tens of tensors get a single sample, large
+  // networks up to `maxHyperSamples`.
+  constexpr std::size_t tensorsPerSample = 32;
+  constexpr std::size_t maxHyperSamples = 64;
+  const std::size_t numSamples = std::min(
+      std::bit_ceil((numTensors + tensorsPerSample - 1) / tensorsPerSample),
+      maxHyperSamples);
+  const double timeBudget =
+      std::clamp(2e-3 * static_cast<double>(numTensors), 0.05, 30.0);
+  return PathFindingBudget{static_cast<int32_t>(numSamples), timeBudget,
+                           true};
+}
+
+const PathFindingConfig &getDefaultPathFindingConfig() {
+  static const PathFindingConfig config = []() {
+    constexpr int32_t defaultNumHyperSamples = 8;
+    PathFindingConfig config;
+    config.numHyperSamples = defaultNumHyperSamples;
+    auto *envVal = std::getenv("CUDAQ_TENSORNET_NUM_HYPER_SAMPLES");
+    if (!envVal)
+      return config;
+    if (std::string_view(envVal) == "auto") {
+      CUDAQ_INFO("Using an adaptive number of hyper samples.");
+      config.numHyperSamples.reset();
+      return config;
+    }
+    int32_t specifiedNumHyperSamples = 0;
+    try {
+      specifiedNumHyperSamples = std::stoi(envVal);
+      if (specifiedNumHyperSamples <= 0) {
+        // for the 'catch' below to handle.
+        throw std::invalid_argument("must be a positive number");
+      }
+    } catch (...) {
+      throw std::runtime_error(
+          "Invalid CUDAQ_TENSORNET_NUM_HYPER_SAMPLES environment "
+          "variable, must be a positive integer or 'auto'.");
+    }
+    CUDAQ_INFO("Update number of hyper samples from {} to {}.",
+               defaultNumHyperSamples, specifiedNumHyperSamples);
+    config.numHyperSamples = specifiedNumHyperSamples;
+    return config;
+  }();
+  return config;
+}
+
+bool continuePathSearch(double bestFlops, double elapsedSeconds) {
+  // Sustained throughput of the contraction, in the order of magnitude of a
+  // data center GPU.
+  constexpr double flopsPerSecond = 1e13;
+  return elapsedSeconds < bestFlops / flopsPerSecond;
+}
+
+std::optional<PathOptimizerKind> parsePathOptimizerKind(std::string_view name) {
+  if (name == "greedy")
+    return PathOptimizerKind::Greedy;
+  if (name == "bisection")
+    return PathOptimizerKind::Bisection;
+  if (name == "random-greedy")
+    return PathOptimizerKind::RandomGreedy;
+  if (name == "optimal")
+    return PathOptimizerKind::Optimal;
+  return std::nullopt;
+}
+
+const std::optional<PathOptimizerOptions> &getHostPathOptimizerOptions() {
+  static const std::optional<PathOptimizerOptions> options =
+      []() -> std::optional<PathOptimizerOptions> {
+    auto *optimizerName = std::getenv("CUDAQ_TENSORNET_PATH_OPTIMIZER");
+    if (!optimizerName || std::string_view(optimizerName) == "cutensornet")
+      return std::nullopt;
+    PathOptimizerOptions options;
+    if (auto kind = parsePathOptimizerKind(optimizerName))
+      options.kind = *kind;
+    else
+      throw std::runtime_error(fmt::format(
+          "Invalid CUDAQ_TENSORNET_PATH_OPTIMIZER environment variable "
+          "setting. Expecting one of 'cutensornet', 'greedy', 'bisection', "
+          "'random-greedy' or 'optimal', got '{}'.",
+          optimizerName));
+    if (auto *timeBudget =
+            std::getenv("CUDAQ_TENSORNET_PATH_OPTIMIZER_TIME_BUDGET")) {
+      char *end = nullptr;
+      const double seconds = std::strtod(timeBudget, &end);
+      if (end == timeBudget || *end != '\0' || !(seconds > 0.0))
+        throw std::runtime_error(fmt::format(
+            "Invalid CUDAQ_TENSORNET_PATH_OPTIMIZER_TIME_BUDGET environment "
+            "variable setting. Expecting a positive number of seconds, got "
+            "'{}'.",
+            timeBudget));
+      options.timeBudgetSeconds = seconds;
+    }
+    CUDAQ_INFO("Using host contraction path optimizer '{}'.", optimizerName);
+    return options;
+  }();
+  return options;
+}
+
+std::vector<std::pair<int32_t, int32_t>> ContractionTree::toLinearPath() const {
+  // The number of inputs is implied by the SSA ids: N - 1 contractions of N
+  // tensors down to one.
+  std::vector<int32_t> live(ssaPath.size() + 1);
+  for (std::size_t i = 0; i < live.size(); ++i)
+    live[i] = static_cast<int32_t>(i);
+  int32_t nextId = static_cast<int32_t>(live.size());
+  std::vector<std::pair<int32_t, int32_t>> linearPath;
+  linearPath.reserve(ssaPath.size());
+  for (const auto &[a, b] : ssaPath) {
+    const auto posA = static_cast<int32_t>(
+        std::find(live.begin(), live.end(), a) - live.begin());
+    const auto posB = static_cast<int32_t>(
+        std::find(live.begin(), live.end(), b) - live.begin());
+    linearPath.emplace_back(posA, posB);
+    live.erase(live.begin() + std::max(posA, posB));
+    live.erase(live.begin() + std::min(posA, posB));
+    live.emplace_back(nextId++);
+  }
+  return linearPath;
+}
+
+ContractionTree optimizeContractionPath(const NetworkTopology &topology,
+                                        const PathOptimizerOptions &options) {
+  if (topology.inputModes.size() < 2)
+    return TreeBuilder(topology).getTree();
+
+  switch (options.kind) {
+  case PathOptimizerKind::Greedy: {
+    TreeBuilder builder(topology);
+    contractGreedy(builder, allTensors(builder), GreedyParams());
+    return builder.getTree();
+  }
+  case PathOptimizerKind::Bisection: {
+    TreeBuilder builder(topology);
+    contractBisection(builder, allTensors(builder), options.bisectionLeafSize);
+    return builder.getTree();
+  }
+  case PathOptimizerKind::RandomGreedy: {
+    // The first trial is the plain greedy, so that the result is never worse.
+    TreeBuilder builder(topology);
+    contractGreedy(builder, allTensors(builder), GreedyParams());
+    auto best = builder.getTree();
+    std::mt19937_64 rng(options.seed);
+    std::uniform_real_distribution<double> alphaDist(0.0, 2.0);
+    std::uniform_real_distribution<double> temperatureDist(0.0, 1.0);
+    const auto start = std::chrono::steady_clock::now();
+    const auto deadline =
+        start +
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(options.timeBudgetSeconds));
+    for (std::size_t trial = 1; trial < options.maxTrials &&
+                                std::chrono::steady_clock::now() < deadline;
+         ++trial) {
+      TreeBuilder trialBuilder(topology);
+      GreedyParams params;
+      params.alpha = alphaDist(rng);
+      params.temperature = temperatureDist(rng);
+      params.rng = &rng;
+      contractGreedy(trialBuilder, allTensors(trialBuilder), params);
+      auto tree = trialBuilder.getTree();
+      if (isBetter(tree, best))
+        best = std::move(tree);
+      const double elapsed = std::chrono::duration<double>(
+                                 std::chrono::steady_clock::now() - start)
+                                 .count();
+      if (options.stopEarly && !continuePathSearch(8.0 * best.flops, elapsed))
+        break;
+    }
+    return best;
+  }
+  case PathOptimizerKind::Optimal: {
+    TreeBuilder builder(topology);
+    contractOptimal(builder, topology);
+    return builder.getTree();
+  }
+  }
+  throw std::invalid_argument("Unknown contraction path optimizer.");
+}
+
+ContractionEstimate estimateContraction(const NetworkTopology &topology,
+                                        const PathOptimizerOptions &options,
+                                        std::size_t elementSize) {
+  const auto start = std::chrono::steady_clock::now();
+  const auto tree = optimizeContractionPath(topology, options);
+  ContractionEstimate estimate;
+  estimate.pathFindingSeconds = std::chrono::duration<double>(
+                                    std::chrono::steady_clock::now() - start)
+                                    .count();
+  // Complex multiply-add: 4 real multiplications and 4 real additions.
+  estimate.flops = 8.0 * tree.flops;
+  estimate.largestIntermediate = tree.largestIntermediate;
+  estimate.workspaceSize =
+      static_cast<int64_t>(tree.peakMemory * static_cast<double>(elementSize));
+  estimate.numSlices = 1;
+  return estimate;
+}
+
+ContractionEstimate
+combineEstimates(const std::vector<ContractionEstimate> &estimates) {
+  ContractionEstimate total;
+  if (!estimates.empty()) {
+    total.largestIntermediate = 0.0;
+    total.numSlices = 0;
+  }
+  for (const auto &estimate : estimates) {
+    total.flops += estimate.flops;
+    total.pathFindingSeconds += estimate.pathFindingSeconds;
+    total.workspaceSize = std::max(total.workspaceSize, estimate.workspaceSize);
+    total.fitsWorkspace = total.fitsWorkspace && estimate.fitsWorkspace;
+    if (total.largestIntermediate && estimate.largestIntermediate)
+      total.largestIntermediate =
+          std::max(*total.largestIntermediate, *estimate.largestIntermediate);
+    else
+      total.largestIntermediate.reset();
+    if (total.numSlices && estimate.numSlices)
+      *total.numSlices += *estimate.numSlices;
+    else
+      total.numSlices.reset();
+  }
+  return total;
+}
+
+NetworkTopology
+buildCircuitTopology(std::size_t numQubits, const std::vector<CircuitOp> &ops,
+                     const std::vector<int32_t> &projectedQubits) {
+  NetworkTopology topology;
+  const auto addTensor = [&](std::vector<int32_t> modes) {
+    topology.inputExtents.emplace_back(modes.size(), 2);
+    topology.inputModes.emplace_back(std::move(modes));
+  };
+  const auto checkQubit = [&](int32_t q) {
+    if (q < 0 || static_cast<std::size_t>(q) >= numQubits)
+      throw std::invalid_argument(fmt::format(
+          "Invalid qubit {} for a circuit of {} qubits.", q, numQubits));
+  };
+
+  // Current (open) mode of each qubit wire, starting from |0> tensors.
+  int32_t nextMode = 0;
+  std::vector<int32_t> wireModes(numQubits);
+  for (std::size_t q = 0; q < numQubits; ++q) {
+    wireModes[q] = nextMode++;
+    addTensor({wireModes[q]});
+  }
+  for (const auto &op : ops) {
+    std::vector<int32_t> inModes, outModes;
+    for (const auto q : op.qubits) {
+      checkQubit(q);
+      inModes.emplace_back(wireModes[q]);
+      outModes.emplace_back(nextMode);
+      wireModes[q] = nextMode++;
+    }
+    std::vector<int32_t> opModes = op.isAdjoint ? outModes : inModes;
+    const auto &secondHalf = op.isAdjoint ? inModes : outModes;
+    opModes.insert(opModes.end(), secondHalf.begin(), secondHalf.end());
+    addTensor(std::move(opModes));
+  }
+
+  std::vector<bool> isProjected(numQubits, false);
+  for (const auto q : projectedQubits) {
+    checkQubit(q);
+    isProjected[q] = true;
+    addTensor({wireModes[q]});
+  }
+  for (std::size_t q = 0; q < numQubits; ++q)
+    if (!isProjected[q])
+      topology.outputModes.emplace_back(wireModes[q]);
+  return topology;
+}
+
+NetworkTopology
+buildDoubleLayerTopology(const NetworkTopology &ket,
+                         const std::vector<int32_t> &openQubits,
+                         const std::vector<int32_t> &operatorQubits) {
+  const std::size_t numQubits = ket.outputModes.size();
+  int32_t maxMode = -1;
+  for (const auto &modes : ket.inputModes)
+    for (const auto mode : modes)
+      maxMode = std::max(maxMode, mode);
+  const int32_t braOffset = maxMode + 1;
+
+  enum class Wire { Traced, Open, Operator };
+  std::vector<Wire> wires(numQubits, Wire::Traced);
+  for (const auto &[qubits, kind] :
+       {std::make_pair(&openQubits, Wire::Open),
+        std::make_pair(&operatorQubits, Wire::Operator)})
+    for (const auto q : *qubits) {
+      if (q < 0 || static_cast<std::size_t>(q) >= numQubits)
+        throw std::invalid_argument(fmt::format(
+            "Invalid qubit {} for a network of {} qubits.", q, numQubits));
+      wires[q] = kind;
+    }
+
+  // Bra modes of traced qubits are the ket output modes.
+  std::unordered_map<int32_t, int32_t> braModes;
+  for (std::size_t q = 0; q < numQubits; ++q)
+    if (wires[q] == Wire::Traced)
+      braModes[ket.outputModes[q] + braOffset] = ket.outputModes[q];
+  const auto braMode = [&](int32_t ketMode) {
+    auto iter = braModes.find(ketMode + braOffset);
+    return iter == braModes.end() ? ketMode + braOffset : iter->second;
+  };
+
+  NetworkTopology topology = ket;
+  topology.outputModes.clear();
+  for (std::size_t i = 0; i < ket.inputModes.size(); ++i) {
+    std::vector<int32_t> modes;
+    for (const auto mode : ket.inputModes[i])
+      modes.emplace_back(braMode(mode));
+    topology.inputModes.emplace_back(std::move(modes));
+    topology.inputExtents.emplace_back(ket.inputExtents[i]);
+  }
+  for (std::size_t q = 0; q < numQubits; ++q) {
+    const auto ketMode = ket.outputModes[q];
+    if (wires[q] == Wire::Operator) {
+      topology.inputModes.push_back({ketMode, braMode(ketMode)});
+      topology.inputExtents.push_back({2, 2});
+    }
+  }
+  for (std::size_t q = 0; q < numQubits; ++q)
+    if (wires[q] == Wire::Open)
+      topology.outputModes.emplace_back(ket.outputModes[q]);
+  for (std::size_t q = 0; q < numQubits; ++q)
+    if (wires[q] == Wire::Open)
+      topology.outputModes.emplace_back(braMode(ket.outputModes[q]));
+  return topology;
+}
+
+NetworkTopology
+buildMpoDoubleLayerTopology(const NetworkTopology &ket, int32_t firstQubit,
+                            const std::vector<int64_t> &bondDims) {
+  const std::size_t numSites = bondDims.size() + 1;
+  std::vector<int32_t> operatorQubits(numSites);
+  std::iota(operatorQubits.begin(), operatorQubits.end(), firstQubit);
+  auto topology = buildDoubleLayerTopology(ket, {}, operatorQubits);
+
+  // The single-qubit operators (last, in increasing qubit order) become the
+  // site tensors, connected by new bond modes.
+  int32_t bondOffset = 0;
+  for (const auto &modes : topology.inputModes)
+    for (const auto mode : modes)
+      bondOffset = std::max(bondOffset, mode + 1);
+  const std::size_t firstSite = topology.inputModes.size() - numSites;
+  for (std::size_t site = 0; site < numSites; ++site) {
+    auto &modes = topology.inputModes[firstSite + site];
+    auto &extents = topology.inputExtents[firstSite + site];
+    const int32_t ketMode = modes[0];
+    const int32_t braMode = modes[1];
+    modes.clear();
+    extents.clear();
+    if (site > 0) {
+      modes.emplace_back(bondOffset + site - 1);
+      extents.emplace_back(bondDims[site - 1]);
+    }
+    modes.emplace_back(ketMode);
+    extents.emplace_back(2);
+    if (site + 1 < numSites) {
+      modes.emplace_back(bondOffset + site);
+      extents.emplace_back(bondDims[site]);
+    }
+    modes.emplace_back(braMode);
+    extents.emplace_back(2);
+  }
+  return topology;
+}
+
+ContractionTree evaluateContractionPath(
+    const NetworkTopology &topology,
+    const std::vector<std::pair<int32_t, int32_t>> &ssaPath) {
+  TreeBuilder builder(topology);
+  for (const auto &[a, b] : ssaPath)
+    builder.contract(a, b);
+  return builder.getTree();
+}
+
+std::vector<std::pair<int32_t, int32_t>>
+linearToSsaPath(int32_t numInputs,
+                const std::vector<std::pair<int32_t, int32_t>> &linearPath) {
+  std::vector<int32_t> live(numInputs);
+  for (int32_t i = 0; i < numInputs; ++i)
+    live[i] = i;
+  int32_t nextId = numInputs;
+  std::vector<std::pair<int32_t, int32_t>> ssaPath;
+  ssaPath.reserve(linearPath.size());
+  for (const auto &[posA, posB] : linearPath) {
+    const auto numLive = static_cast<int32_t>(live.size());
+    if (posA == posB || posA < 0 || posB < 0 || posA >= numLive ||
+        posB >= numLive)
+      throw std::invalid_argument(
+          fmt::format("Invalid linear contraction ({}, {}).", posA, posB));
+    ssaPath.emplace_back(live[posA], live[posB]);
+    live.erase(live.begin() + std::max(posA, posB));
+    live.erase(live.begin() + std::min(posA, posB));
+    live.emplace_back(nextId++);
+  }
+  return ssaPath;
+}
+
+std::size_t countSharedTensors(const NetworkTopology &lhs,
+                               const NetworkTopology &rhs) {
+  const std::size_t numTensors =
+      std::min(lhs.inputModes.size(), rhs.inputModes.size());
+  std::size_t numShared = 0;
+  while (numShared < numTensors &&
+         lhs.inputModes[numShared] == rhs.inputModes[numShared] &&
+         lhs.inputExtents[numShared] == rhs.inputExtents[numShared])
+    ++numShared;
+  return numShared;
+}
+
+ContractionTree
+warmStartContractionPath(const NetworkTopology &topology,
+                         const ContractionTree &previousTree,
+                         std::size_t numSharedTensors) {
+  const std::size_t numInputs = topology.inputModes.size();
+  if (numSharedTensors > numInputs)
+    throw std::invalid_argument("More shared tensors than input tensors.");
+  // Shared tensors connected to a new tensor (e.g., the last gates of the
+  // qubits that the appended gates act on) cannot be contracted as in the
+  // previous network.
+  std::unordered_set<int32_t> newModes;
+  for (std::size_t i = numSharedTensors; i < numInputs; ++i)
+    newModes.insert(topology.inputModes[i].begin(),
+                    topology.inputModes[i].end());
+  const auto previousNumInputs =
+      static_cast<int32_t>(previousTree.ssaPath.size() + 1);
+  // Previous SSA id -> new SSA id, for the kept subtrees.
+  std::unordered_map<int32_t, int32_t> keptIds;
+  for (std::size_t i = 0; i < numSharedTensors; ++i) {
+    const auto &modes = topology.inputModes[i];
+    if (std::none_of(modes.begin(), modes.end(),
+                     [&](int32_t mode) { return newModes.count(mode); }))
+      keptIds.emplace(static_cast<int32_t>(i), static_cast<int32_t>(i));
+  }
+
+  TreeBuilder builder(topology);
+  for (std::size_t k = 0; k < previousTree.ssaPath.size(); ++k) {
+    const auto &[a, b] = previousTree.ssaPath[k];
+    auto iterA = keptIds.find(a);
+    auto iterB = keptIds.find(b);
+    if (iterA == keptIds.end() || iterB == keptIds.end())
+      continue;
+    const auto id = builder.contract(iterA->second, iterB->second);
+    keptIds.erase(iterA);
+    keptIds.erase(b);
+    keptIds.emplace(previousNumInputs + static_cast<int32_t>(k), id);
+  }
+
+  // Roots of the kept subtrees, plus all other input tensors.
+  std::unordered_set<int32_t> roots;
+  for (const auto &[previousId, id] : keptIds)
+    roots.insert(id);
+  std::vector<int32_t> ids(roots.begin(), roots.end());
+  for (int32_t i = 0; i < static_cast<int32_t>(numInputs); ++i)
+    if (builder.isAlive(i) && !roots.count(i))
+      ids.emplace_back(i);
+  std::sort(ids.begin(), ids.end());
+  if (ids.size() > 1)
+    contractGreedy(builder, ids, GreedyParams());
+  return builder.getTree();
+}
+
+PathWarmStart &PathWarmStart::instance() {
+  static PathWarmStart warmStart = []() {
+    auto *envVal = std::getenv("CUDAQ_TENSORNET_PATH_WARM_START");
+    if (!envVal)
+      return PathWarmStart();
+    char *end = nullptr;
+    const double threshold = std::strtod(envVal, &end);
+    if (end == envVal || *end != '\0' || !(threshold > 0.0))
+      throw std::runtime_error(fmt::format(
+          "Invalid CUDAQ_TENSORNET_PATH_WARM_START environment variable "
+          "setting. Expecting a positive cost threshold, got '{}'.",
+          envVal));
+    CUDAQ_INFO("Using warm-started contraction path finding (cost threshold "
+               "{}).",
+               threshold);
+    return PathWarmStart(threshold);
+  }();
+  return warmStart;
+}
+
+std::optional<ContractionTree>
+PathWarmStart::seed(const NetworkTopology &topology) {
+  if (!isEnabled())
+    return std::nullopt;
+  std::optional<ContractionTree> previousTree;
+  std::size_t numShared = 0;
+  {
+    std::scoped_lock lock(m_mutex);
+    for (const auto &entry : m_entries) {
+      const auto count = countSharedTensors(entry.topology, topology);
+      if (count > numShared) {
+        numShared = count;
+        previousTree = entry.tree;
+      }
+    }
+    if (!previousTree || 2 * numShared < topology.inputModes.size()) {
+      ++m_stats.misses;
+      return std::nullopt;
+    }
+  }
+
+  auto tree = warmStartContractionPath(topology, *previousTree, numShared);
+  // Reference cost: a plain greedy path, which is cheap to find compared to
+  // the full path search.
+  PathOptimizerOptions greedyOptions;
+  greedyOptions.kind = PathOptimizerKind::Greedy;
+  const auto reference = optimizeContractionPath(topology, greedyOptions);
+  std::scoped_lock lock(m_mutex);
+  if (tree.flops > m_threshold * reference.flops) {
+    CUDAQ_INFO("Warm-started contraction path rejected ({:.3e} vs. {:.3e} "
+               "FLOPs for a greedy path).",
+               tree.flops, reference.flops);
+    ++m_stats.rejected;
+    return std::nullopt;
+  }
+  CUDAQ_INFO("Warm-started contraction path: {} of {} tensors shared, {:.3e} "
+             "FLOPs ({:.3e} for a greedy path).",
+             numShared, topology.inputModes.size(), tree.flops,
+             reference.flops);
+  ++m_stats.seeded;
+  return tree;
+}
+
+void PathWarmStart::record(const NetworkTopology &topology,
+                           const ContractionTree &tree) {
+  if (!isEnabled())
+    return;
+  std::scoped_lock lock(m_mutex);
+  auto iter = std::find_if(m_entries.begin(), m_entries.end(),
+                           [&](const Entry &entry) {
+                             return entry.topology.inputModes ==
+                                        topology.inputModes &&
+                                    entry.topology.inputExtents ==
+                                        topology.inputExtents &&
+                                    entry.topology.outputModes ==
+                                        topology.outputModes;
+                           });
+  if (iter != m_entries.end())
+    m_entries.erase(iter);
+  m_entries.push_front(Entry{topology, tree});
+  if (m_entries.size() > maxEntries)
+    m_entries.pop_back();
+}
+
+PathWarmStart::Stats PathWarmStart::getStats() const {
+  std::scoped_lock lock(m_mutex);
+  return m_stats;
+}
+} // namespace nvqir
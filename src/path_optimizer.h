@@ -0,0 +1,269 @@
+/****************************************************************-*- C++ -*-****
+ * Copyright (c) 2022 - 2025 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#pragma once
+
+#include "path_cache.h"
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace nvqir {
+
+/// @brief Host-side contraction path finding algorithms.
+enum class PathOptimizerKind {
+  // Greedy pairwise contraction minimizing the size of the result relative to
+  // the operands.
+  Greedy,
+  // Recursive bisection of the tensor hypergraph (min-cut, balanced), with
+  // greedy contraction of the leaves.
+  Bisection,
+  // Repeated randomized greedy within a time budget, keeping the best path.
+  RandomGreedy,
+  // Exhaustive search (dynamic programming over subsets); only for small
+  // networks, mostly as a reference for the heuristics.
+  Optimal
+};
+
+/// @brief Parse a `PathOptimizerKind` from its name (`greedy`, `bisection`,
+/// `random-greedy` or `optimal`).
+std::optional<PathOptimizerKind> parsePathOptimizerKind(std::string_view name);
+
+struct PathOptimizerOptions {
+  PathOptimizerKind kind = PathOptimizerKind::Greedy;
+  // Time budget of the randomized search (`RandomGreedy`).
+  double timeBudgetSeconds = 1.0;
+  // Max number of randomized trials (`RandomGreedy`).
+  std::size_t maxTrials = 1024;
+  // Seed of the randomized search, for reproducibility.
+  uint64_t seed = 0;
+  // Subnetworks with at most that many tensors are contracted greedily
+  // (`Bisection`).
+  std::size_t bisectionLeafSize = 8;
+  // Stop the randomized search (`RandomGreedy`) early, see
+  // `continuePathSearch`.
+  bool stopEarly = false;
+};
+
+/// @brief Path finding budget of a query.
+struct PathFindingBudget {
+  // Number of hyper samples of the cuTensorNet path optimizer.
+  int32_t numHyperSamples = 8;
+  // Time budget of the host randomized search, if it overrides the one of the
+  // host path optimizer options.
+  std::optional<double> timeBudgetSeconds;
+  // True if the budget was chosen adaptively, in which case the path search
+  // also stops early (see `continuePathSearch`).
+  bool adaptive = false;
+};
+
+/// @brief Path finding setting of a state: either a fixed number of hyper
+/// samples for all queries, or an adaptive budget chosen per query from the
+/// size of the network.
+struct PathFindingConfig {
+  // Fixed number of hyper samples, or none for an adaptive budget.
+  std::optional<int32_t> numHyperSamples = 8;
+
+  bool isAdaptive() const { return !numHyperSamples.has_value(); }
+
+  /// @brief Budget of a query on a network of `numTensors` tensors.
+  PathFindingBudget getBudget(std::size_t numTensors) const;
+};
+
+/// @brief Default path finding setting of new states.
+///
+/// `CUDAQ_TENSORNET_NUM_HYPER_SAMPLES` is either a positive number of hyper
+/// samples (default: 8) or `auto` for an adaptive budget.
+const PathFindingConfig &getDefaultPathFindingConfig();
+
+/// @brief Whether an adaptive path search should go on: searching is only
+/// worth it as long as it took less time than contracting the network with
+/// the best path found so far (`bestFlops` floating point operations).
+bool continuePathSearch(double bestFlops, double elapsedSeconds);
+
+/// @brief A contraction tree, i.e., a contraction path with its cost.
+struct ContractionTree {
+  // Pairwise contractions in static single assignment form: the input tensors
+  // are numbered 0..N-1 and the result of the i-th contraction is N+i.
+  std::vector<std::pair<int32_t, int32_t>> ssaPath;
+  // Number of (complex) multiply-add operations.
+  double flops = 0.0;
+  // Number of elements of the largest intermediate tensor.
+  double largestIntermediate = 0.0;
+  // Peak number of elements of all tensors alive at the same time (including
+  // the input tensors).
+  double peakMemory = 0.0;
+
+  /// @brief The path in linear format (as used by cuTensorNet): operands are
+  /// positions in the list of remaining tensors, both are removed and the
+  /// result is appended at the end of the list.
+  std::vector<std::pair<int32_t, int32_t>> toLinearPath() const;
+};
+
+/// @brief Cost estimate of a contraction (without executing it).
+struct ContractionEstimate {
+  // Number of floating point operations (8 per complex multiply-add).
+  double flops = 0.0;
+  // Number of elements of the largest intermediate tensor, if known.
+  std::optional<double> largestIntermediate;
+  // Device scratch workspace (in bytes) required by the contraction.
+  int64_t workspaceSize = 0;
+  // Number of slices of the contraction, if known.
+  std::optional<int64_t> numSlices;
+  // Time spent finding the contraction path.
+  double pathFindingSeconds = 0.0;
+  // True if the workspace fits the available scratch space.
+  bool fitsWorkspace = true;
+};
+
+/// @brief Estimate the cost of contracting a network on the host, i.e., find
+/// a contraction path without any device. The workspace size is the peak
+/// memory of the (unsliced) path for the given element size.
+ContractionEstimate estimateContraction(const NetworkTopology &topology,
+                                        const PathOptimizerOptions &options,
+                                        std::size_t elementSize);
+
+/// @brief Estimate of queries executed one after another (e.g., the reduced
+/// density matrices of an observable's term families): the FLOPs, path
+/// finding times and slices add up, while the workspace, which is reused, and
+/// the largest intermediate are the largest ones. Unknown if unknown for any
+/// query; no queries cost nothing.
+ContractionEstimate
+combineEstimates(const std::vector<ContractionEstimate> &estimates);
+
+/// @brief Qubit operands of a circuit op, i.e., the controls then the targets
+/// of a (fully expanded) gate.
+struct CircuitOp {
+  std::vector<int32_t> qubits;
+  bool isAdjoint = false;
+};
+
+/// @brief Topology of a circuit network: a |0> tensor per qubit, followed by
+/// the op tensors (modes ordered as (input modes..., output modes...), with
+/// both halves swapped for adjoint ops), followed by basis state tensors
+/// closing the projected qubits. The other qubits are the output modes (in
+/// increasing qubit order).
+NetworkTopology
+buildCircuitTopology(std::size_t numQubits, const std::vector<CircuitOp> &ops,
+                     const std::vector<int32_t> &projectedQubits);
+
+/// @brief Topology of the double-layer (bra-ket) network of a circuit
+/// network without projected qubits. The bra and ket modes of the qubits in
+/// `openQubits` are left open (e.g., for a reduced density matrix), the ones
+/// in `operatorQubits` are connected by a single-qubit operator tensor (e.g.,
+/// for an expectation value) and the others are traced out.
+NetworkTopology
+buildDoubleLayerTopology(const NetworkTopology &ket,
+                         const std::vector<int32_t> &openQubits,
+                         const std::vector<int32_t> &operatorQubits = {});
+
+/// @brief Same as `buildDoubleLayerTopology` without open qubits, with the
+/// ket and bra modes of the consecutive qubits from `firstQubit` connected by
+/// the site tensors of a matrix product operator (`bondDims` between
+/// consecutive sites) rather than by single-qubit operators. The site tensors
+/// come last, with modes (left bond, ket, right bond, bra) without the bonds
+/// at the edges, as the tensors of `MatrixProductOperator`.
+NetworkTopology
+buildMpoDoubleLayerTopology(const NetworkTopology &ket, int32_t firstQubit,
+                            const std::vector<int64_t> &bondDims);
+
+/// @brief Host path optimizer configured from the environment, or none if
+/// path finding is left to cuTensorNet (default).
+///
+/// `CUDAQ_TENSORNET_PATH_OPTIMIZER` selects the algorithm (`cutensornet`,
+/// `greedy`, `bisection`, `random-greedy` or `optimal`) and
+/// `CUDAQ_TENSORNET_PATH_OPTIMIZER_TIME_BUDGET` the time budget (in seconds)
+/// of the randomized search.
+const std::optional<PathOptimizerOptions> &getHostPathOptimizerOptions();
+
+/// @brief Find a contraction path for the network topology.
+ContractionTree optimizeContractionPath(const NetworkTopology &topology,
+                                        const PathOptimizerOptions &options);
+
+/// @brief Compute the cost of a contraction path (in SSA form).
+ContractionTree evaluateContractionPath(
+    const NetworkTopology &topology,
+    const std::vector<std::pair<int32_t, int32_t>> &ssaPath);
+
+/// @brief Convert a contraction path of a network of `numInputs` tensors from
+/// linear format (see `ContractionTree::toLinearPath`) to SSA form.
+std::vector<std::pair<int32_t, int32_t>>
+linearToSsaPath(int32_t numInputs,
+                const std::vector<std::pair<int32_t, int32_t>> &linearPath);
+
+/// @brief Number of leading input tensors (same modes and extents) that two
+/// networks have in common, e.g., a circuit network and the network of the
+/// same circuit with more gates appended.
+std::size_t countSharedTensors(const NetworkTopology &lhs,
+                               const NetworkTopology &rhs);
+
+/// @brief Contraction tree of a network seeded with the tree of a previous
+/// network sharing its first `numSharedTensors` input tensors. Subtrees of the
+/// previous tree whose leaves are shared tensors not connected to the new
+/// tensors are kept as-is; the remaining tensors are contracted greedily.
+ContractionTree
+warmStartContractionPath(const NetworkTopology &topology,
+                         const ContractionTree &previousTree,
+                         std::size_t numSharedTensors);
+
+/// @brief Recently planned networks and their contraction trees, used to
+/// warm-start path finding of similar networks, e.g., in iterative algorithms
+/// where each circuit extends the previous one by a few gates.
+///
+/// Enabled by setting `CUDAQ_TENSORNET_PATH_WARM_START` to a cost threshold:
+/// a seeded path is only used if it costs at most that many times a plain
+/// greedy path of the same network, else the full path search runs.
+class PathWarmStart {
+public:
+  /// Number of recent networks that are kept.
+  static constexpr std::size_t maxEntries = 8;
+
+  /// @brief Disabled warm start.
+  PathWarmStart() = default;
+  /// @brief Warm start with the given cost threshold.
+  explicit PathWarmStart(double threshold) : m_threshold(threshold) {}
+
+  /// @brief Process-wide warm start configured from the environment.
+  static PathWarmStart &instance();
+
+  bool isEnabled() const { return m_threshold > 0.0; }
+
+  /// @brief Seeded contraction tree of a network, from the recent network
+  /// sharing the most tensors with it (at least half of them). Returns none
+  /// if there is no such network or if the seeded path exceeds the cost
+  /// threshold.
+  std::optional<ContractionTree> seed(const NetworkTopology &topology);
+
+  /// @brief Record the contraction tree of a network.
+  void record(const NetworkTopology &topology, const ContractionTree &tree);
+
+  struct Stats {
+    std::size_t seeded = 0;
+    // Seeded paths that exceeded the cost threshold.
+    std::size_t rejected = 0;
+    // Networks without a similar recent network.
+    std::size_t misses = 0;
+  };
+  Stats getStats() const;
+
+private:
+  struct Entry {
+    NetworkTopology topology;
+    ContractionTree tree;
+  };
+  double m_threshold = 0.0;
+  mutable std::mutex m_mutex;
+  // Most recent first.
+  std::deque<Entry> m_entries;
+  Stats m_stats;
+};
+} // namespace nvqir
@@ -0,0 +1,391 @@
+/*******************************************************************************
+ * Copyright (c) 2022 - 2025 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#include "pauli_grouping.h"
+#include "common/Logger.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdlib>
+#include <map>
+#include <numeric>
+#include <stdexcept>
+
+namespace nvqir {
+
+PauliTermGrouping groupQubitWiseCommuting(const std::vector<PauliString> &terms,
+                                          std::size_t numQubits,
+                                          std::size_t maxGroupQubits) {
+  PauliTermGrouping grouping;
+  // Measured Pauli of each qubit, per family.
+  std::vector<std::vector<PauliKind>> groupBases;
+
+  std::vector<std::size_t> order(terms.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&](std::size_t lhs, std::size_t rhs) {
+                     return terms[lhs].size() > terms[rhs].size();
+                   });
+
+  for (std::size_t termIdx : order) {
+    const auto &term = terms[termIdx];
+    if (term.size() > maxGroupQubits) {
+      grouping.ungrouped.emplace_back(termIdx);
+      continue;
+    }
+    std::size_t groupIdx = 0;
+    for (; groupIdx < grouping.groups.size(); ++groupIdx) {
+      const auto &basis = groupBases[groupIdx];
+      std::size_t newQubits = 0;
+      bool compatible = true;
+      for (const auto &[qubit, pauli] : term) {
+        if (basis[qubit] == PauliKind::I)
+          ++newQubits;
+        else if (basis[qubit] != pauli) {
+          compatible = false;
+          break;
+        }
+      }
+      if (compatible &&
+          grouping.groups[groupIdx].qubits.size() + newQubits <= maxGroupQubits)
+        break;
+    }
+    if (groupIdx == grouping.groups.size()) {
+      grouping.groups.emplace_back();
+      groupBases.emplace_back(numQubits, PauliKind::I);
+    }
+    auto &group = grouping.groups[groupIdx];
+    for (const auto &[qubit, pauli] : term) {
+      if (groupBases[groupIdx][qubit] == PauliKind::I) {
+        groupBases[groupIdx][qubit] = pauli;
+        group.qubits.emplace_back(qubit);
+      }
+    }
+    group.terms.emplace_back(termIdx);
+  }
+
+  // Order the qubits of each family, then compute the masks of its products.
+  for (std::size_t groupIdx = 0; groupIdx < grouping.groups.size();
+       ++groupIdx) {
+    auto &group = grouping.groups[groupIdx];
+    std::sort(group.qubits.begin(), group.qubits.end());
+    std::vector<int32_t> bitOfQubit(numQubits, -1);
+    for (std::size_t i = 0; i < group.qubits.size(); ++i) {
+      bitOfQubit[group.qubits[i]] = i;
+      group.basis.emplace_back(groupBases[groupIdx][group.qubits[i]]);
+    }
+    for (std::size_t termIdx : group.terms) {
+      uint64_t mask = 0;
+      for (const auto &[qubit, pauli] : terms[termIdx])
+        mask |= 1ull << bitOfQubit[qubit];
+      group.termMasks.emplace_back(mask);
+    }
+  }
+  return grouping;
+}
+
+template <typename ScalarType>
+std::vector<double>
+computeBasisDistribution(std::span<const std::complex<ScalarType>> rdm,
+                         const std::vector<PauliKind> &basis) {
+  const std::size_t numQubits = basis.size();
+  const std::size_t dim = 1ull << numQubits;
+  if (rdm.size() != dim * dim)
+    throw std::invalid_argument(
+        fmt::format("Reduced density matrix of size {} does not match a basis "
+                    "of {} qubits.",
+                    rdm.size(), numQubits));
+
+  using Complex = std::complex<double>;
+  std::vector<Complex> rotated(rdm.begin(), rdm.end());
+  // Rotate the density matrix (U rho U^dagger), one qubit at a time: U maps
+  // the +1 (-1) eigenstate of the measured Pauli to |0> (|1>).
+  const double invSqrt2 = 1.0 / std::sqrt(2.0);
+  const auto applyOnAxis = [&](std::size_t bit, const Complex(&u)[2][2]) {
+    const std::size_t stride = 1ull << bit;
+    for (std::size_t idx = 0; idx < rotated.size(); ++idx) {
+      if (idx & stride)
+        continue;
+      const Complex a0 = rotated[idx];
+      const Complex a1 = rotated[idx | stride];
+      rotated[idx] = u[0][0] * a0 + u[0][1] * a1;
+      rotated[idx | stride] = u[1][0] * a0 + u[1][1] * a1;
+    }
+  };
+  for (std::size_t i = 0; i < numQubits; ++i) {
+    Complex u[2][2];
+    if (basis[i] == PauliKind::X) {
+      // Hadamard
+      u[0][0] = u[0][1] = u[1][0] = invSqrt2;
+      u[1][1] = -invSqrt2;
+    } else if (basis[i] == PauliKind::Y) {
+      // H S^dagger
+      u[0][0] = u[1][0] = invSqrt2;
+      u[0][1] = Complex(0.0, -invSqrt2);
+      u[1][1] = Complex(0.0, invSqrt2);
+    } else {
+      continue;
+    }
+    // Ket axis, then the bra axis with the complex conjugate.
+    applyOnAxis(i, u);
+    for (auto &row : u)
+      for (auto &entry : row)
+        entry = std::conj(entry);
+    applyOnAxis(numQubits + i, u);
+  }
+
+  std::vector<double> distribution(dim);
+  for (std::size_t outcome = 0; outcome < dim; ++outcome)
+    distribution[outcome] = rotated[outcome + (outcome << numQubits)].real();
+  return distribution;
+}
+
+template std::vector<double>
+computeBasisDistribution(std::span<const std::complex<float>> rdm,
+                         const std::vector<PauliKind> &basis);
+template std::vector<double>
+computeBasisDistribution(std::span<const std::complex<double>> rdm,
+                         const std::vector<PauliKind> &basis);
+
+double evaluateParity(std::span<const double> distribution, uint64_t mask) {
+  double expVal = 0.0;
+  for (std::size_t outcome = 0; outcome < distribution.size(); ++outcome)
+    expVal += (std::popcount(outcome & mask) & 1) ? -distribution[outcome]
+                                                   : distribution[outcome];
+  return expVal;
+}
+
+std::vector<double> evaluateGroup(const PauliTermGroup &group,
+                                  std::span<const double> distribution) {
+  std::vector<double> expVals;
+  expVals.reserve(group.termMasks.size());
+  for (uint64_t mask : group.termMasks)
+    expVals.emplace_back(evaluateParity(distribution, mask));
+  return expVals;
+}
+
+OutcomeCounts
+packOutcomeCounts(const std::unordered_map<std::string, std::size_t> &counts) {
+  OutcomeCounts outcomes;
+  outcomes.reserve(counts.size());
+  for (const auto &[bitString, count] : counts) {
+    if (bitString.size() > 64)
+      throw std::invalid_argument(fmt::format(
+          "Cannot pack outcomes of {} qubits (at most 64).", bitString.size()));
+    uint64_t outcome = 0;
+    for (std::size_t i = 0; i < bitString.size(); ++i)
+      if (bitString[i] == '1')
+        outcome |= uint64_t{1} << i;
+    outcomes.emplace_back(outcome, count);
+  }
+  return outcomes;
+}
+
+double estimateParity(const OutcomeCounts &outcomes, uint64_t mask) {
+  int64_t paritySum = 0;
+  std::size_t numShots = 0;
+  for (const auto &[outcome, count] : outcomes) {
+    const auto signedCount = static_cast<int64_t>(count);
+    paritySum += (std::popcount(outcome & mask) & 1) ? -signedCount
+                                                     : signedCount;
+    numShots += count;
+  }
+  return numShots == 0 ? 0.0
+                       : static_cast<double>(paritySum) /
+                             static_cast<double>(numShots);
+}
+
+std::unordered_map<std::string, std::size_t>
+marginalizeOutcomes(const OutcomeCounts &outcomes, uint64_t mask) {
+  std::unordered_map<std::string, std::size_t> counts;
+  std::string bitString;
+  for (const auto &[outcome, count] : outcomes) {
+    bitString.clear();
+    for (uint64_t bits = mask; bits != 0; bits &= bits - 1)
+      bitString.push_back((outcome >> std::countr_zero(bits)) & 1 ? '1' : '0');
+    counts[bitString] += count;
+  }
+  return counts;
+}
+
+PauliSupportGrouping groupBySupport(const std::vector<PauliString> &terms,
+                                    std::size_t maxGroupQubits) {
+  PauliSupportGrouping grouping;
+  std::map<std::vector<int32_t>, std::size_t> groupOfSupport;
+
+  std::vector<std::size_t> order(terms.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&](std::size_t lhs, std::size_t rhs) {
+                     return terms[lhs].size() > terms[rhs].size();
+                   });
+
+  for (std::size_t termIdx : order) {
+    const auto &term = terms[termIdx];
+    if (term.size() > maxGroupQubits) {
+      grouping.ungrouped.emplace_back(termIdx);
+      continue;
+    }
+    std::vector<int32_t> support;
+    support.reserve(term.size());
+    for (const auto &[qubit, pauli] : term)
+      support.emplace_back(qubit);
+    std::sort(support.begin(), support.end());
+
+    auto iter = groupOfSupport.find(support);
+    std::size_t groupIdx = grouping.groups.size();
+    if (iter != groupOfSupport.end()) {
+      groupIdx = iter->second;
+    } else {
+      for (std::size_t i = 0; i < grouping.groups.size(); ++i) {
+        const auto &qubits = grouping.groups[i].qubits;
+        if (std::includes(qubits.begin(), qubits.end(), support.begin(),
+                          support.end())) {
+          groupIdx = i;
+          break;
+        }
+      }
+      if (groupIdx == grouping.groups.size()) {
+        grouping.groups.emplace_back().qubits = support;
+        groupOfSupport.emplace(std::move(support), groupIdx);
+      }
+    }
+
+    auto &group = grouping.groups[groupIdx];
+    uint64_t flipMask = 0;
+    uint64_t phaseMask = 0;
+    uint8_t numY = 0;
+    for (const auto &[qubit, pauli] : term) {
+      const auto bit =
+          std::lower_bound(group.qubits.begin(), group.qubits.end(), qubit) -
+          group.qubits.begin();
+      if (pauli == PauliKind::X || pauli == PauliKind::Y)
+        flipMask |= 1ull << bit;
+      if (pauli == PauliKind::Y || pauli == PauliKind::Z)
+        phaseMask |= 1ull << bit;
+      if (pauli == PauliKind::Y)
+        ++numY;
+    }
+    group.terms.emplace_back(termIdx);
+    group.flipMasks.emplace_back(flipMask);
+    group.phaseMasks.emplace_back(phaseMask);
+    group.numY.emplace_back(numY);
+  }
+  return grouping;
+}
+
+template <typename ScalarType>
+std::vector<double>
+evaluateSupportGroup(const PauliSupportGroup &group,
+                     std::span<const std::complex<ScalarType>> rdm) {
+  const std::size_t numQubits = group.qubits.size();
+  const std::size_t dim = 1ull << numQubits;
+  if (rdm.size() != dim * dim)
+    throw std::invalid_argument(
+        fmt::format("Reduced density matrix of size {} does not match {} "
+                    "qubits.",
+                    rdm.size(), numQubits));
+
+  // Tr(rho P) = sum_b <b|rho P|b>, with P|b> = i^numY (-1)^|b & phaseMask|
+  // |b ^ flipMask>.
+  std::vector<double> expVals;
+  expVals.reserve(group.terms.size());
+  for (std::size_t i = 0; i < group.terms.size(); ++i) {
+    const uint64_t flipMask = group.flipMasks[i];
+    const uint64_t phaseMask = group.phaseMasks[i];
+    std::complex<double> sum = 0.0;
+    for (std::size_t ket = 0; ket < dim; ++ket) {
+      const std::complex<double> element =
+          rdm[ket + ((ket ^ flipMask) << numQubits)];
+      sum += (std::popcount(ket & phaseMask) & 1) ? -element : element;
+    }
+    // Multiply by i^numY; the expectation of a Hermitian product is real.
+    switch (group.numY[i] % 4) {
+    case 0:
+      expVals.emplace_back(sum.real());
+      break;
+    case 1:
+      expVals.emplace_back(-sum.imag());
+      break;
+    case 2:
+      expVals.emplace_back(-sum.real());
+      break;
+    default:
+      expVals.emplace_back(sum.imag());
+      break;
+    }
+  }
+  return expVals;
+}
+
+template std::vector<double>
+evaluateSupportGroup(const PauliSupportGroup &group,
+                     std::span<const std::complex<float>> rdm);
+template std::vector<double>
+evaluateSupportGroup(const PauliSupportGroup &group,
+                     std::span<const std::complex<double>> rdm);
+
+std::vector<std::size_t>
+orderForPlaceholderUpdates(const std::vector<PauliString> &terms) {
+  std::vector<std::size_t> order(terms.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&](std::size_t lhs, std::size_t rhs) {
+                     return terms[lhs] < terms[rhs];
+                   });
+  return order;
+}
+
+PauliString diffPauliStrings(const PauliString &current,
+                             const PauliString &next) {
+  PauliString updates;
+  auto currentIter = current.begin();
+  auto nextIter = next.begin();
+  while (currentIter != current.end() || nextIter != next.end()) {
+    const bool onlyCurrent =
+        nextIter == next.end() ||
+        (currentIter != current.end() && currentIter->first < nextIter->first);
+    if (onlyCurrent) {
+      updates.emplace_back(currentIter->first, PauliKind::I);
+      ++currentIter;
+    } else if (currentIter == current.end() ||
+               nextIter->first < currentIter->first) {
+      updates.emplace_back(*nextIter);
+      ++nextIter;
+    } else {
+      if (currentIter->second != nextIter->second)
+        updates.emplace_back(*nextIter);
+      ++currentIter;
+      ++nextIter;
+    }
+  }
+  return updates;
+}
+
+std::size_t getMaxGroupQubits() {
+  static const std::size_t maxQubits = []() -> std::size_t {
+    // The reduced density matrix of 10 qubits takes 16 MiB (fp64).
+    constexpr std::size_t defaultMaxQubits = 10;
+    constexpr std::size_t maxMaxQubits = 12;
+    auto *envVal = std::getenv("CUDAQ_TENSORNET_OBSERVE_GROUP_MAX_QUBITS");
+    if (!envVal)
+      return defaultMaxQubits;
+    char *end = nullptr;
+    const long value = std::strtol(envVal, &end, 10);
+    if (end == envVal || *end != '\0' || value < 1 ||
+        value > static_cast<long>(maxMaxQubits))
+      throw std::runtime_error(fmt::format(
+          "Invalid CUDAQ_TENSORNET_OBSERVE_GROUP_MAX_QUBITS environment "
+          "variable setting. Expecting an integer between 1 and {}, got '{}'.",
+          maxMaxQubits, envVal));
+    CUDAQ_INFO("Grouping observable terms on up to {} qubits.", value);
+    return value;
+  }();
+  return maxQubits;
+}
+} // namespace nvqir
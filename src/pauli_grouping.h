@@ -0,0 +1,160 @@
+/****************************************************************-*- C++ -*-****
+ * Copyright (c) 2022 - 2025 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#pragma once
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace nvqir {
+
+/// @brief Single-qubit Pauli operator.
+enum class PauliKind : uint8_t { I, X, Y, Z };
+
+/// @brief Pauli product, as its non-identity factors (qubit, Pauli).
+using PauliString = std::vector<std::pair<int32_t, PauliKind>>;
+
+/// @brief Family of qubit-wise-commuting Pauli products: on each qubit, all
+/// the products of the family act with the same Pauli (or the identity), so
+/// that they are all diagonal in a common product basis and their
+/// expectations follow from a single distribution of measurement outcomes.
+struct PauliTermGroup {
+  // Qubits acted on by the products of the family (ascending), and the Pauli
+  // measured on each of them.
+  std::vector<int32_t> qubits;
+  std::vector<PauliKind> basis;
+  // Indices of the products of the family, and for each the bit mask (bit `i`
+  // for `qubits[i]`) of the qubits it acts on.
+  std::vector<std::size_t> terms;
+  std::vector<uint64_t> termMasks;
+};
+
+/// @brief Partition of Pauli products into qubit-wise-commuting families.
+struct PauliTermGrouping {
+  std::vector<PauliTermGroup> groups;
+  // Products acting on more qubits than a family may span.
+  std::vector<std::size_t> ungrouped;
+};
+
+/// @brief Greedily partition `terms` (on `numQubits` qubits) into
+/// qubit-wise-commuting families spanning at most `maxGroupQubits` qubits
+/// each. Products are placed by decreasing weight into the first compatible
+/// family; identity products join the first family.
+PauliTermGrouping groupQubitWiseCommuting(const std::vector<PauliString> &terms,
+                                          std::size_t numQubits,
+                                          std::size_t maxGroupQubits);
+
+/// @brief Distribution of the outcomes of measuring `basis` (one Pauli per
+/// qubit) on a state with reduced density matrix `rdm`, i.e., the diagonal of
+/// the density matrix rotated into that basis.
+///
+/// `rdm` is column-major with the ket modes first (as computed by
+/// cuTensorNet marginals): element (ket, bra) at `ket + (bra << k)`, with bit
+/// `i` of the indices for qubit `i`. Outcome bit `i` is set for the -1
+/// eigenvalue of `basis[i]`.
+template <typename ScalarType>
+std::vector<double>
+computeBasisDistribution(std::span<const std::complex<ScalarType>> rdm,
+                         const std::vector<PauliKind> &basis);
+
+/// @brief Expectation of the product of the measured Paulis on the qubits of
+/// `mask` from the outcome distribution of their common basis.
+double evaluateParity(std::span<const double> distribution, uint64_t mask);
+
+/// @brief Expectations (without coefficients) of the products of `group`
+/// from the outcome distribution of its basis.
+std::vector<double> evaluateGroup(const PauliTermGroup &group,
+                                  std::span<const double> distribution);
+
+/// @brief Sampled outcomes of measuring the qubits of a family in its basis,
+/// as (outcome, count) pairs with bit `i` of the outcome for `qubits[i]`.
+using OutcomeCounts = std::vector<std::pair<uint64_t, std::size_t>>;
+
+/// @brief Pack sampled bit strings (character `i` for `qubits[i]` of a family
+/// of at most 64 qubits) into outcomes.
+OutcomeCounts
+packOutcomeCounts(const std::unordered_map<std::string, std::size_t> &counts);
+
+/// @brief Estimate of the expectation of the product of the measured Paulis
+/// on the qubits of `mask` from sampled outcomes: the mean parity of the
+/// shots (zero without shots).
+double estimateParity(const OutcomeCounts &outcomes, uint64_t mask);
+
+/// @brief Counts of the bit strings of the qubits of `mask` (by increasing
+/// bit), e.g., the measurement results of a product of a family.
+std::unordered_map<std::string, std::size_t>
+marginalizeOutcomes(const OutcomeCounts &outcomes, uint64_t mask);
+
+/// @brief Pauli products acting within a common set of qubits, evaluated from
+/// the reduced density matrix of those qubits.
+struct PauliSupportGroup {
+  // Qubits of the reduced density matrix (ascending).
+  std::vector<int32_t> qubits;
+  // Indices of the products of the group, and for each the bit masks (bit `i`
+  // for `qubits[i]`) of its X or Y factors (which flip the basis state) and
+  // of its Y or Z factors (which add a phase), and its number of Y factors.
+  std::vector<std::size_t> terms;
+  std::vector<uint64_t> flipMasks;
+  std::vector<uint64_t> phaseMasks;
+  std::vector<uint8_t> numY;
+};
+
+/// @brief Partition of Pauli products by the qubits they act on.
+struct PauliSupportGrouping {
+  std::vector<PauliSupportGroup> groups;
+  // Products acting on more qubits than a group may span.
+  std::vector<std::size_t> ungrouped;
+};
+
+/// @brief Group `terms` by support: one group per distinct set of qubits
+/// that the products act on, products being placed by decreasing weight into
+/// the first group whose qubits contain theirs (e.g., `Z0` with `X0 X1`).
+/// Products on more than `maxGroupQubits` qubits are not grouped.
+PauliSupportGrouping groupBySupport(const std::vector<PauliString> &terms,
+                                    std::size_t maxGroupQubits);
+
+/// @brief Expectations (without coefficients) of the products of `group` from
+/// the reduced density matrix of its qubits (same layout as for
+/// `computeBasisDistribution`).
+template <typename ScalarType>
+std::vector<double>
+evaluateSupportGroup(const PauliSupportGroup &group,
+                     std::span<const std::complex<ScalarType>> rdm);
+
+/// @brief Order in which to evaluate `terms` with one placeholder operator per
+/// qubit, so that consecutive products differ on few qubits: lexicographic
+/// order of their factors (sorted by qubit), which keeps products sharing
+/// leading factors next to each other.
+std::vector<std::size_t>
+orderForPlaceholderUpdates(const std::vector<PauliString> &terms);
+
+/// @brief Placeholder slots to rewrite to go from product `current` to product
+/// `next` (both with factors sorted by qubit): the factors of `next` that
+/// differ from `current`, and the identity on the qubits that only `current`
+/// acts on. Sorted by qubit.
+PauliString diffPauliStrings(const PauliString &current,
+                             const PauliString &next);
+
+/// @brief Maximum number of qubits that a family may span, i.e., the size of
+/// the reduced density matrices contracted for grouped expectations.
+///
+/// `CUDAQ_TENSORNET_OBSERVE_GROUP_MAX_QUBITS` (1-12, default 10).
+std::size_t getMaxGroupQubits();
+
+/// @brief Register of the observe results of shot-based expectation values,
+/// whose terms are sampled by qubit-wise-commuting measurement basis: its
+/// counts hold the number of bases sampled, the shots per term and the number
+/// of (non-identity) terms sampled (keys `bases`, `shots` and `terms`).
+inline constexpr const char *g_measurementBasesRegister = "__bases__";
+} // namespace nvqir
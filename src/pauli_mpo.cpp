@@ -0,0 +1,509 @@
+/*******************************************************************************
+ * Copyright (c) 2022 - 2025 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#include "pauli_mpo.h"
+#include "common/Logger.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace nvqir {
+namespace {
+using Complex = std::complex<double>;
+
+// Row-major (output, input) matrices of the Pauli operators, by `PauliKind`.
+const Complex pauliMatrices[4][4] = {{1.0, 0.0, 0.0, 1.0},
+                                     {0.0, 1.0, 1.0, 0.0},
+                                     {0.0, {0.0, -1.0}, {0.0, 1.0}, 0.0},
+                                     {1.0, 0.0, 0.0, -1.0}};
+
+// Column-major matrix.
+struct Matrix {
+  std::size_t rows = 0;
+  std::size_t cols = 0;
+  std::vector<Complex> data;
+
+  Complex &operator()(std::size_t row, std::size_t col) {
+    return data[row + rows * col];
+  }
+  const Complex &operator()(std::size_t row, std::size_t col) const {
+    return data[row + rows * col];
+  }
+};
+
+Matrix zeroMatrix(std::size_t rows, std::size_t cols) {
+  return {rows, cols, std::vector<Complex>(rows * cols)};
+}
+
+Matrix multiply(const Matrix &lhs, const Matrix &rhs) {
+  auto result = zeroMatrix(lhs.rows, rhs.cols);
+  for (std::size_t col = 0; col < rhs.cols; ++col)
+    for (std::size_t k = 0; k < lhs.cols; ++k) {
+      const Complex factor = rhs(k, col);
+      if (factor == 0.0)
+        continue;
+      for (std::size_t row = 0; row < lhs.rows; ++row)
+        result(row, col) += lhs(row, k) * factor;
+    }
+  return result;
+}
+
+Matrix adjoint(const Matrix &matrix) {
+  auto result = zeroMatrix(matrix.cols, matrix.rows);
+  for (std::size_t col = 0; col < matrix.cols; ++col)
+    for (std::size_t row = 0; row < matrix.rows; ++row)
+      result(col, row) = std::conj(matrix(row, col));
+  return result;
+}
+
+// Thin singular value decomposition `u * diag(s) * vh`, with the singular
+// values in decreasing order.
+struct Svd {
+  Matrix u;
+  std::vector<double> s;
+  Matrix vh;
+};
+
+// Rank-revealing QR decomposition `matrix = q * r` by Householder reflections
+// with column pivoting, stopping once the remaining columns have norms at most
+// `relativeCutoff` times the first pivot: `q` has orthonormal columns, as many
+// as the (numerical) rank, at least one.
+struct PivotedQr {
+  Matrix q;
+  Matrix r;
+};
+
+PivotedQr computePivotedQr(Matrix matrix, double relativeCutoff) {
+  const std::size_t m = matrix.rows;
+  const std::size_t n = matrix.cols;
+  std::vector<std::size_t> columns(n);
+  std::iota(columns.begin(), columns.end(), 0);
+  // Unit vector `v` of each reflection `1 - 2 v v^H` (empty if none).
+  std::vector<std::vector<Complex>> reflectors;
+  const auto reflect = [](const std::vector<Complex> &v, Matrix &target,
+                          std::size_t firstRow, std::size_t firstCol) {
+    for (std::size_t col = firstCol; col < target.cols; ++col) {
+      Complex dot = 0.0;
+      for (std::size_t i = 0; i < v.size(); ++i)
+        dot += std::conj(v[i]) * target(firstRow + i, col);
+      for (std::size_t i = 0; i < v.size(); ++i)
+        target(firstRow + i, col) -= 2.0 * v[i] * dot;
+    }
+  };
+
+  double firstPivotNorm = 0.0;
+  std::size_t rank = 0;
+  for (; rank < std::min(m, n); ++rank) {
+    // Pivot: the column with the largest norm below the rows done.
+    std::size_t pivot = rank;
+    double pivotNormSq = -1.0;
+    for (std::size_t col = rank; col < n; ++col) {
+      double normSq = 0.0;
+      for (std::size_t row = rank; row < m; ++row)
+        normSq += std::norm(matrix(row, col));
+      if (normSq > pivotNormSq) {
+        pivot = col;
+        pivotNormSq = normSq;
+      }
+    }
+    const double pivotNorm = std::sqrt(pivotNormSq);
+    if (rank == 0)
+      firstPivotNorm = pivotNorm;
+    if (pivotNorm == 0.0 || pivotNorm <= relativeCutoff * firstPivotNorm)
+      break;
+    if (pivot != rank) {
+      std::swap_ranges(&matrix(0, rank), &matrix(0, rank) + m,
+                       &matrix(0, pivot));
+      std::swap(columns[rank], columns[pivot]);
+    }
+    std::vector<Complex> v(&matrix(rank, rank), &matrix(0, rank) + m);
+    const Complex phase = v[0] == 0.0 ? 1.0 : v[0] / std::abs(v[0]);
+    v[0] += phase * pivotNorm;
+    double vNormSq = 0.0;
+    for (const auto &x : v)
+      vNormSq += std::norm(x);
+    for (auto &x : v)
+      x /= std::sqrt(vNormSq);
+    reflect(v, matrix, rank, rank);
+    reflectors.emplace_back(std::move(v));
+  }
+
+  // A zero matrix keeps a single (zero) column.
+  const std::size_t numCols = std::max<std::size_t>(rank, 1);
+  PivotedQr qr{zeroMatrix(m, numCols), zeroMatrix(numCols, n)};
+  for (std::size_t i = 0; i < numCols; ++i)
+    qr.q(i, i) = 1.0;
+  for (std::size_t k = rank; k-- > 0;)
+    reflect(reflectors[k], qr.q, k, 0);
+  for (std::size_t col = 0; col < n; ++col)
+    for (std::size_t row = 0; row < std::min(rank, col + 1); ++row)
+      qr.r(row, columns[col]) = matrix(row, col);
+  return qr;
+}
+
+// One-sided Jacobi: plane rotations orthogonalize the columns of the matrix,
+// whose norms are then the singular values. Tall matrices are first reduced
+// to their triangular factor.
+Svd computeSvd(const Matrix &matrix) {
+  if (matrix.rows < matrix.cols) {
+    auto svd = computeSvd(adjoint(matrix));
+    return {adjoint(svd.vh), std::move(svd.s), adjoint(svd.u)};
+  }
+  if (matrix.rows > matrix.cols) {
+    auto qr = computePivotedQr(matrix, 0.0);
+    auto svd = computeSvd(qr.r);
+    svd.u = multiply(qr.q, svd.u);
+    return svd;
+  }
+  const std::size_t n = matrix.cols;
+  Matrix work = matrix;
+  auto v = zeroMatrix(n, n);
+  for (std::size_t i = 0; i < n; ++i)
+    v(i, i) = 1.0;
+
+  const auto columnNormSq = [&](std::size_t col) {
+    double normSq = 0.0;
+    for (std::size_t row = 0; row < n; ++row)
+      normSq += std::norm(work(row, col));
+    return normSq;
+  };
+  constexpr double tolerance = 1e-14;
+  constexpr int maxSweeps = 60;
+  std::vector<double> normsSq(n);
+  for (int sweep = 0; sweep < maxSweeps; ++sweep) {
+    // Norms are updated along with the rotations, and refreshed every sweep.
+    for (std::size_t col = 0; col < n; ++col)
+      normsSq[col] = columnNormSq(col);
+    bool rotated = false;
+    for (std::size_t p = 0; p + 1 < n; ++p)
+      for (std::size_t q = p + 1; q < n; ++q) {
+        Complex *colP = &work(0, p);
+        Complex *colQ = &work(0, q);
+        const double alpha = normsSq[p];
+        const double beta = normsSq[q];
+        Complex gamma = 0.0;
+        for (std::size_t i = 0; i < n; ++i)
+          gamma += std::conj(colP[i]) * colQ[i];
+        const double absGamma = std::abs(gamma);
+        if (absGamma == 0.0 || absGamma <= tolerance * std::sqrt(alpha * beta))
+          continue;
+        rotated = true;
+        // Rotation zeroing the inner product of the two columns, after
+        // removing its phase.
+        const double zeta = (beta - alpha) / (2.0 * absGamma);
+        const double t = std::copysign(1.0, zeta) /
+                         (std::abs(zeta) + std::sqrt(1.0 + zeta * zeta));
+        const double c = 1.0 / std::sqrt(1.0 + t * t);
+        const double s = c * t;
+        const Complex phase = gamma / absGamma;
+        const auto rotate = [&](Complex *x, Complex *y) {
+          for (std::size_t i = 0; i < n; ++i) {
+            const Complex xi = x[i];
+            const Complex yi = y[i];
+            x[i] = c * xi - s * std::conj(phase) * yi;
+            y[i] = s * phase * xi + c * yi;
+          }
+        };
+        rotate(colP, colQ);
+        rotate(&v(0, p), &v(0, q));
+        normsSq[p] = std::max(alpha - t * absGamma, 0.0);
+        normsSq[q] = beta + t * absGamma;
+      }
+    if (!rotated)
+      break;
+  }
+
+  // `matrix = work * v^H` with orthogonal columns in `work`.
+  std::vector<double> norms(n);
+  for (std::size_t col = 0; col < n; ++col)
+    norms[col] = std::sqrt(columnNormSq(col));
+  std::vector<std::size_t> order(n);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&](std::size_t lhs, std::size_t rhs) {
+                     return norms[lhs] > norms[rhs];
+                   });
+  Svd svd{zeroMatrix(n, n), std::vector<double>(n), zeroMatrix(n, n)};
+  for (std::size_t k = 0; k < n; ++k) {
+    const std::size_t col = order[k];
+    svd.s[k] = norms[col];
+    if (norms[col] > 0.0)
+      for (std::size_t row = 0; row < n; ++row)
+        svd.u(row, k) = work(row, col) / norms[col];
+    for (std::size_t row = 0; row < n; ++row)
+      svd.vh(k, row) = std::conj(v(row, col));
+  }
+  return svd;
+}
+
+// Number of singular values larger than `relativeCutoff` times the largest
+// one (at least one).
+std::size_t getTruncatedRank(const std::vector<double> &s,
+                             double relativeCutoff) {
+  std::size_t rank = 1;
+  while (rank < s.size() && s[rank] > relativeCutoff * s.front())
+    ++rank;
+  return rank;
+}
+
+// Site tensor as a matrix with rows (left bond, input, output) and columns
+// (right bond).
+Matrix toLeftMatrix(const std::vector<Complex> &tensor, std::size_t leftDim,
+                    std::size_t rightDim) {
+  auto matrix = zeroMatrix(4 * leftDim, rightDim);
+  for (std::size_t out = 0; out < 2; ++out)
+    for (std::size_t r = 0; r < rightDim; ++r)
+      for (std::size_t in = 0; in < 2; ++in)
+        for (std::size_t l = 0; l < leftDim; ++l)
+          matrix(l + leftDim * (in + 2 * out), r) =
+              tensor[l + leftDim * (in + 2 * (r + rightDim * out))];
+  return matrix;
+}
+
+// Inverse of `toLeftMatrix`.
+std::vector<Complex> fromLeftMatrix(const Matrix &matrix,
+                                    std::size_t leftDim) {
+  const std::size_t rightDim = matrix.cols;
+  std::vector<Complex> tensor(matrix.data.size());
+  for (std::size_t out = 0; out < 2; ++out)
+    for (std::size_t r = 0; r < rightDim; ++r)
+      for (std::size_t in = 0; in < 2; ++in)
+        for (std::size_t l = 0; l < leftDim; ++l)
+          tensor[l + leftDim * (in + 2 * (r + rightDim * out))] =
+              matrix(l + leftDim * (in + 2 * out), r);
+  return tensor;
+}
+} // namespace
+
+int64_t MatrixProductOperator::maxBondDim() const {
+  return bondDims.empty() ? 1
+                          : *std::max_element(bondDims.begin(), bondDims.end());
+}
+
+std::vector<int64_t>
+MatrixProductOperator::getTensorExtents(std::size_t site) const {
+  const bool isFirst = site == 0;
+  const bool isLast = site + 1 == numSites();
+  if (isFirst && isLast)
+    return {2, 2};
+  if (isFirst)
+    return {2, bondDims[site], 2};
+  if (isLast)
+    return {bondDims[site - 1], 2, 2};
+  return {bondDims[site - 1], 2, bondDims[site], 2};
+}
+
+MatrixProductOperator
+buildPauliSumMpo(const std::vector<PauliString> &terms,
+                 std::span<const std::complex<double>> coefficients) {
+  if (terms.size() != coefficients.size())
+    throw std::invalid_argument(
+        fmt::format("Expecting one coefficient per Pauli product, got {} "
+                    "coefficients for {} products.",
+                    coefficients.size(), terms.size()));
+  int32_t firstQubit = std::numeric_limits<int32_t>::max();
+  int32_t lastQubit = -1;
+  for (const auto &term : terms)
+    for (const auto &[qubit, pauli] : term) {
+      firstQubit = std::min(firstQubit, qubit);
+      lastQubit = std::max(lastQubit, qubit);
+    }
+  if (lastQubit < 0)
+    throw std::invalid_argument(
+        "Cannot build the MPO of Pauli products all equal to the identity.");
+
+  const std::size_t numSites = lastQubit - firstQubit + 1;
+  const std::size_t numBonds = numSites - 1;
+  const int64_t lastSite = numSites - 1;
+  // Factor of each product on each site (`PauliKind` values), and the first
+  // and last sites it acts on.
+  std::vector<std::string> factors(
+      terms.size(), std::string(numSites, static_cast<char>(PauliKind::I)));
+  std::vector<int64_t> firstSites(terms.size(), numSites);
+  std::vector<int64_t> lastSites(terms.size(), -1);
+  for (std::size_t termIdx = 0; termIdx < terms.size(); ++termIdx)
+    for (const auto &[qubit, pauli] : terms[termIdx]) {
+      const int64_t site = qubit - firstQubit;
+      factors[termIdx][site] = static_cast<char>(pauli);
+      firstSites[termIdx] = std::min(firstSites[termIdx], site);
+      lastSites[termIdx] = std::max(lastSites[termIdx], site);
+    }
+
+  // Bond dimensions with the cut right (distinct prefixes) or left (distinct
+  // suffixes) of each bond.
+  std::vector<std::size_t> prefixDims(numBonds);
+  std::vector<std::size_t> suffixDims(numBonds);
+  for (std::size_t bond = 0; bond < numBonds; ++bond) {
+    std::unordered_set<std::string_view> prefixes;
+    std::unordered_set<std::string_view> suffixes;
+    bool anyComplete = false;
+    bool anyNotStarted = false;
+    for (std::size_t termIdx = 0; termIdx < terms.size(); ++termIdx) {
+      const std::string_view termFactors = factors[termIdx];
+      if (lastSites[termIdx] > static_cast<int64_t>(bond))
+        prefixes.insert(termFactors.substr(0, bond + 1));
+      else
+        anyComplete = true;
+      if (firstSites[termIdx] <= static_cast<int64_t>(bond))
+        suffixes.insert(termFactors.substr(bond + 1));
+      else
+        anyNotStarted = true;
+    }
+    prefixDims[bond] = prefixes.size() + anyComplete;
+    suffixDims[bond] = suffixes.size() + anyNotStarted;
+  }
+  int64_t cutSite = 0;
+  std::pair<std::size_t, std::size_t> bestCost{
+      std::numeric_limits<std::size_t>::max(), 0};
+  for (int64_t site = 0; site <= lastSite; ++site) {
+    std::pair<std::size_t, std::size_t> cost{1, 0};
+    for (int64_t bond = 0; bond < lastSite; ++bond) {
+      const std::size_t dim =
+          bond < site ? prefixDims[bond] : suffixDims[bond];
+      cost.first = std::max(cost.first, dim);
+      cost.second += dim * dim;
+    }
+    if (cost < bestCost) {
+      bestCost = cost;
+      cutSite = site;
+    }
+  }
+
+  // Identity products act (trivially) on the cut site, where their
+  // coefficient is applied.
+  for (std::size_t termIdx = 0; termIdx < terms.size(); ++termIdx)
+    if (lastSites[termIdx] < 0)
+      firstSites[termIdx] = lastSites[termIdx] = cutSite;
+
+  // Bond state of each product: its factors so far (left of the cut) or its
+  // remaining factors (right of it), or one state shared by the products
+  // complete (resp. not started) there.
+  MatrixProductOperator mpo;
+  mpo.firstQubit = firstQubit;
+  std::vector<std::vector<int64_t>> bondStates(
+      numBonds, std::vector<int64_t>(terms.size()));
+  for (int64_t bond = 0; bond < lastSite; ++bond) {
+    std::unordered_map<std::string, int64_t> states;
+    for (std::size_t termIdx = 0; termIdx < terms.size(); ++termIdx) {
+      std::string key;
+      if (bond < cutSite)
+        key = lastSites[termIdx] > bond
+                  ? "p" + factors[termIdx].substr(0, bond + 1)
+                  : "complete";
+      else
+        key = firstSites[termIdx] <= bond
+                  ? "s" + factors[termIdx].substr(bond + 1)
+                  : "not started";
+      const int64_t nextState = states.size();
+      bondStates[bond][termIdx] =
+          states.try_emplace(std::move(key), nextState).first->second;
+    }
+    mpo.bondDims.emplace_back(states.size());
+  }
+
+  for (int64_t site = 0; site <= lastSite; ++site) {
+    const std::size_t leftDim = site == 0 ? 1 : mpo.bondDims[site - 1];
+    const std::size_t rightDim = site == lastSite ? 1 : mpo.bondDims[site];
+    auto &tensor =
+        mpo.tensors.emplace_back(4 * leftDim * rightDim, Complex(0.0));
+    for (std::size_t termIdx = 0; termIdx < terms.size(); ++termIdx) {
+      const std::size_t l = site == 0 ? 0 : bondStates[site - 1][termIdx];
+      const std::size_t r = site == lastSite ? 0 : bondStates[site][termIdx];
+      const auto &matrix = pauliMatrices[static_cast<int>(
+          factors[termIdx][site])];
+      // The transition on the last site of products complete before the cut,
+      // on the first site of products starting after it, and on the cut site
+      // otherwise, is unique to the product; other transitions are shared.
+      const int64_t coefficientSite = lastSites[termIdx] < cutSite
+                                          ? lastSites[termIdx]
+                                      : firstSites[termIdx] > cutSite
+                                          ? firstSites[termIdx]
+                                          : cutSite;
+      for (std::size_t out = 0; out < 2; ++out)
+        for (std::size_t in = 0; in < 2; ++in) {
+          auto &element = tensor[l + leftDim * (in + 2 * (r + rightDim * out))];
+          if (site == coefficientSite)
+            element += coefficients[termIdx] * matrix[2 * out + in];
+          else
+            element = matrix[2 * out + in];
+        }
+    }
+  }
+  return mpo;
+}
+
+void compressMpo(MatrixProductOperator &mpo, double relativeCutoff) {
+  const std::size_t numSites = mpo.numSites();
+  const auto leftDim = [&](std::size_t site) -> std::size_t {
+    return site == 0 ? 1 : mpo.bondDims[site - 1];
+  };
+  const auto rightDim = [&](std::size_t site) -> std::size_t {
+    return site + 1 == numSites ? 1 : mpo.bondDims[site];
+  };
+  // Replace the tensor of `site` by `isometry` (rows: left bond, input and
+  // output) and push `remainder` (rows: bond) into the next site.
+  const auto splitRight = [&](std::size_t site, const Matrix &isometry,
+                              const Matrix &remainder) {
+    const std::size_t bondDim = rightDim(site);
+    mpo.tensors[site] = fromLeftMatrix(isometry, leftDim(site));
+    mpo.tensors[site + 1] =
+        multiply(remainder, Matrix{bondDim, 4 * rightDim(site + 1),
+                                   std::move(mpo.tensors[site + 1])})
+            .data;
+    mpo.bondDims[site] = isometry.cols;
+  };
+
+  // Redundant bond directions (e.g., automaton states whose continuations
+  // are linearly dependent) are removed by rank-revealing QR decompositions,
+  // left to right then right to left. The tensors right of the first site are
+  // then isometries (right-canonical form).
+  constexpr double rankCutoff = 1e-14;
+  for (std::size_t site = 0; site + 1 < numSites; ++site) {
+    auto qr = computePivotedQr(
+        toLeftMatrix(mpo.tensors[site], leftDim(site), rightDim(site)),
+        rankCutoff);
+    splitRight(site, qr.q, qr.r);
+  }
+  for (std::size_t site = numSites - 1; site > 0; --site) {
+    const std::size_t bondDim = leftDim(site);
+    auto qr = computePivotedQr(
+        adjoint(Matrix{bondDim, 4 * rightDim(site), mpo.tensors[site]}),
+        rankCutoff);
+    mpo.tensors[site] = adjoint(qr.q).data;
+    mpo.tensors[site - 1] = fromLeftMatrix(
+        multiply(toLeftMatrix(mpo.tensors[site - 1], leftDim(site - 1),
+                              bondDim),
+                 adjoint(qr.r)),
+        leftDim(site - 1));
+    mpo.bondDims[site - 1] = qr.q.cols;
+  }
+
+  // Left to right, the singular values of each bond are those of the whole
+  // operator across it, truncated relative to the largest one.
+  for (std::size_t site = 0; site + 1 < numSites; ++site) {
+    const auto svd = computeSvd(
+        toLeftMatrix(mpo.tensors[site], leftDim(site), rightDim(site)));
+    const std::size_t rank = getTruncatedRank(svd.s, relativeCutoff);
+    const Matrix u{svd.u.rows, rank,
+                   std::vector<Complex>(svd.u.data.begin(),
+                                        svd.u.data.begin() +
+                                            svd.u.rows * rank)};
+    auto remainder = zeroMatrix(rank, svd.vh.cols);
+    for (std::size_t col = 0; col < svd.vh.cols; ++col)
+      for (std::size_t row = 0; row < rank; ++row)
+        remainder(row, col) = svd.s[row] * svd.vh(row, col);
+    splitRight(site, u, remainder);
+  }
+}
+} // namespace nvqir
@@ -0,0 +1,68 @@
+/****************************************************************-*- C++ -*-****
+ * Copyright (c) 2022 - 2025 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#pragma once
+
+#include "pauli_grouping.h"
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace nvqir {
+
+/// @brief Matrix product operator (open boundaries) on consecutive qubits.
+struct MatrixProductOperator {
+  // Qubit of the first site: site `i` acts on qubit `firstQubit + i`.
+  int32_t firstQubit = 0;
+  // Bond dimension between sites `i` and `i + 1`.
+  std::vector<int64_t> bondDims;
+  // Tensor of each site, column-major with modes (left bond, input, right
+  // bond, output), i.e., element `(l, in, r, out)` at
+  // `l + Dl * (in + 2 * (r + Dr * out))`, with bond dimension 1 at the edges.
+  // The input mode is the ket mode of cuTensorNet operators.
+  std::vector<std::vector<std::complex<double>>> tensors;
+
+  std::size_t numSites() const { return tensors.size(); }
+
+  /// @brief Largest bond dimension (1 for a single site).
+  int64_t maxBondDim() const;
+
+  /// @brief Extents of the tensor of `site` as passed to cuTensorNet, without
+  /// the bond modes at the edges: (input, right bond, output) for the first
+  /// site, (left bond, input, output) for the last one.
+  std::vector<int64_t> getTensorExtents(std::size_t site) const;
+};
+
+/// @brief Default relative cutoff of `compressMpo`: only (numerically)
+/// redundant bond directions are discarded.
+inline constexpr double g_defaultMpoRelativeCutoff = 1e-13;
+
+/// @brief Exact MPO of `sum_j coefficients[j] * terms[j]` on the qubits from
+/// the first to the last one acted on by the (non-identity) products.
+///
+/// The MPO is the automaton of the products: left of a cut site, products
+/// sharing their factors so far share a bond state, as do, right of it,
+/// products sharing their remaining factors; products complete before the cut
+/// (resp. not started after it) share a single state. Each coefficient is
+/// applied once, on the transition unique to its product. The cut site
+/// minimizes the largest bond dimension. Throws `std::invalid_argument` if no
+/// product acts on a qubit.
+MatrixProductOperator
+buildPauliSumMpo(const std::vector<PauliString> &terms,
+                 std::span<const std::complex<double>> coefficients);
+
+/// @brief Compress `mpo` in place to the smallest bond dimensions: sweeps of
+/// rank-revealing QR decompositions remove the (numerically) redundant bond
+/// directions and bring it to right-canonical form, then a sweep of singular
+/// value decompositions left to right truncates each bond to the singular
+/// values larger than `relativeCutoff` times the largest one.
+void compressMpo(MatrixProductOperator &mpo,
+                 double relativeCutoff = g_defaultMpoRelativeCutoff);
+} // namespace nvqir
@@ -0,0 +1,271 @@
+/*******************************************************************************
+ * Copyright (c) 2022 - 2025 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#include "pauli_propagation.h"
+#include "common/Logger.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdlib>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+
+namespace nvqir {
+namespace {
+// Pauli product on the qubits of a state, packed as the X bits of all the
+// qubits (64 per word) followed by their Z bits: I = (0, 0), X = (1, 0),
+// Y = (1, 1) and Z = (0, 1).
+using PackedPauli = std::vector<uint64_t>;
+
+struct PackedPauliHash {
+  std::size_t operator()(const PackedPauli &pauli) const {
+    std::size_t hash = 0xcbf29ce484222325ull;
+    for (const auto word : pauli)
+      hash = (hash ^ word) * 0x100000001b3ull;
+    return hash;
+  }
+};
+
+using PauliSum = std::unordered_map<PackedPauli, double, PackedPauliHash>;
+
+// Pauli transfer matrix of a gate in the Heisenberg picture, by column:
+// column `p` lists the `(q, R(q, p))` such that U^dagger P_p U =
+// sum_q R(q, p) P_q. The Paulis of k qubits are indexed with 2 bits per qubit
+// (the `PauliKind` of each), the first qubit of the gate in the most
+// significant ones.
+using TransferColumns = std::vector<std::vector<std::pair<uint32_t, double>>>;
+
+PauliKind getKind(const PackedPauli &pauli, std::size_t numWords,
+                  int32_t qubit) {
+  const bool x = (pauli[qubit / 64] >> (qubit % 64)) & 1;
+  const bool z = (pauli[numWords + qubit / 64] >> (qubit % 64)) & 1;
+  return x ? (z ? PauliKind::Y : PauliKind::X)
+           : (z ? PauliKind::Z : PauliKind::I);
+}
+
+void setKind(PackedPauli &pauli, std::size_t numWords, int32_t qubit,
+             PauliKind kind) {
+  const uint64_t bit = uint64_t{1} << (qubit % 64);
+  const bool x = kind == PauliKind::X || kind == PauliKind::Y;
+  const bool z = kind == PauliKind::Z || kind == PauliKind::Y;
+  auto &xWord = pauli[qubit / 64];
+  auto &zWord = pauli[numWords + qubit / 64];
+  xWord = x ? (xWord | bit) : (xWord & ~bit);
+  zWord = z ? (zWord | bit) : (zWord & ~bit);
+}
+
+std::size_t getWeight(const PackedPauli &pauli, std::size_t numWords) {
+  std::size_t weight = 0;
+  for (std::size_t w = 0; w < numWords; ++w)
+    weight += std::popcount(pauli[w] | pauli[numWords + w]);
+  return weight;
+}
+
+// Element (row, col) of the k-qubit Pauli product of index `p`.
+std::complex<double> getPauliElement(uint32_t p, std::size_t k,
+                                     std::size_t row, std::size_t col) {
+  using namespace std::complex_literals;
+  std::complex<double> element = 1.0;
+  for (std::size_t m = 0; m < k; ++m) {
+    const std::size_t shift = k - 1 - m;
+    const auto kind = static_cast<PauliKind>((p >> (2 * shift)) & 3);
+    const bool r = (row >> shift) & 1;
+    const bool c = (col >> shift) & 1;
+    switch (kind) {
+    case PauliKind::I:
+      element *= r == c ? 1.0 : 0.0;
+      break;
+    case PauliKind::X:
+      element *= r != c ? 1.0 : 0.0;
+      break;
+    case PauliKind::Y:
+      element *= r == c ? 0.0i : (r ? 1.0i : -1.0i);
+      break;
+    case PauliKind::Z:
+      element *= r == c ? (r ? -1.0 : 1.0) : 0.0;
+      break;
+    }
+    if (element == 0.0)
+      break;
+  }
+  return element;
+}
+
+// Mask of the columns holding the nonzero elements of the Pauli product `p`
+// (the row index flipped on its X and Y factors).
+std::size_t getFlipMask(uint32_t p, std::size_t k) {
+  std::size_t mask = 0;
+  for (std::size_t m = 0; m < k; ++m) {
+    const std::size_t shift = k - 1 - m;
+    const auto kind = static_cast<PauliKind>((p >> (2 * shift)) & 3);
+    if (kind == PauliKind::X || kind == PauliKind::Y)
+      mask |= std::size_t{1} << shift;
+  }
+  return mask;
+}
+
+TransferColumns
+computeTransferColumns(std::span<const std::complex<double>> unitary,
+                       std::size_t k) {
+  const std::size_t dim = std::size_t{1} << k;
+  const uint32_t numPaulis = uint32_t{1} << (2 * k);
+  TransferColumns columns(numPaulis);
+  std::vector<std::complex<double>> pu(dim * dim), conjugated(dim * dim);
+  for (uint32_t p = 0; p < numPaulis; ++p) {
+    // conjugated = U^dagger P U, using the single nonzero per row of P.
+    const std::size_t pMask = getFlipMask(p, k);
+    for (std::size_t i = 0; i < dim; ++i) {
+      const auto element = getPauliElement(p, k, i, i ^ pMask);
+      for (std::size_t j = 0; j < dim; ++j)
+        pu[i * dim + j] = element * unitary[(i ^ pMask) * dim + j];
+    }
+    for (std::size_t i = 0; i < dim; ++i)
+      for (std::size_t j = 0; j < dim; ++j) {
+        std::complex<double> sum = 0.0;
+        for (std::size_t l = 0; l < dim; ++l)
+          sum += std::conj(unitary[l * dim + i]) * pu[l * dim + j];
+        conjugated[i * dim + j] = sum;
+      }
+    // R(q, p) = Tr(P_q U^dagger P_p U) / 2^k, real for unitary U.
+    for (uint32_t q = 0; q < numPaulis; ++q) {
+      const std::size_t qMask = getFlipMask(q, k);
+      std::complex<double> trace = 0.0;
+      for (std::size_t i = 0; i < dim; ++i)
+        trace += getPauliElement(q, k, i, i ^ qMask) *
+                 conjugated[(i ^ qMask) * dim + i];
+      const double value = trace.real() / static_cast<double>(dim);
+      if (std::abs(value) > 1e-12)
+        columns[p].emplace_back(q, value);
+    }
+  }
+  return columns;
+}
+
+// Non-negative (positive if integral) setting `name`, or none if unset.
+template <typename T>
+std::optional<T> getSetting(const char *name, const char *expecting) {
+  auto *envVal = std::getenv(name);
+  if (!envVal)
+    return std::nullopt;
+  char *end = nullptr;
+  const double value = std::strtod(envVal, &end);
+  if (end == envVal || *end != '\0' || !(value >= 0.0) ||
+      (std::is_integral_v<T> && (value < 1.0 || value != std::floor(value))))
+    throw std::runtime_error(
+        fmt::format("Invalid {} environment variable setting. Expecting {}, "
+                    "got '{}'.",
+                    name, expecting, envVal));
+  return static_cast<T>(value);
+}
+} // namespace
+
+const PauliPropagationSettings &getPauliPropagationSettings() {
+  static const PauliPropagationSettings settings = []() {
+    PauliPropagationSettings settings;
+    if (auto cutoff = getSetting<double>(
+            "CUDAQ_TENSORNET_PAULI_PROPAGATION_CUTOFF",
+            "a non-negative coefficient cutoff"))
+      settings.coefficientCutoff = *cutoff;
+    if (auto maxWeight = getSetting<std::size_t>(
+            "CUDAQ_TENSORNET_PAULI_PROPAGATION_MAX_WEIGHT",
+            "a positive integer"))
+      settings.maxWeight = *maxWeight;
+    return settings;
+  }();
+  return settings;
+}
+
+PauliPropagationResult
+propagatePauliSum(std::size_t numQubits, const std::vector<PauliString> &terms,
+                  std::span<const double> coefficients,
+                  const std::vector<HostGate> &gates,
+                  const PauliPropagationSettings &settings) {
+  const std::size_t numWords = (numQubits + 63) / 64;
+  PauliPropagationResult result;
+  PauliSum sum;
+  for (std::size_t termIdx = 0; termIdx < terms.size(); ++termIdx) {
+    PackedPauli pauli(2 * numWords, 0);
+    for (const auto &[qubit, kind] : terms[termIdx])
+      setKind(pauli, numWords, qubit, kind);
+    sum[pauli] += coefficients[termIdx];
+  }
+  result.maxTerms = sum.size();
+
+  // Transfer matrices of the distinct gate matrices.
+  std::unordered_map<std::string, TransferColumns> transferCache;
+  std::vector<std::pair<PackedPauli, double>> moved;
+  std::vector<PackedPauli> touched;
+  for (auto gateIt = gates.rbegin(); gateIt != gates.rend(); ++gateIt) {
+    const auto &gate = *gateIt;
+    const std::size_t k = gate.qubits.size();
+    if (k > g_maxPauliPropagationGateQubits)
+      throw std::invalid_argument(fmt::format(
+          "Pauli propagation supports gates on at most {} qubits, got {}.",
+          g_maxPauliPropagationGateQubits, k));
+    const std::string matrixKey(
+        reinterpret_cast<const char *>(gate.matrix.data()),
+        gate.matrix.size() * sizeof(std::complex<double>));
+    auto [cacheIt, inserted] = transferCache.try_emplace(matrixKey);
+    if (inserted)
+      cacheIt->second = computeTransferColumns(gate.matrix, k);
+    const auto &columns = cacheIt->second;
+
+    // Products acting on the qubits of the gate are replaced by their images;
+    // the others commute with it.
+    const auto getLocalIndex = [&](const PackedPauli &pauli) {
+      uint32_t index = 0;
+      for (const auto qubit : gate.qubits)
+        index = (index << 2) |
+                static_cast<uint32_t>(getKind(pauli, numWords, qubit));
+      return index;
+    };
+    moved.clear();
+    for (auto it = sum.begin(); it != sum.end();) {
+      if (getLocalIndex(it->first) == 0) {
+        ++it;
+        continue;
+      }
+      moved.emplace_back(it->first, it->second);
+      it = sum.erase(it);
+    }
+    touched.clear();
+    for (auto &[pauli, coefficient] : moved) {
+      for (const auto &[q, value] : columns[getLocalIndex(pauli)]) {
+        for (std::size_t m = 0; m < k; ++m)
+          setKind(pauli, numWords, gate.qubits[m],
+                  static_cast<PauliKind>((q >> (2 * (k - 1 - m))) & 3));
+        auto [it, isNew] = sum.try_emplace(pauli, 0.0);
+        it->second += coefficient * value;
+        if (isNew)
+          touched.emplace_back(pauli);
+      }
+    }
+    // Truncation of the new products (the others were kept before).
+    for (const auto &pauli : touched) {
+      auto it = sum.find(pauli);
+      if (std::abs(it->second) < settings.coefficientCutoff ||
+          getWeight(pauli, numWords) > settings.maxWeight) {
+        result.truncationError += std::abs(it->second);
+        sum.erase(it);
+      }
+    }
+    result.maxTerms = std::max(result.maxTerms, sum.size());
+  }
+
+  // On |0...0>, <P> is 1 for products of I and Z, and 0 otherwise.
+  for (const auto &[pauli, coefficient] : sum)
+    if (std::all_of(pauli.begin(), pauli.begin() + numWords,
+                    [](uint64_t word) { return word == 0; }))
+      result.expectation += coefficient;
+  result.numTerms = sum.size();
+  return result;
+}
+} // namespace nvqir
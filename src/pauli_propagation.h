@@ -0,0 +1,81 @@
+/****************************************************************-*- C++ -*-****
+ * Copyright (c) 2022 - 2025 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#pragma once
+
+#include "pauli_grouping.h"
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace nvqir {
+
+/// @brief Unitary gate copied to the host: row-major matrix on `qubits`, the
+/// first one being the most significant bit of its indices (the layout of
+/// gate tensors, with controls expanded).
+struct HostGate {
+  std::vector<int32_t> qubits;
+  std::vector<std::complex<double>> matrix;
+};
+
+/// @brief Largest gate (in qubits) supported by `propagatePauliSum`.
+inline constexpr std::size_t g_maxPauliPropagationGateQubits = 3;
+
+/// @brief Truncation of the Pauli sums of `propagatePauliSum`, applied after
+/// each gate.
+struct PauliPropagationSettings {
+  // Products whose coefficient is smaller in magnitude are dropped.
+  double coefficientCutoff = 1e-8;
+  // Products acting on more qubits are dropped.
+  std::size_t maxWeight = std::numeric_limits<std::size_t>::max();
+};
+
+/// @brief Truncation of Pauli propagation configured from the environment:
+/// `CUDAQ_TENSORNET_PAULI_PROPAGATION_CUTOFF` (coefficient cutoff) and
+/// `CUDAQ_TENSORNET_PAULI_PROPAGATION_MAX_WEIGHT` (largest weight kept).
+const PauliPropagationSettings &getPauliPropagationSettings();
+
+/// @brief Result of `propagatePauliSum`.
+struct PauliPropagationResult {
+  double expectation = 0.0;
+  // Sum of the magnitudes of the dropped coefficients: a bound on the
+  // truncation error, as each Pauli expectation is at most 1 in magnitude.
+  double truncationError = 0.0;
+  // Number of products of the final sum, and the largest along the way.
+  std::size_t numTerms = 0;
+  std::size_t maxTerms = 0;
+};
+
+/// @brief Expectation value of `sum_j coefficients[j] * terms[j]` on the state
+/// prepared by `gates` (in application order) from |0...0>, by Pauli
+/// propagation: the observable is evolved backwards through the gates in the
+/// Heisenberg picture (O -> U^dagger O U) as a sum of Pauli products,
+/// truncated per `settings` after each gate, then evaluated on |0...0>, where
+/// only the products of I and Z have a (unit) expectation. Each gate maps a
+/// product through its Pauli transfer matrix (computed once per distinct
+/// matrix): a Clifford gate maps it to a single product, a Pauli rotation to
+/// at most two, so that the cost depends on the number of non-Clifford gates
+/// in the backward light cone of the observable rather than on the
+/// entanglement of the state. Throws `std::invalid_argument` for gates on
+/// more than `g_maxPauliPropagationGateQubits` qubits.
+PauliPropagationResult
+propagatePauliSum(std::size_t numQubits, const std::vector<PauliString> &terms,
+                  std::span<const double> coefficients,
+                  const std::vector<HostGate> &gates,
+                  const PauliPropagationSettings &settings);
+
+/// @brief Register of the observe results of Pauli propagation: its
+/// expectation value is the truncation error bound, and its counts hold the
+/// number of products of the final sum and the largest one (keys `terms` and
+/// `max_terms`).
+inline constexpr const char *g_pauliPropagationRegister =
+    "__pauli_propagation__";
+} // namespace nvqir
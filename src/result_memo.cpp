@@ -0,0 +1,165 @@
+/*******************************************************************************
+ * Copyright (c) 2022 - 2025 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#include "result_memo.h"
+#include "common/Logger.h"
+#include <cstdlib>
+#include <stdexcept>
+
+namespace nvqir {
+static inline uint64_t rotl64(uint64_t x, int r) {
+  return (x << r) | (x >> (64 - r));
+}
+
+FingerprintBuilder &FingerprintBuilder::addBytes(const void *data,
+                                                 std::size_t size) {
+  const auto *bytes = static_cast<const unsigned char *>(data);
+  std::size_t i = 0;
+  // Mix lane: process 8-byte words.
+  for (; i + 8 <= size; i += 8) {
+    uint64_t word;
+    std::memcpy(&word, bytes + i, 8);
+    m_mix = rotl64(m_mix ^ (word * 0x87c37b91114253d5ull), 31) *
+            0x4cf5ad432745937full;
+  }
+  uint64_t tail = 0;
+  for (std::size_t j = i; j < size; ++j)
+    tail |= static_cast<uint64_t>(bytes[j]) << (8 * (j - i));
+  m_mix = rotl64(m_mix ^ (tail * 0x87c37b91114253d5ull), 31) *
+          0x4cf5ad432745937full;
+  // FNV-1a lane
+  for (std::size_t j = 0; j < size; ++j) {
+    m_fnv ^= bytes[j];
+    m_fnv *= 0x100000001b3ull;
+  }
+  m_length += size;
+  return *this;
+}
+
+Fingerprint FingerprintBuilder::get() const {
+  // Final avalanche (splitmix64 finalizer) of both lanes.
+  const auto fmix = [](uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebull;
+    x ^= x >> 31;
+    return x;
+  };
+  return Fingerprint{fmix(m_fnv ^ m_length), fmix(m_mix + m_length)};
+}
+
+ResultMemoCache::ResultMemoCache() {
+  if (auto *cacheSizeMb = std::getenv("CUDAQ_TENSORNET_RESULT_CACHE_SIZE_MB")) {
+    auto envIntVal = atoll(cacheSizeMb);
+    if (envIntVal < 0 || (envIntVal == 0 && std::string(cacheSizeMb) != "0"))
+      throw std::runtime_error(fmt::format(
+          "Invalid CUDAQ_TENSORNET_RESULT_CACHE_SIZE_MB environment "
+          "variable setting. Expecting a non-negative integer value, got "
+          "'{}'.",
+          cacheSizeMb));
+    m_budget = static_cast<std::size_t>(envIntVal) << 20;
+    CUDAQ_INFO("Enable result memoization with a budget of {} bytes.",
+               m_budget);
+  }
+}
+
+ResultMemoCache &ResultMemoCache::instance() {
+  static ResultMemoCache cache;
+  return cache;
+}
+
+bool ResultMemoCache::lookup(const Fingerprint &key, std::string &blob) {
+  if (!isEnabled())
+    return false;
+  std::scoped_lock lock(m_mutex);
+  auto iter = m_index.find(key);
+  if (iter == m_index.end()) {
+    ++m_stats.misses;
+    return false;
+  }
+  // Move to the front (most recently used).
+  m_entries.splice(m_entries.begin(), m_entries, iter->second);
+  blob = iter->second->second;
+  ++m_stats.hits;
+  return true;
+}
+
+void ResultMemoCache::store(const Fingerprint &key, std::string &&blob) {
+  // Results that would evict everything else are not worth caching.
+  if (blob.size() > m_budget / 2)
+    return;
+  std::scoped_lock lock(m_mutex);
+  if (auto iter = m_index.find(key); iter != m_index.end()) {
+    m_stats.sizeBytes -= iter->second->second.size();
+    m_entries.erase(iter->second);
+    m_index.erase(iter);
+  }
+  m_stats.sizeBytes += blob.size();
+  m_entries.emplace_front(key, std::move(blob));
+  m_index[key] = m_entries.begin();
+  while (m_stats.sizeBytes > m_budget && !m_entries.empty()) {
+    auto &lru = m_entries.back();
+    m_stats.sizeBytes -= lru.second.size();
+    m_index.erase(lru.first);
+    m_entries.pop_back();
+    ++m_stats.evictions;
+  }
+  m_stats.numEntries = m_entries.size();
+}
+
+std::optional<std::unordered_map<std::string, std::size_t>>
+ResultMemoCache::findCounts(const Fingerprint &key) {
+  std::string blob;
+  if (!lookup(key, blob))
+    return std::nullopt;
+  // Layout: [bitstring length, bitstring bytes, count]...
+  std::unordered_map<std::string, std::size_t> counts;
+  std::size_t pos = 0;
+  while (pos < blob.size()) {
+    uint64_t length = 0, count = 0;
+    std::memcpy(&length, blob.data() + pos, sizeof(length));
+    pos += sizeof(length);
+    std::string bitString = blob.substr(pos, length);
+    pos += length;
+    std::memcpy(&count, blob.data() + pos, sizeof(count));
+    pos += sizeof(count);
+    counts.emplace(std::move(bitString), count);
+  }
+  return counts;
+}
+
+void ResultMemoCache::insertCounts(
+    const Fingerprint &key,
+    const std::unordered_map<std::string, std::size_t> &counts) {
+  if (!isEnabled())
+    return;
+  std::string blob;
+  for (const auto &[bitString, count] : counts) {
+    const uint64_t length = bitString.size();
+    const uint64_t count64 = count;
+    blob.append(reinterpret_cast<const char *>(&length), sizeof(length));
+    blob.append(bitString);
+    blob.append(reinterpret_cast<const char *>(&count64), sizeof(count64));
+  }
+  store(key, std::move(blob));
+}
+
+void ResultMemoCache::clear() {
+  std::scoped_lock lock(m_mutex);
+  m_entries.clear();
+  m_index.clear();
+  m_stats.numEntries = 0;
+  m_stats.sizeBytes = 0;
+}
+
+ResultMemoCache::Stats ResultMemoCache::getStats() const {
+  std::scoped_lock lock(m_mutex);
+  return m_stats;
+}
+} // namespace nvqir
@@ -0,0 +1,145 @@
+/****************************************************************-*- C++ -*-****
+ * Copyright (c) 2022 - 2025 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace nvqir {
+
+/// @brief 128-bit fingerprint of a tensor network and/or a query on it.
+struct Fingerprint {
+  uint64_t hi = 0;
+  uint64_t lo = 0;
+  bool operator==(const Fingerprint &other) const {
+    return hi == other.hi && lo == other.lo;
+  }
+  bool operator!=(const Fingerprint &other) const { return !(*this == other); }
+};
+
+struct FingerprintHash {
+  std::size_t operator()(const Fingerprint &fp) const {
+    return fp.lo ^ (fp.hi * 0x9e3779b97f4a7c15ull);
+  }
+};
+
+/// @brief Incrementally build a `Fingerprint` from raw bytes.
+/// Two independent 64-bit lanes (FNV-1a and a multiply-rotate mix) are
+/// combined so that accidental collisions are practically impossible.
+class FingerprintBuilder {
+public:
+  FingerprintBuilder &addBytes(const void *data, std::size_t size);
+
+  template <typename T>
+  std::enable_if_t<std::is_trivially_copyable_v<T>, FingerprintBuilder &>
+  add(const T &value) {
+    return addBytes(&value, sizeof(T));
+  }
+
+  template <typename T>
+  FingerprintBuilder &add(const std::vector<T> &values) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    add(values.size());
+    return addBytes(values.data(), values.size() * sizeof(T));
+  }
+
+  FingerprintBuilder &add(std::string_view str) {
+    add(str.size());
+    return addBytes(str.data(), str.size());
+  }
+
+  FingerprintBuilder &add(const Fingerprint &fp) {
+    add(fp.hi);
+    return add(fp.lo);
+  }
+
+  Fingerprint get() const;
+
+private:
+  uint64_t m_fnv = 0xcbf29ce484222325ull;
+  uint64_t m_mix = 0x243f6a8885a308d3ull;
+  uint64_t m_length = 0;
+};
+
+/// @brief Process-wide memoization of exact (deterministic) results, e.g.,
+/// expectation values, reduced density matrices or state vectors, keyed by
+/// the fingerprint of the network and the query.
+///
+/// Disabled unless `CUDAQ_TENSORNET_RESULT_CACHE_SIZE_MB` is set, in which
+/// case the least recently used entries are evicted to stay within that
+/// memory budget.
+class ResultMemoCache {
+public:
+  static ResultMemoCache &instance();
+
+  bool isEnabled() const { return m_budget > 0; }
+
+  /// @brief Look up a cached array of (trivially copyable) values.
+  template <typename T>
+  std::optional<std::vector<T>> find(const Fingerprint &key) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    std::string blob;
+    if (!lookup(key, blob) || blob.size() % sizeof(T) != 0)
+      return std::nullopt;
+    std::vector<T> values(blob.size() / sizeof(T));
+    std::memcpy(values.data(), blob.data(), blob.size());
+    return values;
+  }
+
+  /// @brief Store an array of (trivially copyable) values.
+  template <typename T>
+  void insert(const Fingerprint &key, const std::vector<T> &values) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    if (!isEnabled())
+      return;
+    store(key, std::string(reinterpret_cast<const char *>(values.data()),
+                           values.size() * sizeof(T)));
+  }
+
+  /// @brief Look up / store measurement counts.
+  std::optional<std::unordered_map<std::string, std::size_t>>
+  findCounts(const Fingerprint &key);
+  void insertCounts(const Fingerprint &key,
+                    const std::unordered_map<std::string, std::size_t> &counts);
+
+  /// @brief Drop all entries.
+  void clear();
+
+  struct Stats {
+    std::size_t hits = 0;
+    std::size_t misses = 0;
+    std::size_t evictions = 0;
+    std::size_t numEntries = 0;
+    std::size_t sizeBytes = 0;
+  };
+  Stats getStats() const;
+
+private:
+  ResultMemoCache();
+  bool lookup(const Fingerprint &key, std::string &blob);
+  void store(const Fingerprint &key, std::string &&blob);
+
+  using Entry = std::pair<Fingerprint, std::string>;
+  mutable std::mutex m_mutex;
+  // Most recently used entries at the front.
+  std::list<Entry> m_entries;
+  std::unordered_map<Fingerprint, std::list<Entry>::iterator, FingerprintHash>
+      m_index;
+  std::size_t m_budget = 0;
+  Stats m_stats;
+};
+} // namespace nvqir
@@ -0,0 +1,151 @@
+/*******************************************************************************
+ * Copyright (c) 2022 - 2025 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#include "sample_counts.h"
+#include "common/Logger.h"
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+namespace nvqir {
+namespace {
+constexpr std::size_t minSlots = 16;
+} // namespace
+
+PackedSampleCounts::PackedSampleCounts(std::size_t numBits)
+    : m_numBits(numBits), m_numWords((numBits + 63) / 64),
+      m_slots(minSlots, 0), m_packed(m_numWords, 0) {}
+
+std::size_t
+PackedSampleCounts::hashKey(std::span<const uint64_t> key) const {
+  // SplitMix64 finalizer of each word, chained.
+  uint64_t hash = 0x9e3779b97f4a7c15ull;
+  for (uint64_t word : key) {
+    hash ^= word + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+    hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ull;
+    hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebull;
+    hash ^= hash >> 31;
+  }
+  return static_cast<std::size_t>(hash);
+}
+
+void PackedSampleCounts::growSlots() {
+  std::vector<std::size_t> slots(2 * m_slots.size(), 0);
+  const std::size_t mask = slots.size() - 1;
+  for (std::size_t idx = 0; idx < m_counts.size(); ++idx) {
+    std::size_t slot = hashKey(key(idx)) & mask;
+    while (slots[slot] != 0)
+      slot = (slot + 1) & mask;
+    slots[slot] = idx + 1;
+  }
+  m_slots = std::move(slots);
+}
+
+void PackedSampleCounts::add(std::span<const uint64_t> key,
+                             std::size_t count) {
+  m_numShots += count;
+  const std::size_t mask = m_slots.size() - 1;
+  std::size_t slot = hashKey(key) & mask;
+  while (m_slots[slot] != 0) {
+    const std::size_t idx = m_slots[slot] - 1;
+    if (std::equal(key.begin(), key.end(),
+                   m_keys.begin() + idx * m_numWords)) {
+      m_counts[idx] += count;
+      return;
+    }
+    slot = (slot + 1) & mask;
+  }
+  m_keys.insert(m_keys.end(), key.begin(), key.end());
+  m_counts.emplace_back(count);
+  m_slots[slot] = m_counts.size();
+  if (2 * m_counts.size() > m_slots.size())
+    growSlots();
+}
+
+void PackedSampleCounts::addSamples(std::span<const int64_t> samples) {
+  // Without bits, the number of shots is unknown from the samples.
+  if (m_numBits == 0)
+    return;
+  if (samples.size() % m_numBits != 0)
+    throw std::invalid_argument(
+        fmt::format("Expecting rows of {} samples, got {} values.", m_numBits,
+                    samples.size()));
+  for (std::size_t row = 0; row < samples.size(); row += m_numBits) {
+    const int64_t *bits = samples.data() + row;
+    for (std::size_t w = 0; w < m_numWords; ++w) {
+      const std::size_t numWordBits =
+          std::min<std::size_t>(64, m_numBits - 64 * w);
+      uint64_t word = 0;
+      for (std::size_t i = 0; i < numWordBits; ++i)
+        word |= static_cast<uint64_t>(bits[64 * w + i] & 1) << i;
+      m_packed[w] = word;
+    }
+    add(m_packed);
+  }
+}
+
+void PackedSampleCounts::merge(const PackedSampleCounts &other) {
+  if (other.m_numBits != m_numBits)
+    throw std::invalid_argument(
+        fmt::format("Cannot merge counts of {} bits into counts of {} bits.",
+                    other.m_numBits, m_numBits));
+  for (std::size_t idx = 0; idx < other.size(); ++idx)
+    add(other.key(idx), other.count(idx));
+}
+
+double PackedSampleCounts::parityExpectation() const {
+  if (m_numShots == 0)
+    return 0.0;
+  int64_t paritySum = 0;
+  for (std::size_t idx = 0; idx < m_counts.size(); ++idx) {
+    uint64_t parity = 0;
+    for (uint64_t word : key(idx))
+      parity ^= word;
+    const auto signedCount = static_cast<int64_t>(m_counts[idx]);
+    paritySum += (std::popcount(parity) & 1) ? -signedCount : signedCount;
+  }
+  return static_cast<double>(paritySum) / static_cast<double>(m_numShots);
+}
+
+std::string PackedSampleCounts::toBitString(std::size_t idx) const {
+  std::string bitString(m_numBits, '0');
+  const auto packed = key(idx);
+  for (std::size_t i = 0; i < m_numBits; ++i)
+    if ((packed[i / 64] >> (i % 64)) & 1)
+      bitString[i] = '1';
+  return bitString;
+}
+
+std::unordered_map<std::string, std::size_t>
+PackedSampleCounts::toCounts() const {
+  std::unordered_map<std::string, std::size_t> counts;
+  counts.reserve(m_counts.size());
+  for (std::size_t idx = 0; idx < m_counts.size(); ++idx)
+    counts.emplace(toBitString(idx), m_counts[idx]);
+  return counts;
+}
+
+PackedSampleCounts PackedSampleCounts::fromCounts(
+    std::size_t numBits,
+    const std::unordered_map<std::string, std::size_t> &counts) {
+  PackedSampleCounts packedCounts(numBits);
+  std::vector<uint64_t> packed(packedCounts.m_numWords);
+  for (const auto &[bitString, count] : counts) {
+    if (bitString.size() != numBits)
+      throw std::invalid_argument(
+          fmt::format("Expecting bit strings of {} bits, got '{}'.", numBits,
+                      bitString));
+    std::fill(packed.begin(), packed.end(), 0);
+    for (std::size_t i = 0; i < numBits; ++i)
+      if (bitString[i] == '1')
+        packed[i / 64] |= uint64_t{1} << (i % 64);
+    packedCounts.add(packed, count);
+  }
+  return packedCounts;
+}
+} // namespace nvqir
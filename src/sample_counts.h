@@ -0,0 +1,87 @@
+/****************************************************************-*- C++ -*-****
+ * Copyright (c) 2022 - 2025 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace nvqir {
+
+/// @brief Histogram of sampled bit strings of `numBits()` bits, each packed
+/// into `numWords()` 64-bit words (bit `i` of the string in bit `i % 64` of
+/// word `i / 64`).
+///
+/// Shots are counted in a flat open-addressing hash table (linear probing)
+/// whose keys are stored contiguously, in the order they were first drawn: no
+/// allocation per shot or per outcome. Bit strings are only materialized at
+/// the `cudaq::ExecutionResult` boundary (`toCounts`, `toBitString`).
+class PackedSampleCounts {
+public:
+  explicit PackedSampleCounts(std::size_t numBits = 0);
+
+  std::size_t numBits() const { return m_numBits; }
+  std::size_t numWords() const { return m_numWords; }
+  /// @brief Number of distinct outcomes.
+  std::size_t size() const { return m_counts.size(); }
+  /// @brief Number of shots, i.e., the sum of the counts.
+  std::size_t numShots() const { return m_numShots; }
+
+  /// @brief Packed outcome `idx` (in first-drawn order) and its count.
+  std::span<const uint64_t> key(std::size_t idx) const {
+    return {m_keys.data() + idx * m_numWords, m_numWords};
+  }
+  std::size_t count(std::size_t idx) const { return m_counts[idx]; }
+
+  /// @brief Count `count` shots of the packed outcome `key`.
+  void add(std::span<const uint64_t> key, std::size_t count = 1);
+
+  /// @brief Count shots in the layout of `cutensornetSamplerSample`: one row
+  /// of `numBits()` values (0 or 1) per shot.
+  void addSamples(std::span<const int64_t> samples);
+
+  /// @brief Count all the shots of `other` (of the same width).
+  void merge(const PackedSampleCounts &other);
+
+  /// @brief Mean parity of the shots (+1 for an even number of ones, -1
+  /// otherwise), i.e., the expectation of Z...Z on the sampled bits; zero
+  /// without shots.
+  double parityExpectation() const;
+
+  /// @brief Bit string of outcome `idx` (character `i` for bit `i`).
+  std::string toBitString(std::size_t idx) const;
+
+  /// @brief Counts by bit string.
+  std::unordered_map<std::string, std::size_t> toCounts() const;
+
+  /// @brief Histogram of counts by bit string (of `numBits` characters).
+  static PackedSampleCounts
+  fromCounts(std::size_t numBits,
+             const std::unordered_map<std::string, std::size_t> &counts);
+
+private:
+  std::size_t hashKey(std::span<const uint64_t> key) const;
+  void growSlots();
+
+  std::size_t m_numBits;
+  std::size_t m_numWords;
+  // Keys of the outcomes (`m_numWords` words each) and their counts.
+  std::vector<uint64_t> m_keys;
+  std::vector<std::size_t> m_counts;
+  // Hash table of outcome indices plus one (zero for empty slots); its size
+  // is a power of two, at most half full.
+  std::vector<std::size_t> m_slots;
+  std::size_t m_numShots = 0;
+  // Packing buffer of `addSamples`.
+  std::vector<uint64_t> m_packed;
+};
+} // namespace nvqir
@@ -9,10 +9,25 @@
 #pragma once
 
 #include "CircuitSimulator.h"
+#include "correlation_matrix.h"
 #include "cutensornet.h"
+#include "local_observable.h"
+#include "observe_strategy.h"
+#include "parameterized_circuit.h"
+#include "pauli_mpo.h"
 #include "tensornet_state.h"
 
 namespace nvqir {
+/// @brief Queries whose cost can be estimated without executing them (see
+/// `SimulatorTensorNetBase::explain`).
+enum class ExplainQueryKind {
+  Sample,
+  ReducedDensityMatrix,
+  Amplitudes,
+  Expectation,
+  MPSFactorization
+};
+
 /// @brief Base class of `cutensornet` simulator backends
 template <typename ScalarType = double>
 class SimulatorTensorNetBase : public nvqir::CircuitSimulatorBase<ScalarType> {
@@ -73,6 +88,87 @@ public:
   /// @brief Evaluate the expectation value of a given observable
   virtual cudaq::observe_result observe(const cudaq::spin_op &op) override;
 
+  /// @brief Estimate the cost of a query on the current state without
+  /// executing it (dry run). `qubits` are the measured qubits (`Sample`), the
+  /// qubits of the reduced density matrix or the projected qubits
+  /// (`Amplitudes`). An `Expectation` query estimates `observe(*observable)`
+  /// (required) by the route it would take: per term, by term families or
+  /// supports (summing the reduced density matrices), as a whole operator or
+  /// as an MPO (without shots or noise trajectories); Pauli propagation, on
+  /// the host, costs no contraction. Cached contraction paths are used, but
+  /// the paths found are not stored in the path cache or recorded for warm
+  /// starts.
+  virtual ContractionEstimate
+  explain(ExplainQueryKind kind, const std::vector<std::size_t> &qubits,
+          const cudaq::spin_op *observable = nullptr);
+
+  /// @brief Same as `explain`, on the network of a circuit on `numQubits`
+  /// qubits given by the qubit operands of its ops (with placeholder gate
+  /// tensors, as only their shapes matter), e.g., to estimate a job on the
+  /// device before running it. Independent of the current register.
+  ContractionEstimate
+  explainCircuit(std::size_t numQubits, const std::vector<CircuitOp> &ops,
+                 ExplainQueryKind kind, const std::vector<std::size_t> &qubits,
+                 const cudaq::spin_op *observable = nullptr);
+
+  /// @brief Expectation value of `observable` on the state prepared by
+  /// `circuit` (from the zero state, noiseless) and its gradient with respect
+  /// to `parameters`, with the parameter-shift rule. The network is built once,
+  /// with the parameterized gates as mutable tensors, and all the 2P+1
+  /// expectations (P parameterized gates) are computed with a single prepared
+  /// expectation, swapping the shifted gate tensors in place. Independent of
+  /// the current register.
+  ExpectationGradient
+  parameterShiftGradient(const ParameterizedCircuit &circuit,
+                         const cudaq::spin_op &observable,
+                         const std::vector<double> &parameters);
+
+  /// @brief Same as `parameterShiftGradient`, by adjoint (reverse-mode)
+  /// differentiation: the double-layer network, closed by the compressed MPO
+  /// of the whole observable (cached as for the MPO observe mode), is
+  /// contracted once and a single backward pass through the contraction
+  /// yields the environments of all the parameterized gate tensors (see
+  /// `TensorNetState::computeExpValGradients`), i.e., about 3 contractions
+  /// regardless of the number of terms and parameters, each growing with the
+  /// bond dimension of the MPO. The observable is assumed Hermitian.
+  ExpectationGradient adjointGradient(const ParameterizedCircuit &circuit,
+                                      const cudaq::spin_op &observable,
+                                      const std::vector<double> &parameters);
+
+  /// @brief Expectation value of the sum of dense local matrices `terms` (see
+  /// `LocalMatrixTerm`) on the current state. Each term is a single tensor of
+  /// the network operator, rather than the up to 4^k Pauli products of its
+  /// expansion. The value is complex for non-Hermitian terms. With noise, it
+  /// is averaged over trajectories, as `observe`.
+  virtual std::complex<double>
+  observeLocalMatrices(const std::vector<LocalMatrixTerm> &terms);
+
+  /// @brief Same as `observeLocalMatrices`, on the state prepared by
+  /// `circuit` with `parameters` (from the zero state, noiseless).
+  /// Independent of the current register.
+  std::complex<double>
+  localMatrixExpectation(const ParameterizedCircuit &circuit,
+                         const std::vector<LocalMatrixTerm> &terms,
+                         const std::vector<double> &parameters);
+
+  /// @brief One- and two-point correlators of `pairs` on the current state
+  /// (see `CorrelationMatrices`), e.g., the N x N matrices of <Z_i Z_j> and
+  /// <X_i X_j>, instead of one observe per correlator. All the correlators
+  /// share a single prepared expectation (see `computeExpVals`); the MPS
+  /// backend instead sweeps the factorized state once per row (see
+  /// `computeMpsCorrelations`). With noise, they are averaged over
+  /// trajectories.
+  virtual CorrelationMatrices
+  computeCorrelations(const std::vector<PauliPair> &pairs);
+
+  /// @brief Same as `computeCorrelations`, on the state prepared by `circuit`
+  /// with `parameters` (from the zero state, noiseless). Independent of the
+  /// current register.
+  CorrelationMatrices
+  correlationMatrices(const ParameterizedCircuit &circuit,
+                      const std::vector<PauliPair> &pairs,
+                      const std::vector<double> &parameters);
+
   /// Clone API
   virtual nvqir::CircuitSimulator *clone() override;
 
@@ -90,6 +186,119 @@ public:
   void setRandomSeed(std::size_t randomSeed) override;
 
 protected:
+  /// @brief Select the device, create the cuTensorNet handle and compute the
+  /// scratch size, if not done yet. Must be called before creating a state.
+  void initializeDevice();
+
+  /// @brief Called once the cuTensorNet handle has been created.
+  virtual void onHandleCreated() {}
+
+  /// @brief Correlators of `pairs` on `state` from the expectation values of
+  /// their Pauli products (see `getCorrelatorStrings`).
+  static CorrelationMatrices computeCorrelationsByExpVals(
+      TensorNetState<ScalarType> &state, const std::vector<PauliPair> &pairs,
+      const std::optional<std::size_t> &numberTrajectories);
+
+  /// @brief Correlators of `pairs` on the noiseless state of a circuit (see
+  /// `correlationMatrices`).
+  virtual CorrelationMatrices
+  computeCircuitCorrelations(TensorNetState<ScalarType> &state,
+                             const std::vector<PauliPair> &pairs) {
+    return computeCorrelationsByExpVals(state, pairs, std::nullopt);
+  }
+
+  /// @brief Term ids and terms of a spin op, for per-term observe results.
+  static std::tuple<std::vector<std::string>, std::vector<cudaq::spin_op_term>>
+  prepareSpinOpTermData(const cudaq::spin_op &ham);
+
+  /// @brief Trajectories of the last noisy expectation value of the state in
+  /// target-precision mode, or null.
+  const TrajectoryStatistics *getTrajectoryStatistics() const;
+
+  /// @brief Observe result entry (register `g_trajectoryStatisticsRegister`)
+  /// of the trajectories run by a noisy observe in target-precision mode.
+  static cudaq::ExecutionResult
+  getTrajectoryStatisticsResult(const TrajectoryStatistics &statistics) {
+    return cudaq::ExecutionResult(
+        {{"trajectories", statistics.numTrajectories}},
+        g_trajectoryStatisticsRegister, statistics.standardError);
+  }
+
+  /// @brief Observe result entry (register `g_partialResultRegister`) of a
+  /// query stopped early by its execution control, if so.
+  static std::optional<cudaq::ExecutionResult>
+  getPartialResult(const QueryExecutionControl &queryControl) {
+    const auto progress = queryControl.getPartialProgress();
+    if (!progress)
+      return std::nullopt;
+    return cudaq::ExecutionResult({{"slices", progress->slicesDone},
+                                   {"trajectories", progress->trajectoriesDone},
+                                   {"shots", progress->shotsDone}},
+                                  g_partialResultRegister);
+  }
+
+  /// @brief Sample result of packed outcomes: counts and per-shot data by
+  /// bit string, and the mean parity as expectation value.
+  static cudaq::ExecutionResult
+  getSampleResult(const PackedSampleCounts &samples);
+
+  /// @brief Number of shots of the observe of the execution context, if
+  /// shot-based expectation values are requested.
+  std::optional<std::size_t> getObserveShots() const;
+
+  /// @brief Shot-based `observe`: the terms are grouped into
+  /// qubit-wise-commuting measurement bases (see `groupQubitWiseCommuting`).
+  /// Basis-change gates are appended to the state once, as mutable gates
+  /// switched per basis, and each basis is sampled once (`shots` shots), from
+  /// which all its terms are estimated by bit-mask parity. The gates are
+  /// removed afterwards (see `TensorNetState::truncateOps`). The execution
+  /// control is checked before each basis: the terms of the bases not sampled
+  /// are left out of the result (and the total). An entry (register
+  /// `g_measurementBasesRegister`) holds the number of bases sampled and the
+  /// shots per term.
+  cudaq::observe_result observeWithShots(const cudaq::spin_op &ham,
+                                         std::size_t shots);
+
+  /// @brief `observe` by Pauli propagation (see `propagatePauliSum`), with
+  /// the truncation of `getPauliPropagationSettings`: only the total is known,
+  /// along with an entry (register `g_pauliPropagationRegister`) holding the
+  /// truncation error bound and the number of Pauli products. None if the
+  /// circuit is not made of unitary gates supported by the propagation.
+  std::optional<cudaq::observe_result>
+  observeByPauliPropagation(const cudaq::spin_op &ham);
+
+  /// @brief Evaluation mode of an observable on `numQubits` qubits whose
+  /// (non-identity) terms act on `termWeights` qubits each, in `auto` mode.
+  virtual ObserveMode
+  chooseAutoObserveMode(std::size_t numQubits,
+                        const std::vector<std::size_t> &termWeights) {
+    return chooseObserveMode(numQubits, termWeights);
+  }
+
+  /// @brief Mode of `observe` in `auto` mode on `state`, for the terms
+  /// `pauliStrings` (of weights `termWeights`, without the identity terms).
+  /// The qubit-wise-commuting grouping, if computed to decide, is kept in
+  /// `grouping`.
+  ObserveMode
+  resolveAutoObserveMode(const TensorNetState<ScalarType> &state,
+                         const std::vector<PauliString> &pauliStrings,
+                         const std::vector<std::size_t> &termWeights,
+                         std::optional<PauliTermGrouping> &grouping);
+
+  /// @brief Compressed MPO of `ham` (with the Pauli strings and terms of
+  /// `prepareSpinOpTermData`), or null if its terms span a single qubit. The
+  /// MPO of the last observable is kept, as the same observable is typically
+  /// evaluated repeatedly (e.g., in variational loops).
+  const MatrixProductOperator *
+  getObservableMpo(const cudaq::spin_op &ham,
+                   const std::vector<PauliString> &pauliStrings,
+                   const std::vector<cudaq::spin_op_term> &terms);
+
+  /// @brief Zero state of `numQubits` qubits, reusing the state object of the
+  /// last deallocated register if it has the same width.
+  std::unique_ptr<TensorNetState<ScalarType>>
+  createZeroState(std::size_t numQubits);
+
   // Sub-type need to implement
   virtual void prepareQubitTensorState() = 0;
 
@@ -114,13 +323,38 @@ protected:
   virtual bool canHandleGeneralNoiseChannel() const = 0;
 
 private:
+  /// Build the network of `circuit` on a new state, with the parameterized
+  /// gates applied as mutable ops (passed to `evaluate` in circuit order),
+  /// and run `evaluate` on it. The gate tensors in `gateDeviceMems` (to which
+  /// `evaluate` may add) are freed once the state is destroyed.
+  void evaluateCircuit(
+      const ParameterizedCircuit &circuit,
+      const std::vector<double> &parameters,
+      const std::function<void(TensorNetState<ScalarType> &,
+                               const std::vector<std::size_t> &,
+                               std::vector<void *> &)> &evaluate);
+
+  /// Estimate of `kind` on `state` (see `explain`).
+  ContractionEstimate explainState(TensorNetState<ScalarType> &state,
+                                   ExplainQueryKind kind,
+                                   const std::vector<std::size_t> &qubits,
+                                   const cudaq::spin_op *observable);
+
+  /// Estimate of `observe(ham)` on `state`, by the route it would take.
+  ContractionEstimate explainObserve(TensorNetState<ScalarType> &state,
+                                     const cudaq::spin_op &ham);
+
   // Helper to apply a Kraus channel
   void applyKrausChannel(const std::vector<int32_t> &qubits,
                          const cudaq::kraus_channel &channel);
 
 protected:
-  cutensornetHandle_t m_cutnHandle;
+  // Created on first use (see `initializeDevice`).
+  cutensornetHandle_t m_cutnHandle = nullptr;
   std::unique_ptr<TensorNetState<ScalarType>> m_state;
+  // State object of the last deallocated register, kept for reuse by the next
+  // register (see `createZeroState`).
+  std::unique_ptr<TensorNetState<ScalarType>> m_spareState;
   std::unordered_map<std::string, void *> m_gateDeviceMemCache;
   ScratchDeviceMem scratchPad;
   // Random number generator for generating 32-bit numbers with a state size of
@@ -141,6 +375,19 @@ protected:
   //   simplification, e.g., when the spin op is sparse (only acting on a few
   //   qubits).
   bool m_reuseContractionPathObserve = false;
+
+  // Last observable evaluated as an MPO, and its MPO (see
+  // `getObservableMpo`).
+  std::optional<std::pair<cudaq::spin_op, MatrixProductOperator>>
+      m_observableMpo;
+
+  // True if the random seed was set by the user, i.e., sampling results are
+  // reproducible and thus can be memoized.
+  bool m_randomSeedSet = false;
+
+  // Whether MPI was initialized when the cuTensorNet handle was created; the
+  // handle is only re-created when that changes.
+  bool m_handleMpiInitialized = false;
 };
 
 } // end namespace nvqir
@@ -12,6 +12,7 @@
 #include "simulator_cutensornet.h"
 #include <charconv>
 #include <errno.h>
+#include <numeric>
 
 namespace nvqir {
 template <typename ScalarType = double>
@@ -56,6 +57,7 @@ public:
     if (!casted)
       throw std::invalid_argument(
           "[SimulatorMPS simulator] Incompatible state input");
+    this->initializeDevice();
     if (!m_state) {
       m_state = TensorNetState<ScalarType>::createFromMpsTensors(
           casted->getMpsTensors(), scratchPad, m_cutnHandle, m_randomEngine);
@@ -180,22 +182,50 @@ public:
                                                       op);
   }
 
-  // Helper to compute expectation value from a bit string distribution
-  static double computeExpValFromDistribution(
-      const std::unordered_map<std::string, std::size_t> &distribution,
-      int shots) {
-    double expVal = 0.0;
-    // Compute the expectation value from the distribution
-    for (auto &kv : distribution) {
-      auto par = cudaq::sample_result::has_even_parity(kv.first);
-      auto p = kv.second / (double)shots;
-      if (!par) {
-        p = -p;
-      }
-      expVal += p;
+
+  // Observables with many terms are contracted with the MPS as a single MPO.
+  ObserveMode
+  chooseAutoObserveMode(std::size_t numQubits,
+                        const std::vector<std::size_t> &termWeights) override {
+    return chooseMpsObserveMode(numQubits, termWeights);
+  }
+
+  CorrelationMatrices
+  computeCircuitCorrelations(TensorNetState<ScalarType> &state,
+                             const std::vector<PauliPair> &pairs) override {
+    if (state.getNumQubits() < 2)
+      return SimulatorTensorNetBase<ScalarType>::computeCircuitCorrelations(
+          state, pairs);
+    auto mpsTensors = state.factorizeMPS(
+        m_settings.maxBond, m_settings.absCutoff, m_settings.relCutoff,
+        m_settings.svdAlgo, m_settings.gaugeOption);
+    const auto mps = copyMpsToHost(mpsTensors);
+    for (auto &tensor : mpsTensors)
+      HANDLE_CUDA_ERROR(cudaFree(tensor.deviceData));
+    auto matrices = makeCorrelationMatrices(pairs, state.getNumQubits());
+    computeMpsCorrelations(mps, matrices);
+    return matrices;
+  }
+
+  /// @brief Copy of factorized MPS tensors (at least 2) to the host.
+  static HostMps copyMpsToHost(const std::vector<MPSTensor> &mpsTensors) {
+    HostMps mps;
+    for (std::size_t site = 0; site < mpsTensors.size(); ++site) {
+      const auto &extents = mpsTensors[site].extents;
+      // The edge tensors omit their trivial bond mode.
+      if (site + 1 < mpsTensors.size())
+        mps.bondDims.emplace_back(extents.back());
+      const std::size_t size =
+          std::accumulate(extents.begin(), extents.end(), std::size_t{1},
+                          std::multiplies<std::size_t>());
+      std::vector<std::complex<ScalarType>> tensor(size);
+      HANDLE_CUDA_ERROR(cudaMemcpy(tensor.data(), mpsTensors[site].deviceData,
+                                   size * sizeof(std::complex<ScalarType>),
+                                   cudaMemcpyDeviceToHost));
+      mps.tensors.emplace_back(tensor.begin(), tensor.end());
     }
-    return expVal;
-  };
+    return mps;
+  }
 
   // Set up the MPS factorization before trajectory simulation run loop.
   // We only need to do cutensornetStateFinalizeMPS once
@@ -214,6 +244,19 @@ public:
         m_settings.svdAlgo, m_settings.gaugeOption);
   }
 
+  ContractionEstimate
+  explain(ExplainQueryKind kind, const std::vector<std::size_t> &qubits,
+          const cudaq::spin_op *observable = nullptr) override {
+    if (kind != ExplainQueryKind::MPSFactorization)
+      return SimulatorTensorNetBase<ScalarType>::explain(kind, qubits,
+                                                         observable);
+    LOG_API_TIME();
+    this->flushGateQueue();
+    return m_state->explainMPSFactorization(
+        m_settings.maxBond, m_settings.absCutoff, m_settings.relCutoff,
+        m_settings.svdAlgo, m_settings.gaugeOption);
+  }
+
   /// @brief Sample a subset of qubits
   cudaq::ExecutionResult sample(const std::vector<std::size_t> &measuredBits,
                                 const int shots) override {
@@ -223,15 +266,40 @@ public:
       return SimulatorTensorNetBase<ScalarType>::sample(measuredBits, shots);
 
     LOG_API_TIME();
-    cudaq::ExecutionResult counts;
+    QueryExecutionControl queryControl;
     std::vector<int32_t> measuredBitIds(measuredBits.begin(),
                                         measuredBits.end());
 
+    // With unitary channels only, each distinct trajectory is factorized and
+    // sampled once, for all the shots that selected it.
+    if (auto samples = m_state->sampleTrajectories(
+            measuredBitIds, shots,
+            [&](TensorNetState<ScalarType> &state, int32_t numShots) {
+              std::vector<MPSTensor> mpsTensors;
+              if (state.getNumQubits() > 1)
+                mpsTensors = state.factorizeMPS(
+                    m_settings.maxBond, m_settings.absCutoff,
+                    m_settings.relCutoff, m_settings.svdAlgo,
+                    m_settings.gaugeOption);
+              auto trajSamples = state.sample(measuredBitIds, numShots);
+              for (auto &tensor : mpsTensors)
+                HANDLE_CUDA_ERROR(cudaFree(tensor.deviceData));
+              return trajSamples;
+            }))
+      return this->getSampleResult(*samples);
+
+    PackedSampleCounts counts(measuredBitIds.size());
     setUpFactorizeForTrajectoryRuns();
     std::map<std::vector<int64_t>, std::pair<cutensornetStateSampler_t,
                                              cutensornetWorkspaceDescriptor_t>>
         samplerCache;
-    for (int i = 0; i < shots; ++i) {
+    int numShotsDrawn = 0;
+    for (; numShotsDrawn < shots; ++numShotsDrawn) {
+      if (numShotsDrawn > 0 && stopRequested(queryControl.get())) {
+        CUDAQ_INFO("Sampling stopped early: {} of {} trajectories drawn.",
+                   numShotsDrawn, shots);
+        break;
+      }
       // As the Kraus operator sampling may change the MPS state, we need to
       // re-compute the factorization in each trajectory.
       m_state->computeMPSFactorize(m_mpsTensors_d);
@@ -250,11 +318,10 @@ public:
 
       assert(iter != samplerCache.end());
       auto &[sampler, workDesc] = iter->second;
-      const auto samples = m_state->executeSample(
-          sampler, workDesc, measuredBitIds, 1, requireCacheWorkspace());
-      assert(samples.size() == 1);
-      for (const auto &[bitString, count] : samples)
-        counts.appendResult(bitString, count);
+      const auto samples =
+          m_state->executeSample(sampler, workDesc, measuredBitIds, 1);
+      assert(samples.numShots() == 1);
+      counts.merge(samples);
     }
 
     for (const auto &[k, v] : samplerCache) {
@@ -265,24 +332,7 @@ public:
       HANDLE_CUTN_ERROR(cutensornetDestroySampler(sampler));
     }
 
-    counts.expectationValue =
-        computeExpValFromDistribution(counts.counts, shots);
-
-    return counts;
-  }
-
-  // Helper to prepare term-by-term data from a spin op
-  static std::tuple<std::vector<std::string>, std::vector<cudaq::spin_op_term>>
-  prepareSpinOpTermData(const cudaq::spin_op &ham) {
-    std::vector<std::string> termStrs;
-    std::vector<cudaq::spin_op_term> prods;
-    termStrs.reserve(ham.num_terms());
-    prods.reserve(ham.num_terms());
-    for (auto &&term : prods) {
-      termStrs.emplace_back(term.get_term_id());
-      prods.push_back(std::move(term));
-    }
-    return std::make_tuple(termStrs, prods);
+    return this->getSampleResult(counts);
   }
 
   cudaq::observe_result observe(const cudaq::spin_op &ham) override {
@@ -290,33 +340,103 @@ public:
     LOG_API_TIME();
     const bool hasNoise =
         this->executionContext && this->executionContext->noiseModel;
-    // If no noise, just use base class implementation.
-    if (!hasNoise)
+    // If no noise, just use base class implementation. With shots, the
+    // trajectories are those of the sampling of each measurement basis.
+    if (!hasNoise || this->getObserveShots())
       return SimulatorTensorNetBase<ScalarType>::observe(ham);
 
+    QueryExecutionControl queryControl;
     setUpFactorizeForTrajectoryRuns();
     const std::size_t numObserveTrajectories =
         this->executionContext->numberTrajectories.has_value()
             ? this->executionContext->numberTrajectories.value()
             : TensorNetState<ScalarType>::g_numberTrajectoriesForObserve;
 
-    auto [termStrs, terms] = prepareSpinOpTermData(ham);
+    auto [termStrs, terms] = this->prepareSpinOpTermData(ham);
     std::vector<std::complex<double>> termExpVals(terms.size(), 0.0);
+    // With an MPO, a single expectation per trajectory gives the total.
+    std::optional<TensorNetworkMpo<ScalarType>> mpoOp;
+    std::complex<double> mpoExpVal = 0.0;
+    {
+      const auto pauliStrings =
+          TensorNetState<ScalarType>::getPauliStrings(terms);
+      std::vector<std::size_t> termWeights;
+      for (const auto &pauliString : pauliStrings)
+        if (!pauliString.empty())
+          termWeights.emplace_back(pauliString.size());
+      auto mode = getObserveModeSetting();
+      if (mode == ObserveMode::Auto)
+        mode = chooseAutoObserveMode(m_state->getNumQubits(), termWeights);
+      if (mode == ObserveMode::Mpo && !termWeights.empty())
+        if (const auto *mpo = this->getObservableMpo(ham, pauliStrings, terms))
+          mpoOp.emplace(*mpo, m_state->getNumQubits(), m_cutnHandle);
+    }
 
-    for (std::size_t i = 0; i < numObserveTrajectories; ++i) {
+    // Once the execution control requests to stop, the expectation values are
+    // averaged over the trajectories run so far (at least one). In
+    // target-precision mode, they also stop once the standard error of the
+    // total is small enough: all the terms are evaluated on the same
+    // trajectories, so that it is the standard error of the trajectory totals.
+    const auto &precision = getTrajectoryPrecision();
+    RunningStatistics totalStats;
+    std::size_t numTrajectoriesRun = 0;
+    for (; numTrajectoriesRun < numObserveTrajectories; ++numTrajectoriesRun) {
+      if (numTrajectoriesRun > 0 && stopRequested(queryControl.get())) {
+        CUDAQ_INFO("Observe stopped early: {} of {} trajectories run.",
+                   numTrajectoriesRun, numObserveTrajectories);
+        break;
+      }
+      if (precision && precision->shouldCheck(numTrajectoriesRun) &&
+          std::sqrt(totalStats.squaredStandardError()) <=
+              precision->targetError)
+        break;
       // As the Kraus operator sampling may change the MPS state, we need to
       // re-compute the factorization in each trajectory.
       m_state->computeMPSFactorize(m_mpsTensors_d);
       // We run a single trajectory for MPS as the final MPS form depends on the
       // randomly-selected noise op.
+      if (mpoOp) {
+        const auto trajExpVal =
+            m_state->computeExpVal(mpoOp->getNetworkOperator(), 1);
+        mpoExpVal += trajExpVal;
+        totalStats.add(trajExpVal.real());
+        continue;
+      }
       const auto trajTermExpVals = m_state->computeExpVals(terms, 1);
 
+      double trajExpVal = 0.0;
       for (std::size_t idx = 0; idx < terms.size(); ++idx) {
-        termExpVals[idx] += (trajTermExpVals[idx] /
-                             static_cast<ScalarType>(numObserveTrajectories));
+        termExpVals[idx] += trajTermExpVals[idx];
+        trajExpVal += trajTermExpVals[idx].real();
       }
+      totalStats.add(trajExpVal);
+    }
+    std::optional<TrajectoryStatistics> statistics;
+    if (precision) {
+      statistics = TrajectoryStatistics{
+          numTrajectoriesRun, std::sqrt(totalStats.squaredStandardError())};
+      CUDAQ_INFO("Observe averaged over {} of at most {} trajectories "
+                 "(standard error {}).",
+                 numTrajectoriesRun, numObserveTrajectories,
+                 statistics->standardError);
+    }
+    if (mpoOp) {
+      const double expVal =
+          mpoExpVal.real() / static_cast<double>(numTrajectoriesRun);
+      std::vector<cudaq::ExecutionResult> results{
+          cudaq::ExecutionResult({}, expVal)};
+      if (statistics)
+        results.emplace_back(this->getTrajectoryStatisticsResult(*statistics));
+      if (auto partial = this->getPartialResult(queryControl))
+        results.emplace_back(std::move(*partial));
+      cudaq::sample_result totalData(expVal, results);
+      return cudaq::observe_result(expVal, ham, totalData);
     }
     std::complex<double> expVal = 0.0;
+    for (auto &termExpVal : termExpVals) {
+      termExpVal /= static_cast<double>(numTrajectoriesRun);
+      expVal += termExpVal;
+    }
     // Construct per-term data in the final observe_result
     std::vector<cudaq::ExecutionResult> results;
     results.reserve(terms.size());
@@ -325,11 +445,92 @@ public:
       results.emplace_back(
           cudaq::ExecutionResult({}, termStrs[i], termExpVals[i].real()));
     }
+    if (statistics)
+      results.emplace_back(this->getTrajectoryStatisticsResult(*statistics));
+    if (auto partial = this->getPartialResult(queryControl))
+      results.emplace_back(std::move(*partial));
 
     cudaq::sample_result perTermData(expVal.real(), results);
     return cudaq::observe_result(expVal.real(), ham, perTermData);
   }
 
+  std::complex<double>
+  observeLocalMatrices(const std::vector<LocalMatrixTerm> &terms) override {
+    const bool hasNoise =
+        this->executionContext && this->executionContext->noiseModel;
+    if (!hasNoise)
+      return SimulatorTensorNetBase<ScalarType>::observeLocalMatrices(terms);
+
+    LOG_API_TIME();
+    this->flushGateQueue();
+    validateLocalMatrixTerms(terms, m_state->getNumQubits());
+    QueryExecutionControl queryControl;
+    setUpFactorizeForTrajectoryRuns();
+    const std::size_t numObserveTrajectories =
+        this->executionContext->numberTrajectories.value_or(
+            TensorNetState<ScalarType>::g_numberTrajectoriesForObserve);
+    TensorNetworkLocalOp<ScalarType> localOp(terms, m_state->getNumQubits(),
+                                             m_cutnHandle);
+    if (localOp.getNumProducts() == 0)
+      return localOp.getConstantOffset();
+    // As in `observe`: one factorization and expectation per trajectory.
+    std::complex<double> expVal = 0.0;
+    std::size_t numTrajectoriesRun = 0;
+    for (; numTrajectoriesRun < numObserveTrajectories; ++numTrajectoriesRun) {
+      if (numTrajectoriesRun > 0 && stopRequested(queryControl.get()))
+        break;
+      m_state->computeMPSFactorize(m_mpsTensors_d);
+      expVal += std::complex<double>(
+          m_state->computeExpVal(localOp.getNetworkOperator(), 1));
+    }
+    return expVal / static_cast<double>(numTrajectoriesRun) +
+           localOp.getConstantOffset();
+  }
+
+  CorrelationMatrices
+  computeCorrelations(const std::vector<PauliPair> &pairs) override {
+    // A single qubit is not factorized.
+    if (m_state->getNumQubits() < 2)
+      return SimulatorTensorNetBase<ScalarType>::computeCorrelations(pairs);
+    LOG_API_TIME();
+    this->flushGateQueue();
+    auto matrices = makeCorrelationMatrices(pairs, m_state->getNumQubits());
+    const bool hasNoise =
+        this->executionContext && this->executionContext->noiseModel;
+    if (!hasNoise) {
+      prepareQubitTensorState();
+      computeMpsCorrelations(copyMpsToHost(m_mpsTensors_d), matrices);
+      return matrices;
+    }
+
+    // As in `observe`: one factorization per trajectory, whose correlators
+    // are averaged.
+    QueryExecutionControl queryControl;
+    setUpFactorizeForTrajectoryRuns();
+    const std::size_t numObserveTrajectories =
+        this->executionContext->numberTrajectories.value_or(
+            TensorNetState<ScalarType>::g_numberTrajectoriesForObserve);
+    auto trajMatrices = matrices;
+    std::fill(matrices.onePoint.begin(), matrices.onePoint.end(), 0.0);
+    std::fill(matrices.twoPoint.begin(), matrices.twoPoint.end(), 0.0);
+    std::size_t numTrajectoriesRun = 0;
+    for (; numTrajectoriesRun < numObserveTrajectories; ++numTrajectoriesRun) {
+      if (numTrajectoriesRun > 0 && stopRequested(queryControl.get()))
+        break;
+      m_state->computeMPSFactorize(m_mpsTensors_d);
+      computeMpsCorrelations(copyMpsToHost(m_mpsTensors_d), trajMatrices);
+      for (std::size_t i = 0; i < matrices.onePoint.size(); ++i)
+        matrices.onePoint[i] += trajMatrices.onePoint[i];
+      for (std::size_t i = 0; i < matrices.twoPoint.size(); ++i)
+        matrices.twoPoint[i] += trajMatrices.twoPoint[i];
+    }
+    for (auto &value : matrices.onePoint)
+      value /= static_cast<double>(numTrajectoriesRun);
+    for (auto &value : matrices.twoPoint)
+      value /= static_cast<double>(numTrajectoriesRun);
+    return matrices;
+  }
+
 #ifdef TENSORNET_FP32
   virtual std::string name() const override { return "formotensor-mps-fp32"; }
 #else
@@ -342,10 +543,10 @@ public:
 
   void addQubitsToState(std::size_t numQubits, const void *ptr) override {
     LOG_API_TIME();
+    this->initializeDevice();
     if (!m_state) {
       if (!ptr) {
-        m_state = std::make_unique<TensorNetState<ScalarType>>(
-            numQubits, scratchPad, m_cutnHandle, m_randomEngine);
+        m_state = this->createZeroState(numQubits);
       } else {
         auto [state, mpsTensors] =
             MPSSimulationState<ScalarType>::createFromStateVec(
@@ -406,6 +607,7 @@ public:
 
   std::unique_ptr<cudaq::SimulationState> getSimulationState() override {
     LOG_API_TIME();
+    this->initializeDevice();
 
     if (!m_state || m_state->getNumQubits() == 0)
       return std::make_unique<MPSSimulationState<ScalarType>>(
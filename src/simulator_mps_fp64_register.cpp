@@ -9,3 +9,52 @@
 #include "simulator_mps.h"
 
 NVQIR_REGISTER_SIMULATOR(nvqir::SimulatorMPS<double>, formotensor_mps)
+
+namespace {
+nvqir::SimulatorTensorNetBase<double> &getSimulator() {
+  auto *simulator = dynamic_cast<nvqir::SimulatorTensorNetBase<double> *>(
+      getCircuitSimulator_formotensor_mps());
+  if (!simulator)
+    throw std::runtime_error(
+        "The formotensor-mps simulator is not available.");
+  return *simulator;
+}
+} // namespace
+
+/// Same as `formotensor_correlation_matrices`, on the MPS backend: the
+/// correlators are computed from the factorized state with environment
+/// caching (see `nvqir::computeMpsCorrelations`).
+extern "C" const char *formotensor_mps_correlation_matrices(
+    std::size_t numQubits, std::size_t numGates, const char *const *gateNames,
+    const std::size_t *controlOffsets, const std::size_t *controls,
+    const std::size_t *targets, const double *angles,
+    const int64_t *parameterIndices, const double *angleScales,
+    const char *pairs, std::size_t numParameters, const double *parameters,
+    void **result, char *kinds, double **onePoint, double **twoPoint) {
+  thread_local std::string errorMessage;
+  try {
+    auto &simulator = getSimulator();
+    const auto circuit =
+        nvqir::makeParameterizedCircuit(numQubits, numGates, gateNames,
+                                        controlOffsets, controls, targets,
+                                        angles, parameterIndices, angleScales);
+    auto matrices = std::make_unique<nvqir::CorrelationMatrices>(
+        simulator.correlationMatrices(
+            circuit, nvqir::parsePauliPairs(pairs),
+            std::vector<double>(parameters, parameters + numParameters)));
+    for (const auto kind : matrices->kinds)
+      *kinds++ = "IXYZ"[static_cast<std::size_t>(kind)];
+    *kinds = '\0';
+    *onePoint = matrices->onePoint.data();
+    *twoPoint = matrices->twoPoint.data();
+    *result = matrices.release();
+    return nullptr;
+  } catch (const std::exception &e) {
+    errorMessage = e.what();
+    return errorMessage.c_str();
+  }
+}
+
+extern "C" void formotensor_mps_free_correlation_matrices(void *result) {
+  delete static_cast<nvqir::CorrelationMatrices *>(result);
+}
@@ -16,6 +16,59 @@
 extern "C" nvqir::CircuitSimulator *getCircuitSimulator_formotensor_fp32();
 #else
 extern "C" nvqir::CircuitSimulator *getCircuitSimulator_formotensor();
+
+/// @brief C entry point of `SimulatorTensorNetBase::parameterShiftGradient`
+/// on the `formotensor` simulator, for callers without the CUDA-Q headers
+/// (e.g., the Python bridge, via `dlsym`).
+///
+/// Gate `i` is `gateNames[i]` on qubit `targets[i]`, controlled by
+/// `controls[controlOffsets[i]:controlOffsets[i + 1]]`, with angle
+/// `angles[i] + angleScales[i] * parameters[parameterIndices[i]]` (or just
+/// `angles[i]` if `parameterIndices[i]` is negative). The observable is the
+/// sum of `coefficients[j]` times the Pauli word `pauliWords[j]` (one letter
+/// per qubit). Writes the expectation value and the `numParameters` gradient
+/// entries, and returns null on success, or an error message (valid until the
+/// next call on the same thread) otherwise.
+extern "C" const char *formotensor_parameter_shift_gradient(
+    std::size_t numQubits, std::size_t numGates, const char *const *gateNames,
+    const std::size_t *controlOffsets, const std::size_t *controls,
+    const std::size_t *targets, const double *angles,
+    const int64_t *parameterIndices, const double *angleScales,
+    std::size_t numTerms, const char *const *pauliWords,
+    const double *coefficients, std::size_t numParameters,
+    const double *parameters, double *expectation, double *gradient);
+
+/// @brief Same as `formotensor_parameter_shift_gradient`, with
+/// `SimulatorTensorNetBase::adjointGradient`.
+extern "C" const char *formotensor_adjoint_gradient(
+    std::size_t numQubits, std::size_t numGates, const char *const *gateNames,
+    const std::size_t *controlOffsets, const std::size_t *controls,
+    const std::size_t *targets, const double *angles,
+    const int64_t *parameterIndices, const double *angleScales,
+    std::size_t numTerms, const char *const *pauliWords,
+    const double *coefficients, std::size_t numParameters,
+    const double *parameters, double *expectation, double *gradient);
+
+/// @brief C entry point of `SimulatorTensorNetBase::explainCircuit` on the
+/// `formotensor` simulator (e.g., for the Python bridge, via `dlsym`).
+///
+/// `query` is `sample`, `rdm`, `amplitudes` or `expectation`, with the qubits
+/// `queryQubits` (see `SimulatorTensorNetBase::explain`). Op `i` acts on the
+/// qubits `opQubits[opQubitOffsets[i]:opQubitOffsets[i + 1]]` (controls then
+/// targets), adjoint if `opAdjoints[i]` is nonzero. The observable of an
+/// `expectation` query is given as for
+/// `formotensor_parameter_shift_gradient`. Writes the estimate, with -1 for
+/// an unknown largest intermediate or number of slices, and returns null on
+/// success, or an error message (valid until the next call on the same
+/// thread) otherwise.
+extern "C" const char *formotensor_explain(
+    const char *query, std::size_t numQubits, std::size_t numOps,
+    const std::size_t *opQubitOffsets, const std::size_t *opQubits,
+    const int *opAdjoints, std::size_t numQueryQubits,
+    const std::size_t *queryQubits, std::size_t numTerms,
+    const char *const *pauliWords, const double *coefficients, double *flops,
+    double *largestIntermediate, int64_t *workspaceSize, int64_t *numSlices,
+    double *pathFindingSeconds, int *fitsWorkspace);
 #endif
 
 namespace nvqir {
@@ -30,18 +83,6 @@ class SimulatorTensorNet : public SimulatorTensorNetBase<ScalarType> {
 
 public:
   SimulatorTensorNet() : SimulatorTensorNetBase<ScalarType>() {
-    // tensornet backend supports distributed tensor network contraction,
-    // i.e., distributing tensor network contraction across multiple
-    // GPUs/processes.
-    //
-    // Note: this requires CUTENSORNET_COMM_LIB as described in
-    // the Getting Started section of the cuTensorNet library documentation
-    // (Installation and Compilation).
-    if (cudaq::mpi::is_initialized()) {
-      initCuTensornetComm(m_cutnHandle);
-      m_cutnMpiInitialized = true;
-    }
-
     // Retrieve user-defined controlled rank setting if provided.
     if (auto *maxControlledRankEnvVar =
             std::getenv("CUDAQ_TENSORNET_CONTROLLED_RANK")) {
@@ -62,6 +103,20 @@ public:
 
   // Nothing to do for state preparation
   virtual void prepareQubitTensorState() override {}
+
+  void onHandleCreated() override {
+    // tensornet backend supports distributed tensor network contraction,
+    // i.e., distributing tensor network contraction across multiple
+    // GPUs/processes.
+    //
+    // Note: this requires CUTENSORNET_COMM_LIB as described in
+    // the Getting Started section of the cuTensorNet library documentation
+    // (Installation and Compilation).
+    if (cudaq::mpi::is_initialized()) {
+      initCuTensornetComm(m_cutnHandle);
+      m_cutnMpiInitialized = true;
+    }
+  }
 #ifdef TENSORNET_FP32
   virtual std::string name() const override { return "formotensor-fp32"; }
 #else
@@ -74,7 +129,7 @@ public:
   // Add a hook to reset the cutensornet MPI Comm before MPI finalization
   // to make sure we have a clean shutdown.
   virtual void tearDownBeforeMPIFinalize() override {
-    if (cudaq::mpi::is_initialized()) {
+    if (cudaq::mpi::is_initialized() && m_cutnMpiInitialized) {
       resetCuTensornetComm(m_cutnHandle);
       m_cutnMpiInitialized = false;
     }
@@ -82,16 +137,21 @@ public:
 
   std::unique_ptr<cudaq::SimulationState> getSimulationState() override {
     LOG_API_TIME();
+    // Repeated amplitude/overlap queries on the returned state can reuse the
+    // cached intermediates.
+    if (m_state)
+      m_state->setCacheWorkspaceEnabled(requireCacheWorkspace());
+    this->initializeDevice();
     return std::make_unique<TensorNetSimulationState<ScalarType>>(
         std::move(m_state), scratchPad, m_cutnHandle, m_randomEngine);
   }
 
   void addQubitsToState(std::size_t numQubits, const void *ptr) override {
     LOG_API_TIME();
+    this->initializeDevice();
     if (!m_state) {
       if (!ptr) {
-        m_state = std::make_unique<TensorNetState<ScalarType>>(
-            numQubits, scratchPad, m_cutnHandle, m_randomEngine);
+        m_state = this->createZeroState(numQubits);
       } else {
         auto *casted = reinterpret_cast<std::complex<ScalarType> *>(
             const_cast<void *>(ptr));
@@ -119,6 +179,7 @@ public:
     if (!casted)
       throw std::invalid_argument(
           "[Tensornet simulator] Incompatible state input");
+    this->initializeDevice();
     if (!m_state) {
       m_state = TensorNetState<ScalarType>::createFromOpTensors(
           in_state.getNumQubits(), casted->getAppliedTensors(), scratchPad,
@@ -10,3 +10,251 @@
 
 /// Register this Simulator class with NVQIR under name "formotensor"
 NVQIR_REGISTER_SIMULATOR(nvqir::SimulatorTensorNet<double>, formotensor)
+
+namespace {
+using GradientMethod =
+    nvqir::ExpectationGradient (nvqir::SimulatorTensorNetBase<double>::*)(
+        const nvqir::ParameterizedCircuit &, const cudaq::spin_op &,
+        const std::vector<double> &);
+
+nvqir::SimulatorTensorNetBase<double> &getSimulator() {
+  auto *simulator = dynamic_cast<nvqir::SimulatorTensorNetBase<double> *>(
+      getCircuitSimulator_formotensor());
+  if (!simulator)
+    throw std::runtime_error("The formotensor simulator is not available.");
+  return *simulator;
+}
+
+// Observable of the C entry points: the sum of `coefficients[j]` times the
+// Pauli word `pauliWords[j]` (one letter per qubit).
+cudaq::spin_op makeObservable(std::size_t numQubits, std::size_t numTerms,
+                              const char *const *pauliWords,
+                              const double *coefficients) {
+  auto observable = cudaq::spin_op::empty();
+  for (std::size_t termIdx = 0; termIdx < numTerms; ++termIdx) {
+    const std::string word = pauliWords[termIdx];
+    if (word.size() != numQubits)
+      throw std::invalid_argument(fmt::format(
+          "Pauli word '{}' does not have {} letters.", word, numQubits));
+    observable += coefficients[termIdx] * cudaq::spin_op::from_word(word);
+  }
+  return cudaq::spin_op::canonicalize(observable);
+}
+
+// Shared implementation of the C gradient entry points (see
+// `formotensor_parameter_shift_gradient`).
+const char *computeGradient(
+    GradientMethod method, std::size_t numQubits, std::size_t numGates,
+    const char *const *gateNames, const std::size_t *controlOffsets,
+    const std::size_t *controls, const std::size_t *targets,
+    const double *angles, const int64_t *parameterIndices,
+    const double *angleScales, std::size_t numTerms,
+    const char *const *pauliWords, const double *coefficients,
+    std::size_t numParameters, const double *parameters, double *expectation,
+    double *gradient) {
+  thread_local std::string errorMessage;
+  try {
+    auto &simulator = getSimulator();
+    const auto circuit =
+        nvqir::makeParameterizedCircuit(numQubits, numGates, gateNames,
+                                        controlOffsets, controls, targets,
+                                        angles, parameterIndices, angleScales);
+    const auto observable =
+        makeObservable(numQubits, numTerms, pauliWords, coefficients);
+    const auto result = (simulator.*method)(
+        circuit, observable,
+        std::vector<double>(parameters, parameters + numParameters));
+    *expectation = result.expectation;
+    std::copy(result.gradient.begin(), result.gradient.end(), gradient);
+    return nullptr;
+  } catch (const std::exception &e) {
+    errorMessage = e.what();
+    return errorMessage.c_str();
+  }
+}
+} // namespace
+
+extern "C" const char *formotensor_parameter_shift_gradient(
+    std::size_t numQubits, std::size_t numGates, const char *const *gateNames,
+    const std::size_t *controlOffsets, const std::size_t *controls,
+    const std::size_t *targets, const double *angles,
+    const int64_t *parameterIndices, const double *angleScales,
+    std::size_t numTerms, const char *const *pauliWords,
+    const double *coefficients, std::size_t numParameters,
+    const double *parameters, double *expectation, double *gradient) {
+  return computeGradient(
+      &nvqir::SimulatorTensorNetBase<double>::parameterShiftGradient,
+      numQubits, numGates, gateNames, controlOffsets, controls, targets,
+      angles, parameterIndices, angleScales, numTerms, pauliWords,
+      coefficients, numParameters, parameters, expectation, gradient);
+}
+
+extern "C" const char *formotensor_adjoint_gradient(
+    std::size_t numQubits, std::size_t numGates, const char *const *gateNames,
+    const std::size_t *controlOffsets, const std::size_t *controls,
+    const std::size_t *targets, const double *angles,
+    const int64_t *parameterIndices, const double *angleScales,
+    std::size_t numTerms, const char *const *pauliWords,
+    const double *coefficients, std::size_t numParameters,
+    const double *parameters, double *expectation, double *gradient) {
+  return computeGradient(
+      &nvqir::SimulatorTensorNetBase<double>::adjointGradient, numQubits,
+      numGates, gateNames, controlOffsets, controls, targets, angles,
+      parameterIndices, angleScales, numTerms, pauliWords, coefficients,
+      numParameters, parameters, expectation, gradient);
+}
+
+/// Expectation value (real and imaginary parts in `expectation[0]` and
+/// `expectation[1]`) of a sum of dense local matrices on the state prepared by
+/// a circuit (same arrays as the gradient entry points). Term `j` acts on the
+/// qubits `termQubits[termQubitOffsets[j]]` to
+/// `termQubits[termQubitOffsets[j + 1] - 1]` (k qubits, the first one being
+/// the most significant bit), with the row-major 2^k x 2^k matrix stored as
+/// interleaved real and imaginary parts at `termMatrices[2 * m]`, `m` being
+/// the total number of matrix elements of the previous terms, and the complex
+/// coefficient at `coefficients[2 * j]`. Returns null, or the error message.
+extern "C" const char *formotensor_local_matrix_expectation(
+    std::size_t numQubits, std::size_t numGates, const char *const *gateNames,
+    const std::size_t *controlOffsets, const std::size_t *controls,
+    const std::size_t *targets, const double *angles,
+    const int64_t *parameterIndices, const double *angleScales,
+    std::size_t numTerms, const std::size_t *termQubitOffsets,
+    const std::size_t *termQubits, const double *termMatrices,
+    const double *coefficients, std::size_t numParameters,
+    const double *parameters, double *expectation) {
+  thread_local std::string errorMessage;
+  try {
+    auto &simulator = getSimulator();
+    const auto circuit =
+        nvqir::makeParameterizedCircuit(numQubits, numGates, gateNames,
+                                        controlOffsets, controls, targets,
+                                        angles, parameterIndices, angleScales);
+
+    std::vector<nvqir::LocalMatrixTerm> terms(numTerms);
+    const double *matrixData = termMatrices;
+    for (std::size_t termIdx = 0; termIdx < numTerms; ++termIdx) {
+      auto &term = terms[termIdx];
+      term.qubits.assign(termQubits + termQubitOffsets[termIdx],
+                         termQubits + termQubitOffsets[termIdx + 1]);
+      if (term.qubits.size() > numQubits)
+        throw std::invalid_argument(fmt::format(
+            "Term {} acts on {} qubits of a {}-qubit state.", termIdx,
+            term.qubits.size(), numQubits));
+      const std::size_t dim = std::size_t{1} << term.qubits.size();
+      term.matrix.resize(dim * dim);
+      for (auto &element : term.matrix) {
+        element = {matrixData[0], matrixData[1]};
+        matrixData += 2;
+      }
+      term.coefficient = {coefficients[2 * termIdx],
+                          coefficients[2 * termIdx + 1]};
+    }
+
+    const auto expVal = simulator.localMatrixExpectation(
+        circuit, terms,
+        std::vector<double>(parameters, parameters + numParameters));
+    expectation[0] = expVal.real();
+    expectation[1] = expVal.imag();
+    return nullptr;
+  } catch (const std::exception &e) {
+    errorMessage = e.what();
+    return errorMessage.c_str();
+  }
+}
+
+/// Correlation matrices of Pauli pairs (consecutive letters in `pairs`, e.g.,
+/// "ZZXX", see `nvqir::CorrelationMatrices`) on the state prepared by a
+/// circuit (same arrays as the gradient entry points). On success, `*result`
+/// owns the matrices until passed to `formotensor_free_correlation_matrices`:
+/// `*twoPoint` points to the (pairs, N, N) correlators and `*onePoint` to the
+/// (kinds, N) one-point correlators of the Paulis written to `kinds`
+/// (null-terminated, at most 3 letters), so that they can be exposed without
+/// copy. Returns null, or the error message.
+extern "C" const char *formotensor_correlation_matrices(
+    std::size_t numQubits, std::size_t numGates, const char *const *gateNames,
+    const std::size_t *controlOffsets, const std::size_t *controls,
+    const std::size_t *targets, const double *angles,
+    const int64_t *parameterIndices, const double *angleScales,
+    const char *pairs, std::size_t numParameters, const double *parameters,
+    void **result, char *kinds, double **onePoint, double **twoPoint) {
+  thread_local std::string errorMessage;
+  try {
+    auto &simulator = getSimulator();
+    const auto circuit =
+        nvqir::makeParameterizedCircuit(numQubits, numGates, gateNames,
+                                        controlOffsets, controls, targets,
+                                        angles, parameterIndices, angleScales);
+    auto matrices = std::make_unique<nvqir::CorrelationMatrices>(
+        simulator.correlationMatrices(
+            circuit, nvqir::parsePauliPairs(pairs),
+            std::vector<double>(parameters, parameters + numParameters)));
+    for (const auto kind : matrices->kinds)
+      *kinds++ = "IXYZ"[static_cast<std::size_t>(kind)];
+    *kinds = '\0';
+    *onePoint = matrices->onePoint.data();
+    *twoPoint = matrices->twoPoint.data();
+    *result = matrices.release();
+    return nullptr;
+  } catch (const std::exception &e) {
+    errorMessage = e.what();
+    return errorMessage.c_str();
+  }
+}
+
+extern "C" void formotensor_free_correlation_matrices(void *result) {
+  delete static_cast<nvqir::CorrelationMatrices *>(result);
+}
+
+extern "C" const char *formotensor_explain(
+    const char *query, std::size_t numQubits, std::size_t numOps,
+    const std::size_t *opQubitOffsets, const std::size_t *opQubits,
+    const int *opAdjoints, std::size_t numQueryQubits,
+    const std::size_t *queryQubits, std::size_t numTerms,
+    const char *const *pauliWords, const double *coefficients, double *flops,
+    double *largestIntermediate, int64_t *workspaceSize, int64_t *numSlices,
+    double *pathFindingSeconds, int *fitsWorkspace) {
+  thread_local std::string errorMessage;
+  try {
+    const std::string_view queryName = query;
+    nvqir::ExplainQueryKind kind;
+    if (queryName == "sample")
+      kind = nvqir::ExplainQueryKind::Sample;
+    else if (queryName == "rdm")
+      kind = nvqir::ExplainQueryKind::ReducedDensityMatrix;
+    else if (queryName == "amplitudes")
+      kind = nvqir::ExplainQueryKind::Amplitudes;
+    else if (queryName == "expectation")
+      kind = nvqir::ExplainQueryKind::Expectation;
+    else
+      throw std::invalid_argument(
+          fmt::format("Unsupported query '{}', expecting 'sample', 'rdm', "
+                      "'amplitudes' or 'expectation'.",
+                      queryName));
+
+    std::vector<nvqir::CircuitOp> ops(numOps);
+    for (std::size_t opIdx = 0; opIdx < numOps; ++opIdx) {
+      ops[opIdx].qubits.assign(opQubits + opQubitOffsets[opIdx],
+                               opQubits + opQubitOffsets[opIdx + 1]);
+      ops[opIdx].isAdjoint = opAdjoints[opIdx] != 0;
+    }
+    std::optional<cudaq::spin_op> observable;
+    if (kind == nvqir::ExplainQueryKind::Expectation)
+      observable =
+          makeObservable(numQubits, numTerms, pauliWords, coefficients);
+
+    const auto estimate = getSimulator().explainCircuit(
+        numQubits, ops, kind,
+        std::vector<std::size_t>(queryQubits, queryQubits + numQueryQubits),
+        observable ? &*observable : nullptr);
+    *flops = estimate.flops;
+    *largestIntermediate = estimate.largestIntermediate.value_or(-1.0);
+    *workspaceSize = estimate.workspaceSize;
+    *numSlices = estimate.numSlices.value_or(-1);
+    *pathFindingSeconds = estimate.pathFindingSeconds;
+    *fitsWorkspace = estimate.fitsWorkspace;
+    return nullptr;
+  } catch (const std::exception &e) {
+    errorMessage = e.what();
+    return errorMessage.c_str();
+  }
+}
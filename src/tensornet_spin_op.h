@@ -9,6 +9,8 @@
 #pragma once
 #include "cudaq/operators.h"
 #include "cutensornet.h"
+#include "local_observable.h"
+#include "pauli_mpo.h"
 
 namespace nvqir {
 
@@ -45,6 +47,70 @@ public:
   /// @brief Destructor
   ~TensorNetworkSpinOp();
 };
+
+/// @brief Utility class converting a `MatrixProductOperator` (of at least 2
+/// sites) to a cutensornetNetworkOperator_t with a single MPO component
+template <typename ScalarType>
+class TensorNetworkMpo {
+  static constexpr cudaDataType_t cudaDataType =
+      std::is_same_v<ScalarType, float> ? CUDA_C_32F : CUDA_C_64F;
+
+  cutensornetHandle_t m_cutnHandle;
+  cutensornetNetworkOperator_t m_cutnNetworkOperator;
+  std::vector<void *> m_tensors_d;
+
+public:
+  /// @brief Constructor from a `MatrixProductOperator` acting on a state of
+  /// `numQubits` qubits
+  TensorNetworkMpo(const MatrixProductOperator &mpo, std::size_t numQubits,
+                   cutensornetHandle_t handle);
+
+  /// @brief Retrieve the cutensornetNetworkOperator_t representation
+  cutensornetNetworkOperator_t getNetworkOperator() {
+    return m_cutnNetworkOperator;
+  }
+
+  /// @brief Destructor
+  ~TensorNetworkMpo();
+};
+
+/// @brief Utility class converting a sum of `LocalMatrixTerm` to
+/// cutensornetNetworkOperator_t, with one single-tensor product per term
+template <typename ScalarType>
+class TensorNetworkLocalOp {
+  static constexpr cudaDataType_t cudaDataType =
+      std::is_same_v<ScalarType, float> ? CUDA_C_32F : CUDA_C_64F;
+
+  cutensornetHandle_t m_cutnHandle;
+  cutensornetNetworkOperator_t m_cutnNetworkOperator;
+  std::complex<double> m_constantOffset = 0.0;
+  std::size_t m_numProducts = 0;
+  // Device tensors, shared by the terms with identical matrices (e.g., the
+  // number operators of different qubits).
+  std::unordered_map<std::string, void *> m_tensors_d;
+
+public:
+  /// @brief Constructor from (validated) terms acting on a state of
+  /// `numQubits` qubits
+  TensorNetworkLocalOp(const std::vector<LocalMatrixTerm> &terms,
+                       std::size_t numQubits, cutensornetHandle_t handle);
+
+  /// @brief Retrieve the cutensornetNetworkOperator_t representation
+  cutensornetNetworkOperator_t getNetworkOperator() {
+    return m_cutnNetworkOperator;
+  }
+
+  /// @brief Number of products of the network operator (the terms acting on
+  /// at least one qubit)
+  std::size_t getNumProducts() const { return m_numProducts; }
+
+  /// @brief Sum of the terms acting on no qubit, which are not part of the
+  /// network operator
+  std::complex<double> getConstantOffset() const { return m_constantOffset; }
+
+  /// @brief Destructor
+  ~TensorNetworkLocalOp();
+};
 } // namespace nvqir
 
 #include "tensornet_spin_op.inc"
@@ -11,8 +11,21 @@
 #include "common/SimulationState.h"
 #include "cudaq/operators.h"
 #include "cutensornet.h"
+#include "execution_control.h"
+#include "path_cache.h"
+#include "path_optimizer.h"
+#include "pauli_grouping.h"
+#include "pauli_mpo.h"
+#include "pauli_propagation.h"
+#include "result_memo.h"
+#include "sample_counts.h"
 #include "tensornet_utils.h"
 #include "timing_utils.h"
+#include "trajectory_precision.h"
+#include "trajectory_sampling.h"
+#include <chrono>
+#include <functional>
+#include <map>
 #include <optional>
 #include <span>
 #include <unordered_map>
@@ -62,6 +75,41 @@ struct AppliedTensorOp {
         noiseChannel(NoiseChannelData(krausOps, probabilities)) {}
 };
 
+/// Kind of a prepared query object that is kept alive across calls.
+enum class CachedQueryKind { None, Sampler, Accessor, Marginal };
+
+/// A prepared query object (sampler, accessor or marginal) together with its
+/// workspace descriptor. The state keeps (at most) one of these bound to its
+/// cache workspace so that repeated identical queries on an unchanged network
+/// reuse both the contraction plan and the cached intermediate tensors.
+struct CachedQuery {
+  CachedQueryKind kind = CachedQueryKind::None;
+  // Measured/projected/marginal modes that the query was prepared for.
+  std::vector<int32_t> modes;
+  cutensornetStateSampler_t sampler = nullptr;
+  cutensornetStateAccessor_t accessor = nullptr;
+  cutensornetStateMarginal_t marginal = nullptr;
+  cutensornetWorkspaceDescriptor_t workDesc = nullptr;
+  // Generation of the scratch buffer bound to the workspace descriptor.
+  uint64_t scratchGeneration = 0;
+
+  bool matches(CachedQueryKind queryKind,
+               const std::vector<int32_t> &queryModes,
+               uint64_t currentScratchGeneration) const {
+    return kind == queryKind && modes == queryModes &&
+           scratchGeneration == currentScratchGeneration;
+  }
+};
+
+/// A tensor network equivalent to the state (with some qubits possibly
+/// projected), for contraction with the low-level network API.
+struct ExportedNetwork {
+  NetworkTopology topology;
+  std::vector<cutensornetTensorQualifiers_t> qualifiers;
+  // Device data of the input tensors.
+  std::vector<const void *> tensorData;
+};
+
 /// @brief Wrapper of cutensornetState_t to provide convenient API's for CUDA-Q
 /// simulator implementation.
 template <typename ScalarType = double>
@@ -81,16 +129,53 @@ protected:
   // Tensor ops that have been applied to the state.
   std::vector<AppliedTensorOp> m_tensorOps;
   ScratchDeviceMem &scratchPad;
+  // Host-backed scratch workspace for queries that do not fit `scratchPad`
+  // (see `attachScratchWorkspace`).
+  ManagedScratchMem m_managedScratch;
   // Random number generator measurement sampling.
   // This is a reference to the backend random number generator, which can be
   // reseeded by users.
   std::mt19937 &m_randomEngine;
   bool m_hasNoiseChannel = false;
+  // Trajectories of the last noisy expectation value in target-precision mode
+  // (see `getTrajectoryPrecision`).
+  std::optional<TrajectoryStatistics> m_trajectoryStatistics;
+  // Cache workspace owned by this state; its content is only valid as long as
+  // the network is unchanged.
+  CacheDeviceMem m_cacheWorkspace;
+  bool m_enableCacheWorkspace = false;
+  // The query object currently bound to the cache workspace.
+  CachedQuery m_cachedQuery;
+  // Indices (into `m_tensorOps`) of the ops that are currently part of the
+  // network, in application order. Used to fingerprint the network for result
+  // memoization.
+  std::vector<std::size_t> m_networkOpIndices;
+  // True if the network contains tensors that are not tracked as ops (e.g.,
+  // initialized from MPS tensors), i.e., it cannot be fingerprinted.
+  bool m_hasOpaqueTensors = false;
+  // MPS finalization settings (if finalized), part of the network fingerprint.
+  std::optional<Fingerprint> m_mpsConfig;
+  // Lazily computed fingerprint of the network.
+  std::optional<Fingerprint> m_networkFingerprint;
+  // Content hashes of op tensors (device pointer -> hash).
+  std::unordered_map<const void *, Fingerprint> m_opContentHashes;
+  // Memoize sampling results (only valid if the random engine was seeded).
+  bool m_memoizeSampling = false;
+  // Device tensors of the computational basis states |0> and |1> (2 elements
+  // each), used as qubit (initial and projection) tensors in exported networks.
+  void *m_basisTensors = nullptr;
+  // Fully expanded controlled op tensors, keyed by (target op tensor, number
+  // of controls).
+  std::map<std::pair<const void *, std::size_t>, void *> m_expandedOpTensors;
+  // Tensor ids of the mutable gates (see `applyMutableGate`), keyed by op
+  // index (into `m_tensorOps`).
+  std::map<std::size_t, std::int64_t> m_mutableOpTensorIds;
+
+  // Path finding budget setting (number of hyper samples) of the contraction
+  // path finder.
+  PathFindingConfig m_pathFindingConfig = getDefaultPathFindingConfig();
 
 public:
-  // The number of hyper samples used in the tensor network contraction path
-  // finder
-  static std::int32_t numHyperSamples;
 
   /// @brief Constructor
   TensorNetState(std::size_t numQubits, ScratchDeviceMem &inScratchPad,
@@ -139,6 +224,31 @@ public:
                  const std::vector<int32_t> &targetQubits, void *gateDeviceMem,
                  bool adjoint = false);
 
+  /// @brief Apply a (non-controlled) unitary gate whose tensor can later be
+  /// swapped with `updateGate`, without rebuilding the network.
+  /// @return Index of the gate op, to be passed to `updateGate`
+  std::size_t applyMutableGate(const std::vector<int32_t> &targetQubits,
+                               void *gateDeviceMem);
+
+  /// @brief Op at index `opIdx` of the ops applied to the state.
+  const AppliedTensorOp &getAppliedOp(std::size_t opIdx) const {
+    return m_tensorOps.at(opIdx);
+  }
+
+  /// @brief Swap the tensor of a gate applied with `applyMutableGate` for
+  /// `gateDeviceMem` (a unitary of the same shape). Prepared expectations on
+  /// this state remain valid and pick up the new tensor on their next compute.
+  void updateGate(std::size_t opIdx, void *gateDeviceMem);
+
+  /// @brief Remove the ops applied after the first `numOps` ones (e.g.,
+  /// temporary gates), rebuilding the network from the remaining ops.
+  /// @return False (and the state unchanged) if the network has tensors that
+  /// are not tracked as ops, i.e., it cannot be rebuilt.
+  bool truncateOps(std::size_t numOps);
+
+  /// @brief Number of ops applied to the state.
+  std::size_t getNumAppliedOps() const { return m_tensorOps.size(); }
+
   /// @brief Apply a unitary channel
   void applyUnitaryChannel(const std::vector<int32_t> &qubits,
                            const std::vector<void *> &krausOps,
@@ -165,10 +275,51 @@ public:
   /// @brief Accessor to the underlying `cutensornetState_t`
   cutensornetState_t getInternalState() { return m_quantumState; }
 
-  /// @brief Perform measurement sampling on the quantum state.
-  std::unordered_map<std::string, size_t>
-  sample(const std::vector<int32_t> &measuredBitIds, int32_t shots,
-         bool enableCacheWorkspace);
+  /// @brief Enable/disable the use of a (persistent) cache workspace for
+  /// samplers, accessors, marginals and expectations on this state.
+  void setCacheWorkspaceEnabled(bool enabled);
+
+  /// @brief Set the path finding budget setting (fixed number of hyper
+  /// samples or adaptive) of queries on this state.
+  void setPathFindingConfig(const PathFindingConfig &config) {
+    m_pathFindingConfig = config;
+  }
+  const PathFindingConfig &getPathFindingConfig() const {
+    return m_pathFindingConfig;
+  }
+
+  /// @brief Path finding budget of a query on a network of `numTensors`
+  /// tensors. Adaptive budgets are logged.
+  PathFindingBudget getPathFindingBudget(std::string_view query,
+                                         std::size_t numTensors) const;
+
+  /// @brief Enable/disable memoization of sampling results.
+  /// Sampling is stochastic, hence this should only be enabled if the random
+  /// engine was seeded by the user. The memoization key includes the state of
+  /// the random engine, so results are identical to a fresh computation.
+  void setSampleMemoizationEnabled(bool enabled) {
+    m_memoizeSampling = enabled;
+  }
+
+  /// @brief Perform measurement sampling on the quantum state. Outcomes are
+  /// packed with bit `i` for `measuredBitIds[i]`. Noisy states are sampled
+  /// per distinct trajectory if possible (see `sampleTrajectories`).
+  PackedSampleCounts
+  sample(const std::vector<int32_t> &measuredBitIds, int32_t shots);
+
+  /// @brief Sample a noisy state once per distinct noise trajectory: the
+  /// Kraus branches of all the shots are drawn on the host (see
+  /// `sampleTrajectoryGroups`), and each distinct trajectory is built as a
+  /// noiseless state, passed to `sampleTrajectory` with the number of shots
+  /// that selected it. None (without sampling) if the state has general
+  /// (non-unitary) channels or initial state tensors, or if the shots do not
+  /// share trajectories enough (see `shouldSampleByTrajectory`): this is
+  /// estimated from the channel probabilities before drawing any branch, and
+  /// the random engine is left untouched on fallback.
+  std::optional<PackedSampleCounts> sampleTrajectories(
+      const std::vector<int32_t> &measuredBitIds, int32_t shots,
+      const std::function<PackedSampleCounts(TensorNetState &, int32_t)>
+          &sampleTrajectory);
 
   /// @brief Contract the tensor network representation to retrieve the state
   /// vector.
@@ -193,16 +344,105 @@ public:
 
   /// @brief Compute the expectation value of an observable
   /// @param product_terms the terms of the observable (operator sum)
-  /// @param numberTrajectories the number of trajectories to use
+  /// @param numberTrajectories the number of trajectories to use (the maximum
+  /// in target-precision mode, see `getTrajectoryPrecision`)
   std::vector<DataType>
   computeExpVals(const std::vector<cudaq::spin_op_term> &product_terms,
                  const std::optional<std::size_t> &numberTrajectories);
 
+  /// @brief Non-identity factors of the terms of an observable (see
+  /// `PauliString`).
+  static std::vector<PauliString>
+  getPauliStrings(const std::vector<cudaq::spin_op_term> &product_terms);
+
+  /// @brief The applied gates copied to the host (controls expanded, adjoints
+  /// applied), for Pauli propagation, or none if the network is not a circuit
+  /// of unitary gates on at most `maxGateQubits` qubits applied to |0...0>
+  /// (noise channels, projectors or initial state tensors).
+  std::optional<std::vector<HostGate>>
+  getHostGates(std::size_t maxGateQubits) const;
+
+  /// @brief Compute the expectation values of the terms of an observable by
+  /// qubit-wise-commuting families (see `groupQubitWiseCommuting`): a single
+  /// reduced density matrix is contracted per family, and all its terms are
+  /// evaluated from it on the host. Ungrouped terms, and all the terms of
+  /// noisy states, are evaluated with `computeExpVals`.
+  std::vector<DataType>
+  computeGroupedExpVals(const std::vector<cudaq::spin_op_term> &product_terms,
+                        const PauliTermGrouping &grouping,
+                        const std::optional<std::size_t> &numberTrajectories);
+
+  /// @brief Compute the expectation values of the terms of an observable by
+  /// support (see `groupBySupport`): the reduced density matrix of each
+  /// distinct support is contracted once, and all the terms within it are
+  /// evaluated from it on the host. Suited to many low-weight terms (e.g.,
+  /// spin models or QAOA cost functions). Ungrouped terms, and all the terms
+  /// of noisy states, are evaluated with `computeExpVals`.
+  std::vector<DataType>
+  computeLocalExpVals(const std::vector<cudaq::spin_op_term> &product_terms,
+                      const PauliSupportGrouping &grouping,
+                      const std::optional<std::size_t> &numberTrajectories);
+
   /// @brief Evaluate the expectation value of a given
   /// `cutensornetNetworkOperator_t`
   DataType computeExpVal(cutensornetNetworkOperator_t tensorNetworkOperator,
                          const std::optional<std::size_t> &numberTrajectories);
 
+  /// @brief Evaluate the expectation value of `tensorNetworkOperator` on
+  /// `numVariants` variants of the state, switched by `setVariant` (e.g., with
+  /// `updateGate`). The expectation is prepared (its contraction path found)
+  /// once, and only computed per variant. Noise channels are not supported.
+  std::vector<DataType>
+  computeExpValVariants(cutensornetNetworkOperator_t tensorNetworkOperator,
+                        std::size_t numVariants,
+                        const std::function<void(std::size_t)> &setVariant);
+
+  /// @brief Expectation value of the observable `mpo` and its gradients with
+  /// respect to the tensors of the gate ops `opIndices` (into the applied ops;
+  /// uncontrolled and not adjoint), by reverse-mode differentiation of the
+  /// double-layer network closed by the MPO (see
+  /// `buildMpoDoubleLayerTopology`): the network is contracted once, keeping
+  /// its intermediates in a cache workspace, and a single backward pass
+  /// yields the environments of all the requested tensors, at about twice the
+  /// cost of the contraction however many there are. All the terms of the
+  /// observable are thus differentiated at once, at a cost that depends on
+  /// the bond dimension of the MPO rather than on the number of terms.
+  ///
+  /// The gradient of a tensor (same layout as its device data) is the
+  /// conjugate of the derivative of the expectation value with respect to the
+  /// tensor in the ket layer; for a Hermitian observable, the bra layer
+  /// contributes the complex conjugate. Not supported with noise channels or
+  /// after MPS finalization.
+  std::pair<DataType, std::vector<std::vector<DataType>>>
+  computeExpValGradients(const MatrixProductOperator &mpo,
+                         const std::vector<std::size_t> &opIndices);
+
+  /// @name Cost estimates (explain)
+  /// Prepare a query (i.e., find its contraction path) without executing it,
+  /// and report the estimated FLOPs, required workspace and path finding time.
+  /// The largest intermediate and the number of slices are only available
+  /// for amplitudes contracted via the exported network, whose explain reads
+  /// the path cache and warm-start paths but records nothing in them.
+  /// @{
+  ContractionEstimate explainSample(const std::vector<int32_t> &measuredBitIds);
+  ContractionEstimate explainRDM(const std::vector<int32_t> &qubits);
+  ContractionEstimate
+  explainAmplitudes(const std::vector<int32_t> &projectedModes);
+  /// Expectation value of `tensorNetworkOperator` (as in `computeExpVal`).
+  ContractionEstimate
+  explainExpectation(cutensornetNetworkOperator_t tensorNetworkOperator);
+  /// Expectation values of `numTerms` Pauli products, evaluated with a single
+  /// expectation prepared for placeholder operators on all qubits (as in
+  /// `computeExpVals`): the path is found once, and contracted per term.
+  ContractionEstimate explainExpVals(std::size_t numTerms);
+  /// Estimated on a copy of the network, since finalizing the MPS cannot be
+  /// undone.
+  ContractionEstimate explainMPSFactorization(
+      int64_t maxExtent, double absCutoff, double relCutoff,
+      cutensornetTensorSVDAlgo_t algo,
+      const std::optional<cutensornetStateMPSGaugeOption_t> &gauge);
+  /// @}
+
   /// @brief Number of qubits that this state represents.
   std::size_t getNumQubits() const { return m_numQubits; }
 
@@ -214,12 +454,29 @@ public:
   static std::vector<std::complex<ScalarType>>
   reverseQubitOrder(std::span<std::complex<ScalarType>> stateVec);
 
-  /// @brief Apply all the cached ops to the state.
+  /// @brief Apply all the cached ops to the state. Mutable gates (see
+  /// `applyMutableGate`) are re-applied as mutable, with their new tensor ids.
   void applyCachedOps();
 
-  /// @brief Set the state to a zero state
+  /// @brief Set the state to a zero state (the cached ops are kept, to be
+  /// re-applied with `applyCachedOps`)
   void setZeroState();
 
+  /// @brief Reset to the zero state of the same width, discarding all applied
+  /// ops, while keeping this object and its workspaces alive. Unlike
+  /// `setZeroState`, the ops are not kept for re-application.
+  void resetToZeroState();
+
+  /// @brief Returns true if noise channels (of any kind) have been applied.
+  bool hasNoiseChannel() const { return m_hasNoiseChannel; }
+
+  /// @brief Trajectories run by the last noisy expectation value
+  /// (`computeExpVals` or `computeExpVal`) and the standard error of its
+  /// total, if it ran in target-precision mode.
+  const std::optional<TrajectoryStatistics> &getTrajectoryStatistics() const {
+    return m_trajectoryStatistics;
+  }
+
   /// @brief Returns true if the state has at least one general channel applied.
   bool hasGeneralChannelApplied() const;
 
@@ -251,11 +508,133 @@ private:
   std::pair<cutensornetStateSampler_t, cutensornetWorkspaceDescriptor_t>
   prepareSample(const std::vector<int32_t> &measuredBitIds);
 
-  std::unordered_map<std::string, size_t>
+  PackedSampleCounts
   executeSample(cutensornetStateSampler_t &sampler,
                 cutensornetWorkspaceDescriptor_t &workspaceDesc,
-                const std::vector<int32_t> &measuredBitIds, int32_t shots,
-                bool enableCacheWorkspace);
+                const std::vector<int32_t> &measuredBitIds, int32_t shots);
+
+  /// Create, configure and prepare an expectation of `tensorNetworkOperator`
+  /// on this state, and attach the scratch workspace to it.
+  std::pair<cutensornetStateExpectation_t, cutensornetWorkspaceDescriptor_t>
+  prepareExpectation(cutensornetNetworkOperator_t tensorNetworkOperator);
+
+  /// Evaluate the `ungrouped` terms of `product_terms` with `computeExpVals`
+  /// into `allExpVals` (indexed like `product_terms`).
+  void
+  computeUngroupedExpVals(const std::vector<cudaq::spin_op_term> &product_terms,
+                          const std::vector<std::size_t> &ungrouped,
+                          const std::optional<std::size_t> &numberTrajectories,
+                          std::vector<DataType> &allExpVals);
+
+  /// Destroy the query object bound to the cache workspace (if any).
+  /// Must be called whenever the network changes.
+  void invalidateCachedQuery();
+
+  /// Attach the state-owned cache workspace to a prepared workspace
+  /// descriptor.
+  /// Note: this may reallocate the cache buffer, hence the cached query must
+  /// have been invalidated beforehand.
+  void attachCacheWorkspace(cutensornetWorkspaceDescriptor_t workDesc);
+
+  /// Record that the op at `opIdx` (in `m_tensorOps`) was appended to the
+  /// network.
+  void recordNetworkOp(std::size_t opIdx);
+
+  /// Fingerprint of the current network (qubits, op tensors and their
+  /// content), or none if result memoization is disabled or the network
+  /// cannot be fingerprinted.
+  std::optional<Fingerprint> getNetworkFingerprint();
+
+  /// Content hash of a device tensor of the given number of elements.
+  Fingerprint getTensorContentHash(const void *deviceData,
+                                   std::size_t numElements);
+
+  /// Export the network as a list of tensors for contraction with the
+  /// low-level network API. The projected qubits are closed with basis state
+  /// tensors and the remaining qubits are the output modes (in increasing
+  /// order). Returns none if the network cannot be exported, e.g., it
+  /// contains noise channels or has been finalized into an MPS.
+  std::optional<ExportedNetwork>
+  exportNetwork(const std::vector<int32_t> &projectedModes,
+                const std::vector<int64_t> &projectedModeValues);
+
+  /// Find the contraction path (optimizer info) of a network, re-using a
+  /// path from the on-disk path cache if available, else seeding it with the
+  /// path of a previous similar network (see `PathWarmStart`), else using the
+  /// host path optimizer if configured (see `getHostPathOptimizerOptions`) or
+  /// cuTensorNet's, and compute the contraction workspace sizes into
+  /// `workDesc`. With `recordPath` false (dry runs, e.g., explain), the path
+  /// is neither stored in the path cache nor recorded for warm starts.
+  cutensornetContractionOptimizerInfo_t
+  findContractionPath(cutensornetNetworkDescriptor_t networkDesc,
+                      const NetworkTopology &topology,
+                      const Fingerprint &topologyKey,
+                      cutensornetWorkspaceDescriptor_t workDesc,
+                      bool recordPath = true);
+
+  /// Number of hyper samples of a query on the state network (or on its
+  /// double-layer network, e.g., for marginals and expectations).
+  int32_t getNumHyperSamples(std::string_view query,
+                             bool doubleLayer = false) const;
+
+  /// Attach a scratch workspace to a prepared query. If the recommended
+  /// workspace size exceeds the scratch space, go down a retry ladder: the
+  /// minimum workspace size, then re-preparing the query (`prepare`) with
+  /// smaller workspace limits (forcing more slicing), then a host-backed
+  /// workspace. Returns the rung that succeeded; throws if none did.
+  WorkspaceRung
+  attachScratchWorkspace(cutensornetWorkspaceDescriptor_t workDesc,
+                         const std::function<void(std::size_t)> &prepare,
+                         std::string_view query);
+
+  /// Find a contraction path with cuTensorNet's optimizer, sliced to fit
+  /// `workspaceLimit` (see `PathFindingBudget` for the hyper samples).
+  cutensornetContractionOptimizerInfo_t
+  runContractionOptimizer(cutensornetNetworkDescriptor_t networkDesc,
+                          const PathFindingBudget &budget,
+                          std::size_t workspaceLimit);
+
+  /// Whether state vector and amplitude contractions go through the exported
+  /// network (see `exportNetwork`), i.e., whether a feature that needs to
+  /// import or inspect contraction paths is enabled.
+  static bool useNetworkContraction();
+
+  /// Record the contraction path of a network (from its optimizer info) to
+  /// warm-start path finding of later similar networks (see
+  /// `PathWarmStart`).
+  void recordWarmStartPath(const NetworkTopology &topology,
+                           cutensornetContractionOptimizerInfo_t optimizerInfo);
+
+  /// Workspace size of a prepared query and the time elapsed since the start
+  /// of its preparation.
+  ContractionEstimate
+  estimateWorkspace(cutensornetWorkspaceDescriptor_t workDesc,
+                    std::chrono::steady_clock::time_point prepareStart);
+
+  /// Create the network descriptor of an exported network and find its
+  /// contraction path (see `findContractionPath`). Paths are cached per
+  /// `query` kind, unless `recordPath` is false.
+  std::pair<cutensornetNetworkDescriptor_t,
+            cutensornetContractionOptimizerInfo_t>
+  prepareNetworkContraction(const ExportedNetwork &network,
+                            cutensornetWorkspaceDescriptor_t workDesc,
+                            std::string_view query = "StateVector",
+                            bool recordPath = true);
+
+  /// Attach a scratch workspace to a prepared network contraction (see
+  /// `attachScratchWorkspace`). Smaller workspace limits re-run cuTensorNet's
+  /// optimizer, updating `optimizerInfo`.
+  void attachNetworkScratchWorkspace(
+      cutensornetWorkspaceDescriptor_t workDesc,
+      cutensornetNetworkDescriptor_t networkDesc,
+      cutensornetContractionOptimizerInfo_t &optimizerInfo,
+      const NetworkTopology &topology, std::string_view query);
+
+  /// Contract the state vector via the exported network (see
+  /// `exportNetwork`). Returns none if the network cannot be exported.
+  std::optional<std::pair<void *, std::size_t>>
+  contractStateVectorNetwork(const std::vector<int32_t> &projectedModes,
+                             const std::vector<int64_t> &projectedModeValues);
 };
 } // namespace nvqir
 
@@ -8,6 +8,8 @@
 
 #include "tensornet_utils.h"
 #include "common/Logger.h"
+#include <algorithm>
+#include <atomic>
 
 std::vector<double> randomValues(uint64_t num_samples, double max_value,
                                  std::mt19937 &randomEngine) {
@@ -44,7 +46,7 @@ ScratchDeviceMem::ScratchDeviceMem() {
   }
 }
 
-// Compute the scratch size to allocate.
+// Compute the upper bound of the scratch size.
 void ScratchDeviceMem::computeScratchSize() {
   // Query the free memory on Device
   std::size_t freeSize{0}, totalSize{0};
@@ -54,27 +56,154 @@ void ScratchDeviceMem::computeScratchSize() {
       freeMemRatio; // use a set proportion available memory with alignment
 }
 
-// Allocate scratch device memory based on available memory
-void ScratchDeviceMem::allocate() {
+void *ScratchDeviceMem::reserve(std::size_t requestedSize) {
+  if (requestedSize > scratchSize)
+    return nullptr;
+  if (d_scratch && requestedSize <= allocatedSize)
+    return d_scratch;
+
+  // Grow geometrically (within the scratch size) so that a sequence of
+  // slightly larger queries does not re-allocate every time.
+  constexpr std::size_t alignment = 4096;
+  std::size_t allocSize = std::max(requestedSize, 2 * allocatedSize);
+  allocSize = (allocSize + alignment - 1) / alignment * alignment;
+  allocSize = std::min(allocSize, scratchSize);
+  release();
+  if (cudaMalloc(&d_scratch, allocSize) != cudaSuccess) {
+    // Other GPU code may have allocated memory in the meantime: fall back to
+    // the requested size.
+    allocSize = requestedSize;
+    if (cudaMalloc(&d_scratch, allocSize) != cudaSuccess) {
+      d_scratch = nullptr;
+      return nullptr;
+    }
+  }
+  allocatedSize = allocSize;
+  ++generation;
+  CUDAQ_INFO("Allocated {} bytes of scratch device memory (limit {} bytes).",
+             allocatedSize, scratchSize);
+  return d_scratch;
+}
+
+void ScratchDeviceMem::release() {
   if (d_scratch)
-    throw std::runtime_error(
-        "Multiple scratch device memory allocations is not allowed.");
-
-  computeScratchSize();
-  // Try allocate device memory
-  auto errCode = cudaMalloc(&d_scratch, scratchSize);
-  if (errCode == cudaErrorMemoryAllocation) {
-    // This indicates race condition whereby other GPU code is allocating
-    // memory while we are calling cudaMemGetInfo.
-    // Attempt to redo the allocation with an updated cudaMemGetInfo data.
-    computeScratchSize();
-    HANDLE_CUDA_ERROR(cudaMalloc(&d_scratch, scratchSize));
-  } else {
-    HANDLE_CUDA_ERROR(errCode);
+    HANDLE_CUDA_ERROR(cudaFree(d_scratch));
+  d_scratch = nullptr;
+  allocatedSize = 0;
+}
+
+CacheDeviceMem::CacheDeviceMem() {
+  if (auto *cacheSizePercent =
+          std::getenv("CUDAQ_TENSORNET_CACHE_SIZE_PERCENTAGE")) {
+    auto envIntVal = atoi(cacheSizePercent);
+    constexpr int minCacheSizePercent = 1;
+    constexpr int maxCacheSizePercent = 95;
+    if (envIntVal < minCacheSizePercent || envIntVal > maxCacheSizePercent)
+      throw std::runtime_error(fmt::format(
+          "Invalid CUDAQ_TENSORNET_CACHE_SIZE_PERCENTAGE environment "
+          "variable setting. Expecting a "
+          "positive integer value between {} and {}, got '{}'.",
+          minCacheSizePercent, maxCacheSizePercent, cacheSizePercent));
+
+    freeMemRatio = static_cast<double>(envIntVal) / 100.0;
+    CUDAQ_INFO("Setting cache size ratio to {}.", freeMemRatio);
+  }
+
+  if (auto *cacheSizeMb = std::getenv("CUDAQ_TENSORNET_CACHE_MAX_SIZE_MB")) {
+    auto envIntVal = atoll(cacheSizeMb);
+    if (envIntVal <= 0)
+      throw std::runtime_error(
+          fmt::format("Invalid CUDAQ_TENSORNET_CACHE_MAX_SIZE_MB environment "
+                      "variable setting. Expecting a positive integer value, "
+                      "got '{}'.",
+                      cacheSizeMb));
+    maxSize = static_cast<std::size_t>(envIntVal) << 20;
+    CUDAQ_INFO("Setting max cache size to {} bytes.", maxSize);
   }
 }
 
-ScratchDeviceMem::~ScratchDeviceMem() {
-  if (scratchSize > 0)
+std::size_t CacheDeviceMem::reserve(std::size_t requestedSize) {
+  if (d_cache && requestedSize <= cacheSize)
+    return requestedSize;
+
+  // Grow: drop the current buffer before querying the free memory.
+  release();
+  std::size_t freeSize{0}, totalSize{0};
+  HANDLE_CUDA_ERROR(cudaMemGetInfo(&freeSize, &totalSize));
+  std::size_t budget = freeSize * freeMemRatio;
+  if (maxSize > 0)
+    budget = std::min(budget, maxSize);
+  budget -= (budget % 4096);
+  const std::size_t allocSize = std::min(requestedSize, budget);
+  if (allocSize == 0)
+    return 0;
+
+  if (cudaMalloc(&d_cache, allocSize) != cudaSuccess) {
+    d_cache = nullptr;
+    return 0;
+  }
+  cacheSize = allocSize;
+  return cacheSize;
+}
+
+void CacheDeviceMem::release() {
+  if (d_cache)
+    HANDLE_CUDA_ERROR(cudaFree(d_cache));
+  d_cache = nullptr;
+  cacheSize = 0;
+}
+
+CacheDeviceMem::~CacheDeviceMem() { release(); }
+
+bool ManagedScratchMem::reserve(std::size_t requestedSize) {
+  if (d_scratch && requestedSize <= scratchSize)
+    return true;
+  release();
+  if (cudaMallocManaged(&d_scratch, requestedSize, cudaMemAttachGlobal) !=
+      cudaSuccess) {
+    d_scratch = nullptr;
+    return false;
+  }
+  scratchSize = requestedSize;
+  return true;
+}
+
+void ManagedScratchMem::release() {
+  if (d_scratch)
     HANDLE_CUDA_ERROR(cudaFree(d_scratch));
+  d_scratch = nullptr;
+  scratchSize = 0;
 }
+
+ManagedScratchMem::~ManagedScratchMem() { release(); }
+
+namespace {
+std::array<std::atomic<std::size_t>, 4> g_workspaceRungCounts{};
+}
+
+const char *toString(WorkspaceRung rung) {
+  switch (rung) {
+  case WorkspaceRung::Recommended:
+    return "recommended";
+  case WorkspaceRung::Minimum:
+    return "minimum";
+  case WorkspaceRung::Resliced:
+    return "resliced";
+  case WorkspaceRung::HostMemory:
+    return "host memory";
+  }
+  return "unknown";
+}
+
+void recordWorkspaceRung(WorkspaceRung rung) {
+  ++g_workspaceRungCounts[static_cast<std::size_t>(rung)];
+}
+
+std::array<std::size_t, 4> getWorkspaceRungCounts() {
+  std::array<std::size_t, 4> counts;
+  for (std::size_t i = 0; i < counts.size(); ++i)
+    counts[i] = g_workspaceRungCounts[i].load();
+  return counts;
+}
+
+ScratchDeviceMem::~ScratchDeviceMem() { release(); }
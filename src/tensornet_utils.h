@@ -8,6 +8,10 @@
 
 #pragma once
 #include "cutensornet.h"
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cmath>
 #include <complex>
 #include <random>
 #include <vector>
@@ -47,17 +51,69 @@ allocateGateMatrix(const std::vector<std::complex<T>> &gateMatHost) {
   return d_gate;
 }
 
+/// @brief Expand a gate matrix (row-major) with a number of leading control
+/// qubits into the full (controlled) gate matrix.
+template <typename T>
+std::vector<std::complex<T>>
+generateFullGateTensor(std::size_t num_control_qubits,
+                       const std::vector<std::complex<T>> &target_gate) {
+  const auto mat_size = target_gate.size();
+  // Must be square matrix (n x n)
+  assert(std::ceil(std::sqrt(mat_size)) == std::floor(std::sqrt(mat_size)) &&
+         "Input matrix is not a square matrix.");
+  // Dim == rows == cols
+  const std::size_t target_gate_dim = std::ceil(std::sqrt(mat_size));
+  // Number of qubits
+  const std::size_t num_target_qubits = std::bit_width(target_gate_dim) - 1;
+  assert(target_gate_dim == (1u << num_target_qubits) &&
+         "Gate matrix dimension is not 2^N");
+  // No control => return the input matrix
+  if (num_control_qubits == 0)
+    return target_gate;
+  // Expand the matrix
+  const std::size_t full_dim =
+      (1UL << (num_control_qubits + num_target_qubits));
+  std::vector<std::complex<T>> gate_tensor(full_dim * full_dim, {0.0, 0.0});
+  std::size_t offset = 0;
+  // Set the diagonal elements:
+  for (int i = 0; i < static_cast<int>(full_dim - target_gate_dim); ++i) {
+    gate_tensor[offset] = {1.0, 0.0};
+    offset += (full_dim + 1);
+  }
+  // Set the target gate matrix:
+  for (std::size_t row = 0; row < target_gate_dim; ++row) {
+    for (std::size_t col = 0; col < target_gate_dim; ++col) {
+      const auto org_idx = row * target_gate_dim + col;
+      // The anchor point of the gate matrix inside the expanded matrix (lower
+      // right, i.e., shift up and left by target_gate_dim)
+      const auto block_anchor = full_dim - target_gate_dim;
+      // Row and column idxs in the expanded matrix
+      const auto block_row_idx = block_anchor + row;
+      const auto block_col_idx = block_anchor + col;
+      const auto expanded_idx = block_row_idx * full_dim + block_col_idx;
+      gate_tensor[expanded_idx] = target_gate[org_idx];
+    }
+  }
+  return gate_tensor;
+}
+
 /// @brief Generate an array of random values in the range (0.0, max)
 std::vector<double> randomValues(uint64_t num_samples, double max_value,
                                  std::mt19937 &randomEngine);
 
 /// @brief Struct to allocate and clean up device memory scratch space.
 struct ScratchDeviceMem {
-  // Device pointer to scratch buffer
+  // Device pointer to scratch buffer (allocated on first use, see `reserve`)
   void *d_scratch = nullptr;
-  // Actual size in bytes
+  // Upper bound in bytes of the scratch buffer, i.e., the workspace limit of
+  // the queries (zero until `computeScratchSize` is called).
   std::size_t scratchSize = 0;
-  // Ratio to current free memory size to allocate the scratch size.
+  // Actual size in bytes of the buffer
+  std::size_t allocatedSize = 0;
+  // Incremented whenever the buffer is re-allocated: workspace descriptors
+  // bound to an older buffer must not be used anymore.
+  uint64_t generation = 0;
+  // Ratio to current free memory size that bounds the scratch size.
   // Note: the actual allocation size may slightly be different due to alignment
   // consideration.
   // The default ratio if not otherwise specified.
@@ -65,15 +121,105 @@ struct ScratchDeviceMem {
   double freeMemRatio = defaultFreeMemRatio;
 
   ScratchDeviceMem();
-  // Compute the scratch size to allocate.
+  ScratchDeviceMem(const ScratchDeviceMem &) = delete;
+  ScratchDeviceMem &operator=(const ScratchDeviceMem &) = delete;
+
+  // Compute the upper bound of the scratch size from the free memory on the
+  // (selected) device.
   void computeScratchSize();
 
-  // Allocate scratch device memory based on available memory
-  void allocate();
+  // Device buffer of at least `requestedSize` bytes (within the scratch size),
+  // growing the buffer if needed. Returns null if it could not be allocated.
+  // Note: growing invalidates the workspace descriptors referencing the
+  // previous buffer.
+  void *reserve(std::size_t requestedSize);
+
+  // Free the buffer.
+  void release();
 
   ~ScratchDeviceMem();
 };
 
+/// @brief Struct to allocate and clean up a persistent device memory buffer
+/// used as the cuTensorNet cache workspace, i.e., for intermediate tensors that
+/// can be reused across repeated compute calls on an unchanged network.
+struct CacheDeviceMem {
+  // Device pointer to cache buffer
+  void *d_cache = nullptr;
+  // Actual size in bytes
+  std::size_t cacheSize = 0;
+  // Ratio to current free memory size that bounds the cache size.
+  static inline constexpr double defaultFreeMemRatio = 0.5;
+  double freeMemRatio = defaultFreeMemRatio;
+  // Optional hard upper bound (in bytes) on the cache size (0 == unbounded).
+  std::size_t maxSize = 0;
+
+  CacheDeviceMem();
+  CacheDeviceMem(const CacheDeviceMem &) = delete;
+  CacheDeviceMem &operator=(const CacheDeviceMem &) = delete;
+
+  // Make sure that the buffer can hold the requested size, (re-)allocating it
+  // within the budget if needed. Returns the usable cache size in bytes, which
+  // may be less than requested or zero if no memory could be allocated.
+  // Note: any workspace descriptor referencing the previous buffer must be
+  // destroyed before calling this.
+  std::size_t reserve(std::size_t requestedSize);
+
+  // Free the buffer.
+  void release();
+
+  ~CacheDeviceMem();
+};
+
+/// @brief Struct to allocate and clean up a host-backed (CUDA managed memory)
+/// scratch workspace, used as a last resort for queries whose workspace does
+/// not fit the device scratch space. Pages migrate between host and device on
+/// demand, hence much slower than device memory.
+struct ManagedScratchMem {
+  // Managed pointer to the scratch buffer
+  void *d_scratch = nullptr;
+  // Actual size in bytes
+  std::size_t scratchSize = 0;
+
+  ManagedScratchMem() = default;
+  ManagedScratchMem(const ManagedScratchMem &) = delete;
+  ManagedScratchMem &operator=(const ManagedScratchMem &) = delete;
+
+  // Make sure that the buffer can hold the requested size, (re-)allocating it
+  // if needed. Returns false if the allocation failed.
+  // Note: any workspace descriptor referencing the previous buffer must be
+  // destroyed before calling this.
+  bool reserve(std::size_t requestedSize);
+
+  // Free the buffer.
+  void release();
+
+  ~ManagedScratchMem();
+};
+
+/// @brief Rungs of the workspace retry ladder, i.e., how the scratch workspace
+/// of a query that did not fit the scratch space was obtained.
+enum class WorkspaceRung {
+  // Recommended workspace size (no retry needed).
+  Recommended,
+  // Minimum workspace size.
+  Minimum,
+  // Re-prepared with a smaller workspace limit (more slicing).
+  Resliced,
+  // Host-backed (managed memory) workspace.
+  HostMemory,
+};
+
+const char *toString(WorkspaceRung rung);
+
+/// @brief Count (process-wide) a query whose workspace was obtained at the
+/// given rung of the retry ladder.
+void recordWorkspaceRung(WorkspaceRung rung);
+
+/// @brief Number of queries per rung of the retry ladder, indexed by
+/// `WorkspaceRung`.
+std::array<std::size_t, 4> getWorkspaceRungCounts();
+
 /// Initialize `cutensornet` MPI Comm
 /// If MPI is not available, fallback to an empty implementation.
 void initCuTensornetComm(cutensornetHandle_t cutnHandle);
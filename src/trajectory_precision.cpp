@@ -0,0 +1,76 @@
+/*******************************************************************************
+ * Copyright (c) 2022 - 2025 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#include "trajectory_precision.h"
+#include "common/Logger.h"
+#include <cstdlib>
+#include <stdexcept>
+
+namespace nvqir {
+namespace {
+// Positive integer setting `name`, or `defaultValue` if unset.
+std::size_t getCountSetting(const char *name, std::size_t defaultValue,
+                            std::size_t minValue) {
+  auto *envVal = std::getenv(name);
+  if (!envVal)
+    return defaultValue;
+  char *end = nullptr;
+  const long value = std::strtol(envVal, &end, 10);
+  if (end == envVal || *end != '\0' || value < static_cast<long>(minValue))
+    throw std::runtime_error(
+        fmt::format("Invalid {} environment variable setting. Expecting an "
+                    "integer of at least {}, got '{}'.",
+                    name, minValue, envVal));
+  return value;
+}
+} // namespace
+
+void RunningStatistics::add(double value) {
+  ++m_count;
+  const double delta = value - m_mean;
+  m_mean += delta / static_cast<double>(m_count);
+  m_sumSquares += delta * (value - m_mean);
+}
+
+double RunningStatistics::variance() const {
+  return m_count < 2 ? 0.0 : m_sumSquares / static_cast<double>(m_count - 1);
+}
+
+double RunningStatistics::squaredStandardError() const {
+  return m_count == 0 ? 0.0 : variance() / static_cast<double>(m_count);
+}
+
+const std::optional<TrajectoryPrecision> &getTrajectoryPrecision() {
+  static const std::optional<TrajectoryPrecision> precision =
+      []() -> std::optional<TrajectoryPrecision> {
+    auto *envVal = std::getenv("CUDAQ_TENSORNET_OBSERVE_TARGET_ERROR");
+    if (!envVal)
+      return std::nullopt;
+    char *end = nullptr;
+    TrajectoryPrecision precision;
+    precision.targetError = std::strtod(envVal, &end);
+    if (end == envVal || *end != '\0' || !(precision.targetError > 0.0))
+      throw std::runtime_error(fmt::format(
+          "Invalid CUDAQ_TENSORNET_OBSERVE_TARGET_ERROR environment variable "
+          "setting. Expecting a positive standard error, got '{}'.",
+          envVal));
+    precision.minTrajectories =
+        getCountSetting("CUDAQ_TENSORNET_OBSERVE_MIN_TRAJECTORIES",
+                        precision.minTrajectories, 2);
+    precision.batchSize =
+        getCountSetting("CUDAQ_TENSORNET_OBSERVE_TRAJECTORY_BATCH",
+                        precision.batchSize, 1);
+    CUDAQ_INFO("Running noisy expectation values to a standard error of {} "
+               "(at least {} trajectories, checked every {}).",
+               precision.targetError, precision.minTrajectories,
+               precision.batchSize);
+    return precision;
+  }();
+  return precision;
+}
+} // namespace nvqir
@@ -0,0 +1,80 @@
+/****************************************************************-*- C++ -*-****
+ * Copyright (c) 2022 - 2025 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <optional>
+
+namespace nvqir {
+
+/// @brief Running mean and variance of a sequence of samples (Welford's
+/// algorithm), e.g., of the expectation values of noise trajectories.
+class RunningStatistics {
+public:
+  void add(double value);
+
+  std::size_t count() const { return m_count; }
+  double mean() const { return m_mean; }
+  /// @brief Unbiased sample variance (zero below two samples).
+  double variance() const;
+  /// @brief Squared standard error of the mean, `variance() / count()`.
+  double squaredStandardError() const;
+
+private:
+  std::size_t m_count = 0;
+  double m_mean = 0.0;
+  // Sum of the squared deviations from the mean.
+  double m_sumSquares = 0.0;
+};
+
+/// @brief Target precision of noisy expectation values: trajectories run in
+/// batches until the standard error of the total is at most `targetError`.
+/// The requested number of trajectories (`numberTrajectories`, else the
+/// default of the backend) is the maximum.
+struct TrajectoryPrecision {
+  double targetError = 0.0;
+  // Trajectories run before the standard error is first checked (at least
+  // two, so that it is estimated from a sample variance).
+  std::size_t minTrajectories = 32;
+  // The standard error is checked every `batchSize` trajectories.
+  std::size_t batchSize = 32;
+
+  /// @brief True if the standard error should be checked after
+  /// `numTrajectories` trajectories, i.e., at the end of a batch past the
+  /// minimum.
+  bool shouldCheck(std::size_t numTrajectories) const {
+    return numTrajectories >= minTrajectories &&
+           numTrajectories % batchSize == 0;
+  }
+};
+
+/// @brief Target precision of the noisy expectation values of the process, if
+/// any (otherwise, they run the requested number of trajectories).
+///
+/// `CUDAQ_TENSORNET_OBSERVE_TARGET_ERROR` sets the target standard error,
+/// `CUDAQ_TENSORNET_OBSERVE_MIN_TRAJECTORIES` and
+/// `CUDAQ_TENSORNET_OBSERVE_TRAJECTORY_BATCH` the minimum number of
+/// trajectories and the batch size.
+const std::optional<TrajectoryPrecision> &getTrajectoryPrecision();
+
+/// @brief Trajectories run by a noisy expectation value in target-precision
+/// mode, and the standard error of its total.
+struct TrajectoryStatistics {
+  // Trajectories per term (the fewest, if the query stopped early).
+  std::size_t numTrajectories = 0;
+  double standardError = 0.0;
+};
+
+/// @brief Register of the observe results holding the `TrajectoryStatistics`
+/// in target-precision mode: its expectation value is the standard error of
+/// the total, and its counts hold the number of trajectories (key
+/// `trajectories`).
+inline constexpr const char *g_trajectoryStatisticsRegister =
+    "__trajectories__";
+} // namespace nvqir
@@ -0,0 +1,107 @@
+/*******************************************************************************
+ * Copyright (c) 2022 - 2025 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#include "trajectory_sampling.h"
+#include "common/Logger.h"
+#include <algorithm>
+#include <map>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+
+namespace nvqir {
+namespace {
+// Trajectories must be shared by that many shots on average to be sampled
+// one network per trajectory.
+constexpr std::size_t minShotsPerTrajectory = 2;
+} // namespace
+
+std::vector<TrajectoryGroup> sampleTrajectoryGroups(
+    const std::vector<std::vector<double>> &channelProbabilities,
+    std::size_t numShots, std::mt19937 &randomEngine) {
+  const std::size_t numChannels = channelProbabilities.size();
+  // Most likely branch of each channel, and the (channel, branch) deviations
+  // from them of each shot, by increasing channel.
+  std::vector<uint32_t> likelyBranches(numChannels, 0);
+  std::vector<std::vector<std::pair<uint32_t, uint32_t>>> deviations(
+      numShots);
+  for (std::size_t c = 0; c < numChannels; ++c) {
+    const auto &probabilities = channelProbabilities[c];
+    if (probabilities.empty())
+      throw std::invalid_argument(
+          fmt::format("Noise channel {} has no Kraus operators.", c));
+    const double total =
+        std::accumulate(probabilities.begin(), probabilities.end(), 0.0);
+    if (!(total > 0.0) ||
+        std::any_of(probabilities.begin(), probabilities.end(),
+                    [](double p) { return !(p >= 0.0); }))
+      throw std::invalid_argument(fmt::format(
+          "Noise channel {} has invalid Kraus probabilities.", c));
+    const auto likely =
+        std::max_element(probabilities.begin(), probabilities.end());
+    likelyBranches[c] = likely - probabilities.begin();
+    const double deviationProbability = 1.0 - *likely / total;
+    if (!(deviationProbability > 0.0) || numShots == 0)
+      continue;
+
+    // The other branches, given a deviation.
+    std::vector<double> otherProbabilities(probabilities);
+    otherProbabilities[likelyBranches[c]] = 0.0;
+    std::discrete_distribution<uint32_t> otherBranch(
+        otherProbabilities.begin(), otherProbabilities.end());
+    // Shots between two deviations (failures before a success).
+    std::geometric_distribution<std::size_t> gap(deviationProbability);
+    for (std::size_t shot = gap(randomEngine); shot < numShots;) {
+      deviations[shot].emplace_back(c, otherBranch(randomEngine));
+      const std::size_t skip = gap(randomEngine);
+      if (skip >= numShots - shot - 1)
+        break;
+      shot += skip + 1;
+    }
+  }
+
+  std::map<std::vector<std::pair<uint32_t, uint32_t>>, std::size_t> counts;
+  for (auto &shotDeviations : deviations)
+    ++counts[std::move(shotDeviations)];
+  std::vector<TrajectoryGroup> groups;
+  groups.reserve(counts.size());
+  for (const auto &[groupDeviations, count] : counts) {
+    auto &group = groups.emplace_back();
+    group.branches = likelyBranches;
+    for (const auto &[channel, branch] : groupDeviations)
+      group.branches[channel] = branch;
+    group.numShots = count;
+  }
+  return groups;
+}
+
+double estimateNumTrajectoryGroups(
+    const std::vector<std::vector<double>> &channelProbabilities,
+    std::size_t numShots) {
+  double noDeviationProbability = 1.0;
+  double numTrajectories = 1.0;
+  for (const auto &probabilities : channelProbabilities) {
+    const double total =
+        std::accumulate(probabilities.begin(), probabilities.end(), 0.0);
+    const auto likely =
+        std::max_element(probabilities.begin(), probabilities.end());
+    if (likely != probabilities.end())
+      noDeviationProbability *= *likely / total;
+    numTrajectories *= std::count_if(probabilities.begin(), probabilities.end(),
+                                     [](double p) { return p > 0.0; });
+  }
+  const double numDeviatingShots =
+      static_cast<double>(numShots) * (1.0 - noDeviationProbability);
+  return std::min({1.0 + numDeviatingShots, numTrajectories,
+                   static_cast<double>(numShots)});
+}
+
+bool shouldSampleByTrajectory(double numGroups, std::size_t numShots) {
+  return numGroups * minShotsPerTrajectory <= numShots;
+}
+} // namespace nvqir
@@ -0,0 +1,53 @@
+/****************************************************************-*- C++ -*-****
+ * Copyright (c) 2022 - 2025 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace nvqir {
+
+/// @brief Noise trajectory shared by a group of shots: `branches[c]` is the
+/// index of the Kraus operator selected for the `c`-th unitary noise channel
+/// of the circuit.
+struct TrajectoryGroup {
+  std::vector<uint32_t> branches;
+  std::size_t numShots = 0;
+};
+
+/// @brief Select the Kraus branches of `numShots` independent trajectories of
+/// unitary noise channels (`channelProbabilities[c]` are the probabilities of
+/// the Kraus operators of channel `c`), and group the shots by trajectory.
+///
+/// Each channel selects its most likely branch in most shots (at low error
+/// rates), so that only the shots deviating from it are drawn, with geometric
+/// jumps: the cost is linear in the number of channels and of deviations
+/// rather than in their product. Groups are ordered by their deviations, the
+/// trajectory of the most likely branches first.
+std::vector<TrajectoryGroup> sampleTrajectoryGroups(
+    const std::vector<std::vector<double>> &channelProbabilities,
+    std::size_t numShots, std::mt19937 &randomEngine);
+
+/// @brief Expected number of distinct trajectories of `numShots` shots (an
+/// upper estimate, without drawing them): the shots taking the most likely
+/// branch of every channel share a trajectory, and the others are counted as
+/// distinct, up to the number of possible trajectories.
+double estimateNumTrajectoryGroups(
+    const std::vector<std::vector<double>> &channelProbabilities,
+    std::size_t numShots);
+
+/// @brief True if sampling `numShots` shots by `numGroups` (possibly an
+/// estimate) distinct trajectories (one network per trajectory) is worth it
+/// over one trajectory per shot (a single network, with the branches drawn by
+/// the sampler), i.e., if the trajectories are shared by at least two shots on
+/// average.
+bool shouldSampleByTrajectory(double numGroups, std::size_t numShots);
+} // namespace nvqir
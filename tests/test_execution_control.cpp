@@ -0,0 +1,156 @@
+/*******************************************************************************
+ * Copyright (c) 2022 - 2025 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#include "execution_control.h"
+#include "test_utils.h"
+#include <thread>
+
+using namespace nvqir;
+
+namespace {
+void testBatchSizes() {
+  ExecutionControl control;
+  // Without a control: everything at once.
+  TEST_CHECK(getShotBatchSize(1000, nullptr) == 1000);
+  TEST_CHECK(getShotBatchSize(0, nullptr) == 1);
+  TEST_CHECK(getSliceGroupSize(100, nullptr) == 100);
+  TEST_CHECK(getSliceGroupSize(0, nullptr) == 1);
+  // With a control: up to 16 shot batches and 32 slice groups.
+  TEST_CHECK(getShotBatchSize(1000, &control) == 63);
+  TEST_CHECK(getShotBatchSize(16, &control) == 1);
+  TEST_CHECK(getShotBatchSize(5, &control) == 1);
+  TEST_CHECK(getShotBatchSize(0, &control) == 1);
+  TEST_CHECK(getSliceGroupSize(100, &control) == 4);
+  TEST_CHECK(getSliceGroupSize(64, &control) == 2);
+  TEST_CHECK(getSliceGroupSize(1, &control) == 1);
+  for (const std::size_t shots : {1, 15, 17, 1000, 12345}) {
+    const auto batchSize = getShotBatchSize(shots, &control);
+    TEST_CHECK((shots + batchSize - 1) / batchSize <= 16);
+  }
+}
+
+void testStopRequests() {
+  TEST_CHECK(!stopRequested(nullptr));
+
+  ExecutionControl control;
+  TEST_CHECK(!control.getDeadline());
+  TEST_CHECK(!control.shouldStop());
+  TEST_CHECK(!stopRequested(&control));
+  TEST_CHECK(!control.isPartial());
+
+  control.cancel();
+  TEST_CHECK(control.isCancelled() && control.shouldStop());
+  TEST_CHECK(stopRequested(&control));
+  TEST_CHECK(control.isPartial());
+
+  // Deadlines in the future and in the past.
+  ExecutionControl timed(3600.0);
+  TEST_CHECK(timed.getDeadline());
+  TEST_CHECK(!stopRequested(&timed));
+  timed.setDeadline(ExecutionControl::Clock::now() - std::chrono::seconds(1));
+  TEST_CHECK(stopRequested(&timed));
+  TEST_CHECK(timed.isPartial() && !timed.isCancelled());
+  timed.clearDeadline();
+  TEST_CHECK(!timed.getDeadline() && !timed.shouldStop());
+
+  ExecutionControl expiring(0.01);
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  TEST_CHECK(expiring.shouldStop());
+  // A negative timeout is already past.
+  TEST_CHECK(ExecutionControl(-1.0).shouldStop());
+}
+
+void testReset() {
+  ExecutionControl control;
+  control.setDeadline(ExecutionControl::Clock::now() - std::chrono::seconds(1));
+  const auto deadline = control.getDeadline();
+  control.cancel();
+  control.addSlices(3);
+  control.addTrajectories(2);
+  control.addShots(100);
+  TEST_CHECK(stopRequested(&control));
+
+  // The deadline is kept, the rest is cleared.
+  control.reset();
+  TEST_CHECK(control.getDeadline() == deadline);
+  TEST_CHECK(!control.isCancelled() && !control.isPartial());
+  const auto progress = control.getProgress();
+  TEST_CHECK(progress.slicesDone == 0 && progress.trajectoriesDone == 0 &&
+             progress.shotsDone == 0);
+  TEST_CHECK(control.shouldStop());
+}
+
+void testNestedQueries() {
+  TEST_CHECK(!ExecutionControl::current());
+  // Without an installed control, the query is unbounded unless the process
+  // has a default time limit.
+  if (!getDefaultQueryTimeLimit()) {
+    QueryExecutionControl query;
+    TEST_CHECK(!query.get());
+    TEST_CHECK(!query.getPartialProgress());
+  }
+
+  ExecutionControl control;
+  control.addShots(7);
+  {
+    ScopedExecutionControl scope(control);
+    TEST_CHECK(ExecutionControl::current() == &control);
+    QueryExecutionControl outer;
+    TEST_CHECK(outer.get() == &control);
+    control.addTrajectories(1);
+    {
+      // E.g., the sampling of one measurement basis of an observe.
+      QueryExecutionControl inner;
+      TEST_CHECK(inner.get() == &control);
+      control.addShots(10);
+      control.addSlices(2);
+      TEST_CHECK(!inner.getPartialProgress());
+      control.cancel();
+      TEST_CHECK(stopRequested(inner.get()));
+      // Progress made during the inner query only.
+      const auto progress = inner.getPartialProgress();
+      TEST_CHECK(progress);
+      TEST_CHECK(progress->shotsDone == 10);
+      TEST_CHECK(progress->slicesDone == 2);
+      TEST_CHECK(progress->trajectoriesDone == 0);
+    }
+    // Progress made during the outer query, not before it.
+    const auto progress = outer.getPartialProgress();
+    TEST_CHECK(progress);
+    TEST_CHECK(progress->shotsDone == 10);
+    TEST_CHECK(progress->slicesDone == 2);
+    TEST_CHECK(progress->trajectoriesDone == 1);
+
+    // A query started on an already partial control is not reported as
+    // stopped by it.
+    QueryExecutionControl later;
+    TEST_CHECK(!later.getPartialProgress());
+  }
+  TEST_CHECK(!ExecutionControl::current());
+
+  // Scopes restore the previously installed control.
+  ExecutionControl other;
+  {
+    ScopedExecutionControl scope(control);
+    {
+      ScopedExecutionControl nested(other);
+      TEST_CHECK(ExecutionControl::current() == &other);
+    }
+    TEST_CHECK(ExecutionControl::current() == &control);
+  }
+  TEST_CHECK(!ExecutionControl::current());
+}
+} // namespace
+
+int main() {
+  testBatchSizes();
+  testStopRequests();
+  testReset();
+  testNestedQueries();
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,130 @@
+/*******************************************************************************
+ * Copyright (c) 2022 - 2025 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#include "path_cache.h"
+#include "test_utils.h"
+#include <fstream>
+#include <random>
+#include <string>
+
+using namespace nvqir;
+
+namespace {
+// Two single-qubit tensors and a two-qubit gate, with the given mode labels.
+NetworkTopology makeTopology(int32_t a, int32_t b, int32_t c, int32_t d) {
+  return NetworkTopology{
+      {{a}, {b}, {a, b, c, d}}, {{2}, {2}, {2, 2, 2, 2}}, {c, d}};
+}
+
+std::filesystem::path makeCacheDirectory() {
+  const auto directory =
+      std::filesystem::temp_directory_path() /
+      ("formotensor_path_cache_test_" + std::to_string(std::random_device()()));
+  std::filesystem::remove_all(directory);
+  return directory;
+}
+
+void testTopologyKey() {
+  const auto topology = makeTopology(0, 1, 2, 3);
+  // Only the connectivity and extents matter, not the mode labels.
+  TEST_CHECK(computeTopologyKey(topology, "StateVector") ==
+             computeTopologyKey(makeTopology(10, 11, 12, 13), "StateVector"));
+  // The gate is applied with its qubits swapped.
+  auto swapped = topology;
+  swapped.inputModes[2] = {1, 0, 2, 3};
+  TEST_CHECK(computeTopologyKey(topology, "StateVector") !=
+             computeTopologyKey(swapped, "StateVector"));
+  TEST_CHECK(computeTopologyKey(topology, "StateVector") !=
+             computeTopologyKey(topology, "RDM"));
+  auto wider = topology;
+  wider.inputExtents[2] = {2, 2, 2, 4};
+  TEST_CHECK(computeTopologyKey(topology, "StateVector") !=
+             computeTopologyKey(wider, "StateVector"));
+}
+
+void testEntryFormat() {
+  const auto key = computeTopologyKey(makeTopology(0, 1, 2, 3), "StateVector");
+  const auto otherKey = computeTopologyKey(makeTopology(0, 1, 2, 3), "RDM");
+  const std::vector<char> payload{1, 2, 3, 4, 5};
+  const auto entry = PathCache::encodeEntry(key, payload);
+  TEST_CHECK(entry.size() > payload.size());
+  const auto decoded = PathCache::decodeEntry(key, entry);
+  TEST_CHECK(decoded && *decoded == payload);
+  // Entries of another key, truncated or with a corrupted payload are
+  // rejected.
+  TEST_CHECK(!PathCache::decodeEntry(otherKey, entry));
+  TEST_CHECK(!PathCache::decodeEntry(
+      key, std::vector<char>(entry.begin(), entry.end() - 1)));
+  auto corrupted = entry;
+  corrupted.back() ^= 1;
+  TEST_CHECK(!PathCache::decodeEntry(key, corrupted));
+  TEST_CHECK(PathCache::decodeEntry(key, PathCache::encodeEntry(key, {})));
+
+  PathCache cache(makeCacheDirectory());
+  const auto entryPath = cache.getEntryPath(key);
+  char fileName[64];
+  std::snprintf(fileName, sizeof(fileName), "%016llx%016llx.v%u.path",
+                static_cast<unsigned long long>(key.hi),
+                static_cast<unsigned long long>(key.lo),
+                static_cast<unsigned>(PathCache::formatVersion));
+  TEST_CHECK(entryPath.filename().string() == fileName);
+  std::filesystem::remove_all(entryPath.parent_path());
+}
+
+void testHitsAndMisses() {
+  const auto directory = makeCacheDirectory();
+  PathCache cache(directory);
+  TEST_CHECK(cache.isEnabled());
+  const auto key = computeTopologyKey(makeTopology(0, 1, 2, 3), "StateVector");
+  const std::vector<char> payload{1, 2, 3, 4, 5};
+
+  TEST_CHECK(!cache.load(key));
+  TEST_CHECK(cache.store(key, payload));
+  const auto loaded = cache.load(key);
+  TEST_CHECK(loaded && *loaded == payload);
+
+  // Another cache on the same directory (e.g., another process) sees the
+  // entry.
+  PathCache sharedCache(directory);
+  TEST_CHECK(sharedCache.load(key) == payload);
+
+  // A corrupted entry is a miss.
+  {
+    std::fstream file(cache.getEntryPath(key),
+                      std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(-1, std::ios::end);
+    file.put(9);
+  }
+  TEST_CHECK(!cache.load(key));
+
+  const auto stats = cache.getStats();
+  TEST_CHECK(stats.hits == 1);
+  TEST_CHECK(stats.misses == 2);
+  TEST_CHECK(stats.invalid == 1);
+  TEST_CHECK(stats.stores == 1);
+
+  // Storing again replaces the entry.
+  TEST_CHECK(cache.store(key, payload));
+  TEST_CHECK(cache.load(key) == payload);
+  std::filesystem::remove_all(directory);
+
+  // A disabled cache neither stores nor loads.
+  PathCache disabled;
+  TEST_CHECK(!disabled.isEnabled());
+  TEST_CHECK(!disabled.store(key, payload));
+  TEST_CHECK(!disabled.load(key));
+  TEST_CHECK(disabled.getStats().misses == 0);
+}
+} // namespace
+
+int main() {
+  testTopologyKey();
+  testEntryFormat();
+  testHitsAndMisses();
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,211 @@
+/*******************************************************************************
+ * Copyright (c) 2022 - 2025 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#include "path_optimizer.h"
+#include "test_utils.h"
+#include <limits>
+#include <map>
+#include <random>
+
+using namespace nvqir;
+
+namespace {
+// Random circuit network of single- and two-qubit gates.
+NetworkTopology makeRandomCircuit(std::size_t numQubits, std::size_t numGates,
+                                  unsigned seed) {
+  std::mt19937 engine(seed);
+  std::vector<CircuitOp> ops;
+  for (std::size_t i = 0; i < numGates; ++i) {
+    const int32_t first = engine() % numQubits;
+    const int32_t second = engine() % numQubits;
+    if (first == second)
+      ops.push_back({{first}, false});
+    else
+      ops.push_back({{first, second}, engine() % 2 == 0});
+  }
+  return buildCircuitTopology(numQubits, ops, {});
+}
+
+// Minimum cost over all the pairwise contraction orders of the remaining
+// tensors (in SSA numbering), extending `ssaPath`.
+double bruteForceFlops(const NetworkTopology &topology,
+                       std::vector<int32_t> &remaining,
+                       std::vector<std::pair<int32_t, int32_t>> &ssaPath) {
+  if (remaining.size() == 1)
+    return evaluateContractionPath(topology, ssaPath).flops;
+  const int32_t result = topology.inputModes.size() + ssaPath.size();
+  double best = std::numeric_limits<double>::infinity();
+  for (std::size_t i = 0; i < remaining.size(); ++i)
+    for (std::size_t j = i + 1; j < remaining.size(); ++j) {
+      auto next = remaining;
+      next.erase(next.begin() + j);
+      next.erase(next.begin() + i);
+      next.push_back(result);
+      ssaPath.emplace_back(remaining[i], remaining[j]);
+      best = std::min(best, bruteForceFlops(topology, next, ssaPath));
+      ssaPath.pop_back();
+    }
+  return best;
+}
+
+double bruteForceFlops(const NetworkTopology &topology) {
+  std::vector<int32_t> remaining(topology.inputModes.size());
+  for (std::size_t i = 0; i < remaining.size(); ++i)
+    remaining[i] = i;
+  std::vector<std::pair<int32_t, int32_t>> ssaPath;
+  return bruteForceFlops(topology, remaining, ssaPath);
+}
+
+// The tree is a valid contraction of all the tensors, with its cost.
+void checkTree(const NetworkTopology &topology, const ContractionTree &tree) {
+  const std::size_t numInputs = topology.inputModes.size();
+  TEST_CHECK(tree.ssaPath.size() == numInputs - 1);
+  std::vector<bool> used(2 * numInputs - 1, false);
+  for (std::size_t i = 0; i < tree.ssaPath.size(); ++i)
+    for (const int32_t operand :
+         {tree.ssaPath[i].first, tree.ssaPath[i].second}) {
+      TEST_CHECK(operand >= 0 &&
+                 operand < static_cast<int32_t>(numInputs + i));
+      TEST_CHECK(!used[operand]);
+      used[operand] = true;
+    }
+  const auto evaluated = evaluateContractionPath(topology, tree.ssaPath);
+  TEST_CHECK(evaluated.flops == tree.flops);
+  TEST_CHECK(evaluated.peakMemory == tree.peakMemory);
+  TEST_CHECK(evaluated.largestIntermediate == tree.largestIntermediate);
+  TEST_CHECK(linearToSsaPath(numInputs, tree.toLinearPath()) == tree.ssaPath);
+}
+
+void testAgainstBruteForce() {
+  for (unsigned seed = 0; seed < 8; ++seed) {
+    // 3 qubit tensors and 3 gates: 2700 contraction orders.
+    const auto topology = makeRandomCircuit(3, 3, seed);
+    const double optimum = bruteForceFlops(topology);
+
+    PathOptimizerOptions options;
+    options.kind = PathOptimizerKind::Optimal;
+    const auto optimal = optimizeContractionPath(topology, options);
+    checkTree(topology, optimal);
+    TEST_CHECK_NEAR(optimal.flops, optimum, 1e-9 * optimum);
+
+    for (const auto kind :
+         {PathOptimizerKind::Greedy, PathOptimizerKind::Bisection,
+          PathOptimizerKind::RandomGreedy}) {
+      options.kind = kind;
+      options.timeBudgetSeconds = 0.05;
+      options.bisectionLeafSize = 3;
+      const auto tree = optimizeContractionPath(topology, options);
+      checkTree(topology, tree);
+      TEST_CHECK(tree.flops >= optimum * (1.0 - 1e-12));
+    }
+  }
+}
+
+void testRandomGreedyImprovesOnGreedy() {
+  const auto topology = makeRandomCircuit(8, 40, 1);
+  PathOptimizerOptions options;
+  const auto greedy = optimizeContractionPath(topology, options);
+  options.kind = PathOptimizerKind::RandomGreedy;
+  options.timeBudgetSeconds = 0.2;
+  const auto randomGreedy = optimizeContractionPath(topology, options);
+  checkTree(topology, greedy);
+  checkTree(topology, randomGreedy);
+  // The randomized search includes the greedy path.
+  TEST_CHECK(randomGreedy.flops <= greedy.flops);
+}
+
+void testDisconnectedNetwork() {
+  const NetworkTopology topology{{{0}, {1}, {2}}, {{2}, {2}, {2}}, {0, 1, 2}};
+  for (const auto kind :
+       {PathOptimizerKind::Greedy, PathOptimizerKind::Bisection,
+        PathOptimizerKind::RandomGreedy, PathOptimizerKind::Optimal}) {
+    PathOptimizerOptions options;
+    options.kind = kind;
+    options.timeBudgetSeconds = 0.01;
+    checkTree(topology, optimizeContractionPath(topology, options));
+  }
+}
+
+void testMpoDoubleLayer() {
+  const auto ket = makeRandomCircuit(5, 12, 3);
+  const std::vector<int64_t> bondDims{3, 5, 2};
+  const auto topology = buildMpoDoubleLayerTopology(ket, 1, bondDims);
+  const std::size_t numKetTensors = ket.inputModes.size();
+  TEST_CHECK(topology.inputModes.size() == 2 * numKetTensors + 4);
+  TEST_CHECK(topology.outputModes.empty());
+  // A closed network: each mode joins two tensors, with the same extent.
+  std::map<int32_t, std::vector<int64_t>> modeExtents;
+  for (std::size_t i = 0; i < topology.inputModes.size(); ++i) {
+    TEST_CHECK(topology.inputModes[i].size() ==
+               topology.inputExtents[i].size());
+    for (std::size_t m = 0; m < topology.inputModes[i].size(); ++m)
+      modeExtents[topology.inputModes[i][m]].emplace_back(
+          topology.inputExtents[i][m]);
+  }
+  for (const auto &[mode, extents] : modeExtents)
+    TEST_CHECK(extents.size() == 2 && extents[0] == extents[1]);
+  // Site tensors: (left bond, ket, right bond, bra) without the edge bonds.
+  const std::vector<std::vector<int64_t>> siteExtents{
+      {2, 3, 2}, {3, 2, 5, 2}, {5, 2, 2, 2}, {2, 2, 2}};
+  for (std::size_t site = 0; site < siteExtents.size(); ++site)
+    TEST_CHECK(topology.inputExtents[2 * numKetTensors + site] ==
+               siteExtents[site]);
+  checkTree(topology, optimizeContractionPath(topology, {}));
+  TEST_CHECK_THROWS(buildMpoDoubleLayerTopology(ket, 3, bondDims),
+                    std::invalid_argument);
+}
+
+void testCombinedEstimates() {
+  const auto none = combineEstimates({});
+  TEST_CHECK(none.flops == 0.0 && none.workspaceSize == 0);
+  TEST_CHECK(!none.largestIntermediate && !none.numSlices);
+  TEST_CHECK(none.fitsWorkspace);
+
+  ContractionEstimate first;
+  first.flops = 100.0;
+  first.largestIntermediate = 64.0;
+  first.workspaceSize = 1000;
+  first.numSlices = 2;
+  first.pathFindingSeconds = 0.5;
+  ContractionEstimate second = first;
+  second.flops = 50.0;
+  second.largestIntermediate = 256.0;
+  second.workspaceSize = 400;
+  second.fitsWorkspace = false;
+  const auto total = combineEstimates({first, second});
+  TEST_CHECK(total.flops == 150.0);
+  TEST_CHECK(total.largestIntermediate == 256.0);
+  TEST_CHECK(total.workspaceSize == 1000);
+  TEST_CHECK(total.numSlices == 4);
+  TEST_CHECK_NEAR(total.pathFindingSeconds, 1.0, 1e-12);
+  TEST_CHECK(!total.fitsWorkspace);
+
+  // Unknown for one query, unknown in total.
+  second.numSlices.reset();
+  TEST_CHECK(!combineEstimates({first, second}).numSlices);
+  TEST_CHECK(combineEstimates({first, second}).largestIntermediate);
+}
+
+void testInvalidCircuit() {
+  TEST_CHECK_THROWS(buildCircuitTopology(2, {{{5}, false}}, {}),
+                    std::invalid_argument);
+  TEST_CHECK(parsePathOptimizerKind("random-greedy") ==
+             PathOptimizerKind::RandomGreedy);
+  TEST_CHECK(!parsePathOptimizerKind("simulated-annealing"));
+}
+} // namespace
+
+int main() {
+  testAgainstBruteForce();
+  testRandomGreedyImprovesOnGreedy();
+  testDisconnectedNetwork();
+  testMpoDoubleLayer();
+  testCombinedEstimates();
+  testInvalidCircuit();
+  return EXIT_SUCCESS;
+}
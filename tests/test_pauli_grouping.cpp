@@ -0,0 +1,265 @@
+/*******************************************************************************
+ * Copyright (c) 2022 - 2025 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#include "pauli_grouping.h"
+#include "test_utils.h"
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+using namespace nvqir;
+
+namespace {
+using Amplitude = std::complex<double>;
+
+// Random normalized state vector, with bit `q` of the index for qubit `q`.
+std::vector<Amplitude> makeRandomState(std::size_t numQubits, unsigned seed) {
+  std::mt19937 engine(seed);
+  std::normal_distribution<double> normal;
+  std::vector<Amplitude> state(1ull << numQubits);
+  double norm = 0.0;
+  for (auto &amplitude : state) {
+    amplitude = {normal(engine), normal(engine)};
+    norm += std::norm(amplitude);
+  }
+  for (auto &amplitude : state)
+    amplitude /= std::sqrt(norm);
+  return state;
+}
+
+std::vector<PauliString> makeRandomTerms(std::size_t numQubits,
+                                         std::size_t numTerms,
+                                         unsigned seed) {
+  std::mt19937 engine(seed);
+  std::vector<PauliString> terms(numTerms);
+  for (auto &term : terms)
+    for (std::size_t qubit = 0; qubit < numQubits; ++qubit)
+      if (engine() % 2 == 0)
+        term.emplace_back(qubit, static_cast<PauliKind>(1 + engine() % 3));
+  // The identity product.
+  terms.emplace_back();
+  return terms;
+}
+
+// <state|term|state>, applying the product to the state.
+double computeExpectation(const std::vector<Amplitude> &state,
+                          const PauliString &term) {
+  Amplitude expectation = 0.0;
+  for (std::size_t index = 0; index < state.size(); ++index) {
+    std::size_t image = index;
+    Amplitude phase = 1.0;
+    for (const auto &[qubit, pauli] : term) {
+      const bool bit = (index >> qubit) & 1;
+      if (pauli != PauliKind::Z)
+        image ^= 1ull << qubit;
+      if (pauli == PauliKind::Y)
+        phase *= bit ? Amplitude(0.0, -1.0) : Amplitude(0.0, 1.0);
+      else if (pauli == PauliKind::Z && bit)
+        phase = -phase;
+    }
+    expectation += std::conj(state[image]) * phase * state[index];
+  }
+  return expectation.real();
+}
+
+// Reduced density matrix of `qubits`, in the layout of cuTensorNet marginals
+// (element (ket, bra) at `ket + (bra << k)`).
+std::vector<Amplitude>
+computeReducedDensityMatrix(const std::vector<Amplitude> &state,
+                            std::size_t numQubits,
+                            const std::vector<int32_t> &qubits) {
+  const std::size_t dim = 1ull << qubits.size();
+  std::vector<Amplitude> rdm(dim * dim);
+  for (std::size_t ket = 0; ket < state.size(); ++ket)
+    for (std::size_t bra = 0; bra < state.size(); ++bra) {
+      bool traced = true;
+      std::size_t ketIdx = 0;
+      std::size_t braIdx = 0;
+      for (std::size_t qubit = 0; qubit < numQubits; ++qubit) {
+        const auto iter = std::find(qubits.begin(), qubits.end(), qubit);
+        if (iter == qubits.end()) {
+          traced = traced && ((ket >> qubit) & 1) == ((bra >> qubit) & 1);
+          continue;
+        }
+        const std::size_t bit = iter - qubits.begin();
+        ketIdx |= ((ket >> qubit) & 1) << bit;
+        braIdx |= ((bra >> qubit) & 1) << bit;
+      }
+      if (traced)
+        rdm[ketIdx + (braIdx << qubits.size())] +=
+            state[ket] * std::conj(state[bra]);
+    }
+  return rdm;
+}
+
+// Each term is in exactly one group or ungrouped.
+void checkPartition(std::size_t numTerms,
+                    const std::vector<std::vector<std::size_t>> &groupTerms,
+                    const std::vector<std::size_t> &ungrouped) {
+  std::vector<int> placed(numTerms, 0);
+  for (const auto &terms : groupTerms)
+    for (const auto termIdx : terms)
+      ++placed[termIdx];
+  for (const auto termIdx : ungrouped)
+    ++placed[termIdx];
+  TEST_CHECK(std::all_of(placed.begin(), placed.end(),
+                         [](int count) { return count == 1; }));
+}
+
+void testQubitWiseCommutingGroups() {
+  constexpr std::size_t numQubits = 6;
+  constexpr std::size_t maxGroupQubits = 4;
+  const auto state = makeRandomState(numQubits, 7);
+  const auto terms = makeRandomTerms(numQubits, 200, 7);
+  const auto grouping =
+      groupQubitWiseCommuting(terms, numQubits, maxGroupQubits);
+
+  std::vector<std::vector<std::size_t>> groupTerms;
+  for (const auto &group : grouping.groups)
+    groupTerms.push_back(group.terms);
+  checkPartition(terms.size(), groupTerms, grouping.ungrouped);
+  for (const auto termIdx : grouping.ungrouped)
+    TEST_CHECK(terms[termIdx].size() > maxGroupQubits);
+  // The greedy placement leaves far fewer families than terms.
+  TEST_CHECK(grouping.groups.size() < terms.size() / 2);
+
+  for (const auto &group : grouping.groups) {
+    TEST_CHECK(group.qubits.size() <= maxGroupQubits);
+    TEST_CHECK(std::is_sorted(group.qubits.begin(), group.qubits.end()));
+    TEST_CHECK(group.basis.size() == group.qubits.size());
+    TEST_CHECK(group.termMasks.size() == group.terms.size());
+    // The products agree with the basis of the family on their qubits.
+    for (std::size_t i = 0; i < group.terms.size(); ++i) {
+      uint64_t mask = 0;
+      for (const auto &[qubit, pauli] : terms[group.terms[i]]) {
+        const auto iter =
+            std::find(group.qubits.begin(), group.qubits.end(), qubit);
+        TEST_CHECK(iter != group.qubits.end());
+        TEST_CHECK(group.basis[iter - group.qubits.begin()] == pauli);
+        mask |= 1ull << (iter - group.qubits.begin());
+      }
+      TEST_CHECK(group.termMasks[i] == mask);
+    }
+
+    // All the products of the family follow from a single distribution.
+    const auto rdm =
+        computeReducedDensityMatrix(state, numQubits, group.qubits);
+    const auto distribution = computeBasisDistribution<double>(
+        std::span<const Amplitude>(rdm), group.basis);
+    TEST_CHECK_NEAR(std::accumulate(distribution.begin(), distribution.end(),
+                                    0.0),
+                    1.0, 1e-12);
+    const auto values = evaluateGroup(group, distribution);
+    for (std::size_t i = 0; i < group.terms.size(); ++i)
+      TEST_CHECK_NEAR(values[i],
+                      computeExpectation(state, terms[group.terms[i]]),
+                      1e-12);
+  }
+}
+
+void testSupportGroups() {
+  constexpr std::size_t numQubits = 7;
+  constexpr std::size_t maxGroupQubits = 3;
+  const auto state = makeRandomState(numQubits, 9);
+  // Heisenberg chain with fields, a few longer products and the identity.
+  std::vector<PauliString> terms;
+  for (int32_t qubit = 0; qubit + 1 < static_cast<int32_t>(numQubits);
+       ++qubit)
+    for (const auto pauli : {PauliKind::X, PauliKind::Y, PauliKind::Z})
+      terms.push_back({{qubit, pauli}, {qubit + 1, pauli}});
+  for (int32_t qubit = 0; qubit < static_cast<int32_t>(numQubits); ++qubit)
+    terms.push_back({{qubit, PauliKind::Y}});
+  terms.push_back({{0, PauliKind::Y}, {2, PauliKind::X}, {5, PauliKind::Y}});
+  terms.push_back({{1, PauliKind::Y}, {2, PauliKind::Y}, {3, PauliKind::Y}});
+  terms.push_back({});
+  terms.push_back({{0, PauliKind::X},
+                   {1, PauliKind::X},
+                   {2, PauliKind::X},
+                   {3, PauliKind::X}});
+  const auto grouping = groupBySupport(terms, maxGroupQubits);
+
+  std::vector<std::vector<std::size_t>> groupTerms;
+  for (const auto &group : grouping.groups)
+    groupTerms.push_back(group.terms);
+  checkPartition(terms.size(), groupTerms, grouping.ungrouped);
+  TEST_CHECK(grouping.ungrouped == std::vector<std::size_t>{terms.size() - 1});
+
+  for (const auto &group : grouping.groups) {
+    TEST_CHECK(group.qubits.size() <= maxGroupQubits);
+    for (const auto termIdx : group.terms)
+      for (const auto &[qubit, pauli] : terms[termIdx])
+        TEST_CHECK(std::find(group.qubits.begin(), group.qubits.end(),
+                             qubit) != group.qubits.end());
+    const auto rdm =
+        computeReducedDensityMatrix(state, numQubits, group.qubits);
+    const auto values = evaluateSupportGroup<double>(
+        group, std::span<const Amplitude>(rdm));
+    for (std::size_t i = 0; i < group.terms.size(); ++i)
+      TEST_CHECK_NEAR(values[i],
+                      computeExpectation(state, terms[group.terms[i]]),
+                      1e-12);
+  }
+}
+
+void testPlaceholderUpdates() {
+  constexpr std::size_t numQubits = 12;
+  std::mt19937 engine(3);
+  std::vector<PauliString> terms(500);
+  for (auto &term : terms)
+    for (std::size_t qubit = 0; qubit < numQubits; ++qubit)
+      if (engine() % 3 == 0)
+        term.emplace_back(qubit, static_cast<PauliKind>(1 + engine() % 3));
+
+  auto order = orderForPlaceholderUpdates(terms);
+  auto sortedOrder = order;
+  std::sort(sortedOrder.begin(), sortedOrder.end());
+  std::vector<std::size_t> identityOrder(terms.size());
+  std::iota(identityOrder.begin(), identityOrder.end(), 0);
+  TEST_CHECK(sortedOrder == identityOrder);
+
+  // Applying the diffs in either order leaves the placeholder slots holding
+  // each product in turn; the lexicographic order rewrites fewer slots.
+  const auto countUpdates = [&](const std::vector<std::size_t> &termOrder) {
+    std::vector<PauliKind> slots(numQubits, PauliKind::I);
+    PauliString current;
+    std::size_t numUpdates = 0;
+    for (const auto termIdx : termOrder) {
+      const auto &next = terms[termIdx];
+      const auto diff = diffPauliStrings(current, next);
+      for (std::size_t i = 1; i < diff.size(); ++i)
+        TEST_CHECK(diff[i - 1].first < diff[i].first);
+      for (const auto &[qubit, pauli] : diff) {
+        TEST_CHECK(slots[qubit] != pauli);
+        slots[qubit] = pauli;
+      }
+      std::vector<PauliKind> expected(numQubits, PauliKind::I);
+      for (const auto &[qubit, pauli] : next)
+        expected[qubit] = pauli;
+      TEST_CHECK(slots == expected);
+      numUpdates += diff.size();
+      current = next;
+    }
+    return numUpdates;
+  };
+  TEST_CHECK(countUpdates(order) < countUpdates(identityOrder));
+
+  TEST_CHECK(diffPauliStrings({}, {}).empty());
+  const PauliString current{{0, PauliKind::X}, {2, PauliKind::Z}};
+  TEST_CHECK(diffPauliStrings(current, current).empty());
+  const PauliString next{{1, PauliKind::Y}, {2, PauliKind::Z}};
+  TEST_CHECK(diffPauliStrings(current, next) ==
+             (PauliString{{0, PauliKind::I}, {1, PauliKind::Y}}));
+}
+} // namespace
+
+int main() {
+  testQubitWiseCommutingGroups();
+  testSupportGroups();
+  testPlaceholderUpdates();
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,176 @@
+/*******************************************************************************
+ * Copyright (c) 2022 - 2025 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#include "pauli_mpo.h"
+#include "test_utils.h"
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+
+using namespace nvqir;
+
+namespace {
+using Complex = std::complex<double>;
+
+// Dense matrix (row-major, output index first) of an MPO, with bit `k` of the
+// indices for site `k`.
+std::vector<Complex> toDenseMatrix(const MatrixProductOperator &mpo) {
+  // Partial products indexed by (row, column, right bond).
+  std::vector<Complex> partial(1, 1.0);
+  std::size_t dim = 1;
+  for (std::size_t site = 0; site < mpo.numSites(); ++site) {
+    const std::size_t leftDim = site > 0 ? mpo.bondDims[site - 1] : 1;
+    const std::size_t rightDim =
+        site + 1 < mpo.numSites() ? mpo.bondDims[site] : 1;
+    const auto &tensor = mpo.tensors[site];
+    std::vector<Complex> next(4 * dim * dim * rightDim);
+    for (std::size_t row = 0; row < dim; ++row)
+      for (std::size_t col = 0; col < dim; ++col)
+        for (std::size_t left = 0; left < leftDim; ++left) {
+          const Complex value = partial[(row * dim + col) * leftDim + left];
+          for (std::size_t out = 0; out < 2; ++out)
+            for (std::size_t in = 0; in < 2; ++in)
+              for (std::size_t right = 0; right < rightDim; ++right) {
+                const std::size_t nextRow = row | (out << site);
+                const std::size_t nextCol = col | (in << site);
+                const std::size_t element =
+                    left + leftDim * (in + 2 * (right + rightDim * out));
+                next[(nextRow * 2 * dim + nextCol) * rightDim + right] +=
+                    value * tensor[element];
+              }
+        }
+    partial.swap(next);
+    dim *= 2;
+  }
+  return partial;
+}
+
+// Dense matrix of `sum_j coefficients[j] * terms[j]` on `numQubits` qubits
+// from `firstQubit`.
+std::vector<Complex> toDenseMatrix(const std::vector<PauliString> &terms,
+                                   const std::vector<Complex> &coefficients,
+                                   int32_t firstQubit, std::size_t numQubits) {
+  // Row-major Pauli matrices, by `PauliKind`.
+  const Complex paulis[4][4] = {{1.0, 0.0, 0.0, 1.0},
+                                {0.0, 1.0, 1.0, 0.0},
+                                {0.0, Complex(0.0, -1.0), Complex(0.0, 1.0),
+                                 0.0},
+                                {1.0, 0.0, 0.0, -1.0}};
+  const std::size_t dim = 1ull << numQubits;
+  std::vector<Complex> matrix(dim * dim);
+  for (std::size_t termIdx = 0; termIdx < terms.size(); ++termIdx) {
+    std::vector<PauliKind> factors(numQubits, PauliKind::I);
+    for (const auto &[qubit, pauli] : terms[termIdx])
+      factors[qubit - firstQubit] = pauli;
+    for (std::size_t row = 0; row < dim; ++row)
+      for (std::size_t col = 0; col < dim; ++col) {
+        Complex value = coefficients[termIdx];
+        for (std::size_t site = 0; site < numQubits; ++site)
+          value *= paulis[static_cast<int>(factors[site])]
+                         [((row >> site) & 1) * 2 + ((col >> site) & 1)];
+        matrix[row * dim + col] += value;
+      }
+  }
+  return matrix;
+}
+
+double maxDifference(const std::vector<Complex> &lhs,
+                     const std::vector<Complex> &rhs) {
+  TEST_CHECK(lhs.size() == rhs.size());
+  double difference = 0.0;
+  for (std::size_t i = 0; i < lhs.size(); ++i)
+    difference = std::max(difference, std::abs(lhs[i] - rhs[i]));
+  return difference;
+}
+
+void testRandomSums() {
+  std::mt19937 engine(7);
+  std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+  for (int trial = 0; trial < 60; ++trial) {
+    const int32_t numQubits = 1 + engine() % 7;
+    const int32_t offset = engine() % 3;
+    const std::size_t numTerms = 1 + engine() % 25;
+    std::vector<PauliString> terms(numTerms);
+    std::vector<Complex> coefficients;
+    for (auto &term : terms) {
+      for (int32_t qubit = 0; qubit < numQubits; ++qubit)
+        if (engine() % 2 == 0)
+          term.emplace_back(offset + qubit,
+                            static_cast<PauliKind>(1 + engine() % 3));
+      coefficients.emplace_back(uniform(engine),
+                                trial % 3 == 0 ? uniform(engine) : 0.0);
+    }
+    // At least one product acts on a qubit.
+    if (std::all_of(terms.begin(), terms.end(),
+                    [](const PauliString &term) { return term.empty(); }))
+      terms[0].emplace_back(offset, PauliKind::X);
+
+    auto mpo = buildPauliSumMpo(terms, coefficients);
+    const auto reference = toDenseMatrix(terms, coefficients, mpo.firstQubit,
+                                         mpo.numSites());
+    TEST_CHECK(maxDifference(toDenseMatrix(mpo), reference) < 1e-12);
+
+    const auto maxBondDim = mpo.maxBondDim();
+    compressMpo(mpo);
+    TEST_CHECK(maxDifference(toDenseMatrix(mpo), reference) < 1e-10);
+    TEST_CHECK(mpo.maxBondDim() <= maxBondDim);
+    // No bond exceeds the rank of the operator across it.
+    for (std::size_t bond = 0; bond + 1 < mpo.numSites(); ++bond)
+      TEST_CHECK(mpo.bondDims[bond] <=
+                 std::min<int64_t>(1ll << (2 * (bond + 1)),
+                                   1ll << (2 * (mpo.numSites() - bond - 1))));
+  }
+}
+
+void testCompression() {
+  // Heisenberg chain in a field: bond dimension 5.
+  constexpr int32_t numQubits = 6;
+  std::vector<PauliString> terms;
+  std::vector<Complex> coefficients;
+  for (int32_t qubit = 0; qubit + 1 < numQubits; ++qubit)
+    for (const auto pauli : {PauliKind::X, PauliKind::Y, PauliKind::Z}) {
+      terms.push_back({{qubit, pauli}, {qubit + 1, pauli}});
+      coefficients.push_back(1.0);
+    }
+  for (int32_t qubit = 0; qubit < numQubits; ++qubit) {
+    terms.push_back({{qubit, PauliKind::Z}});
+    coefficients.push_back(0.5);
+  }
+  auto mpo = buildPauliSumMpo(terms, coefficients);
+  compressMpo(mpo);
+  TEST_CHECK(mpo.maxBondDim() == 5);
+  TEST_CHECK(maxDifference(toDenseMatrix(mpo),
+                           toDenseMatrix(terms, coefficients, 0, numQubits)) <
+             1e-10);
+
+  // A repeated product is a single product: bond dimension 1.
+  const std::vector<PauliString> repeated{
+      {{0, PauliKind::X}, {2, PauliKind::Y}},
+      {{0, PauliKind::X}, {2, PauliKind::Y}}};
+  const std::vector<Complex> halves{0.5, 0.5};
+  auto repeatedMpo = buildPauliSumMpo(repeated, halves);
+  compressMpo(repeatedMpo);
+  TEST_CHECK(repeatedMpo.numSites() == 3);
+  TEST_CHECK(repeatedMpo.maxBondDim() == 1);
+  TEST_CHECK(maxDifference(toDenseMatrix(repeatedMpo),
+                           toDenseMatrix(repeated, halves, 0, 3)) < 1e-12);
+}
+
+void testInvalidSums() {
+  const std::vector<Complex> coefficients{1.0};
+  TEST_CHECK_THROWS(buildPauliSumMpo({{}}, coefficients),
+                    std::invalid_argument);
+}
+} // namespace
+
+int main() {
+  testRandomSums();
+  testCompression();
+  testInvalidSums();
+  return EXIT_SUCCESS;
+}
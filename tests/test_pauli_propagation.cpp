@@ -0,0 +1,279 @@
+/*******************************************************************************
+ * Copyright (c) 2022 - 2025 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#include "pauli_propagation.h"
+#include "test_utils.h"
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+
+using namespace nvqir;
+
+namespace {
+using Complex = std::complex<double>;
+using Matrix = std::vector<Complex>;
+
+// Gate of a random circuit: a target matrix (row-major, first target qubit
+// most significant) applied if all the controls are set.
+struct Gate {
+  std::vector<int32_t> controls;
+  std::vector<int32_t> targets;
+  Matrix matrix;
+  // The matrix of the inverse gate, written out (e.g., Sdg for S).
+  Matrix adjointMatrix;
+  bool isAdjoint = false;
+};
+
+Matrix makeRotation(char axis, double angle) {
+  const double c = std::cos(angle / 2);
+  const double s = std::sin(angle / 2);
+  switch (axis) {
+  case 'x':
+    return {c, Complex(0.0, -s), Complex(0.0, -s), c};
+  case 'y':
+    return {c, -s, s, c};
+  default:
+    return {Complex(c, -s), 0.0, 0.0, Complex(c, s)};
+  }
+}
+
+// Random gate among H, S, T, the Paulis, rotations and SWAP, with up to two
+// controls and possibly adjoint.
+Gate makeRandomGate(std::size_t numQubits, std::mt19937 &engine) {
+  const double h = 1.0 / std::sqrt(2.0);
+  const Complex t = std::polar(1.0, M_PI / 4);
+  const double angle =
+      std::uniform_real_distribution<double>(-M_PI, M_PI)(engine);
+  Gate gate;
+  std::size_t numTargets = 1;
+  switch (engine() % 10) {
+  case 0:
+    gate.matrix = gate.adjointMatrix = {h, h, h, -h};
+    break;
+  case 1:
+    gate.matrix = {1.0, 0.0, 0.0, Complex(0.0, 1.0)};
+    gate.adjointMatrix = {1.0, 0.0, 0.0, Complex(0.0, -1.0)};
+    break;
+  case 2:
+    gate.matrix = {1.0, 0.0, 0.0, t};
+    gate.adjointMatrix = {1.0, 0.0, 0.0, std::conj(t)};
+    break;
+  case 3:
+    gate.matrix = gate.adjointMatrix = {0.0, 1.0, 1.0, 0.0};
+    break;
+  case 4:
+    gate.matrix = gate.adjointMatrix = {0.0, Complex(0.0, -1.0),
+                                        Complex(0.0, 1.0), 0.0};
+    break;
+  case 5:
+    gate.matrix = gate.adjointMatrix = {1.0, 0.0, 0.0, -1.0};
+    break;
+  case 6:
+  case 7:
+  case 8: {
+    const char axis = "xyz"[engine() % 3];
+    gate.matrix = makeRotation(axis, angle);
+    gate.adjointMatrix = makeRotation(axis, -angle);
+    break;
+  }
+  default:
+    numTargets = 2;
+    gate.matrix = gate.adjointMatrix = {1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0,
+                                        0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 1.0};
+    break;
+  }
+  gate.isAdjoint = engine() % 2 == 0;
+
+  std::vector<int32_t> qubits(numQubits);
+  for (std::size_t q = 0; q < numQubits; ++q)
+    qubits[q] = q;
+  std::shuffle(qubits.begin(), qubits.end(), engine);
+  const std::size_t numControls = std::min<std::size_t>(
+      {engine() % 3, g_maxPauliPropagationGateQubits - numTargets,
+       numQubits - numTargets});
+  gate.controls.assign(qubits.begin(), qubits.begin() + numControls);
+  gate.targets.assign(qubits.begin() + numControls,
+                      qubits.begin() + numControls + numTargets);
+  return gate;
+}
+
+// The gate as propagated: controls expanded as the leading qubits, and the
+// adjoint taken as the conjugate transpose.
+HostGate toHostGate(const Gate &gate) {
+  HostGate hostGate;
+  hostGate.qubits = gate.controls;
+  hostGate.qubits.insert(hostGate.qubits.end(), gate.targets.begin(),
+                         gate.targets.end());
+  const std::size_t dim = std::size_t{1} << hostGate.qubits.size();
+  const std::size_t targetDim = std::size_t{1} << gate.targets.size();
+  const std::size_t offset = dim - targetDim;
+  hostGate.matrix.assign(dim * dim, 0.0);
+  for (std::size_t i = 0; i < offset; ++i)
+    hostGate.matrix[i * dim + i] = 1.0;
+  for (std::size_t i = 0; i < targetDim; ++i)
+    for (std::size_t j = 0; j < targetDim; ++j)
+      hostGate.matrix[(offset + i) * dim + offset + j] =
+          gate.isAdjoint ? std::conj(gate.matrix[j * targetDim + i])
+                         : gate.matrix[i * targetDim + j];
+  return hostGate;
+}
+
+// Apply the gate to a state vector, with bit `q` of the index for qubit `q`.
+void applyGate(std::vector<Complex> &state, const Gate &gate) {
+  const auto &matrix = gate.isAdjoint ? gate.adjointMatrix : gate.matrix;
+  const std::size_t numTargets = gate.targets.size();
+  const std::size_t targetDim = std::size_t{1} << numTargets;
+  const auto getIndex = [&](std::size_t base, std::size_t local) {
+    for (std::size_t m = 0; m < numTargets; ++m)
+      if ((local >> (numTargets - 1 - m)) & 1)
+        base |= std::size_t{1} << gate.targets[m];
+    return base;
+  };
+  std::vector<Complex> amplitudes(targetDim);
+  for (std::size_t base = 0; base < state.size(); ++base) {
+    if (std::any_of(gate.targets.begin(), gate.targets.end(),
+                    [&](int32_t q) { return (base >> q) & 1; }) ||
+        !std::all_of(gate.controls.begin(), gate.controls.end(),
+                     [&](int32_t q) { return (base >> q) & 1; }))
+      continue;
+    for (std::size_t j = 0; j < targetDim; ++j)
+      amplitudes[j] = state[getIndex(base, j)];
+    for (std::size_t i = 0; i < targetDim; ++i) {
+      Complex sum = 0.0;
+      for (std::size_t j = 0; j < targetDim; ++j)
+        sum += matrix[i * targetDim + j] * amplitudes[j];
+      state[getIndex(base, i)] = sum;
+    }
+  }
+}
+
+// <state|term|state>, applying the product to the state.
+double computeExpectation(const std::vector<Complex> &state,
+                          const PauliString &term) {
+  Complex expectation = 0.0;
+  for (std::size_t index = 0; index < state.size(); ++index) {
+    std::size_t image = index;
+    Complex phase = 1.0;
+    for (const auto &[qubit, pauli] : term) {
+      const bool bit = (index >> qubit) & 1;
+      if (pauli != PauliKind::Z)
+        image ^= std::size_t{1} << qubit;
+      if (pauli == PauliKind::Y)
+        phase *= bit ? Complex(0.0, -1.0) : Complex(0.0, 1.0);
+      else if (pauli == PauliKind::Z && bit)
+        phase = -phase;
+    }
+    expectation += std::conj(state[image]) * phase * state[index];
+  }
+  return expectation.real();
+}
+
+struct Problem {
+  std::size_t numQubits = 0;
+  std::vector<HostGate> hostGates;
+  std::vector<PauliString> terms;
+  std::vector<double> coefficients;
+  double reference = 0.0;
+};
+
+Problem makeRandomProblem(std::size_t numQubits, std::size_t numGates,
+                          unsigned seed) {
+  std::mt19937 engine(seed);
+  Problem problem;
+  problem.numQubits = numQubits;
+  std::vector<Complex> state(std::size_t{1} << numQubits);
+  state[0] = 1.0;
+  for (std::size_t i = 0; i < numGates; ++i) {
+    const auto gate = makeRandomGate(numQubits, engine);
+    problem.hostGates.push_back(toHostGate(gate));
+    applyGate(state, gate);
+  }
+  std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+  for (std::size_t i = 0; i < 12; ++i) {
+    auto &term = problem.terms.emplace_back();
+    for (std::size_t qubit = 0; qubit < numQubits; ++qubit)
+      if (engine() % 2 == 0)
+        term.emplace_back(qubit, static_cast<PauliKind>(1 + engine() % 3));
+    problem.coefficients.push_back(uniform(engine));
+    problem.reference +=
+        problem.coefficients.back() * computeExpectation(state, term);
+  }
+  return problem;
+}
+
+void testAgainstStateVector() {
+  PauliPropagationSettings exact;
+  exact.coefficientCutoff = 0.0;
+  for (unsigned seed = 0; seed < 40; ++seed) {
+    const auto problem = makeRandomProblem(2 + seed % 4, 30, seed);
+    const auto result =
+        propagatePauliSum(problem.numQubits, problem.terms,
+                          problem.coefficients, problem.hostGates, exact);
+    TEST_CHECK_NEAR(result.expectation, problem.reference, 1e-10);
+    TEST_CHECK(result.truncationError == 0.0);
+    TEST_CHECK(result.numTerms <= result.maxTerms);
+  }
+}
+
+void testCliffordCircuits() {
+  // Clifford gates map each product to a single one: no growth.
+  PauliPropagationSettings exact;
+  exact.coefficientCutoff = 0.0;
+  std::vector<HostGate> gates;
+  const double h = 1.0 / std::sqrt(2.0);
+  for (int32_t qubit = 0; qubit < 4; ++qubit)
+    gates.push_back({{qubit}, {h, h, h, -h}});
+  for (int32_t qubit = 0; qubit + 1 < 4; ++qubit)
+    gates.push_back({{qubit, qubit + 1},
+                     {1.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 0.0,
+                      1.0, 0.0, 0.0, 1.0, 0.0}});
+  // H on each qubit then a CNOT chain leaves |+>^4: X on all the qubits has
+  // expectation 1, Z on one qubit 0.
+  const std::vector<PauliString> terms{{{0, PauliKind::X},
+                                        {1, PauliKind::X},
+                                        {2, PauliKind::X},
+                                        {3, PauliKind::X}},
+                                       {{2, PauliKind::Z}}};
+  const std::vector<double> coefficients{0.5, 2.0};
+  const auto result =
+      propagatePauliSum(4, terms, coefficients, gates, exact);
+  TEST_CHECK_NEAR(result.expectation, 0.5, 1e-12);
+  TEST_CHECK(result.maxTerms == 2);
+  TEST_CHECK(result.numTerms == 2);
+}
+
+void testTruncationBound() {
+  for (unsigned seed = 0; seed < 40; ++seed) {
+    const auto problem = makeRandomProblem(4 + seed % 2, 40, 100 + seed);
+    PauliPropagationSettings truncated;
+    truncated.coefficientCutoff = seed % 2 == 0 ? 0.05 : 0.0;
+    truncated.maxWeight = 1 + seed % 3;
+    const auto result =
+        propagatePauliSum(problem.numQubits, problem.terms,
+                          problem.coefficients, problem.hostGates, truncated);
+    TEST_CHECK(std::abs(result.expectation - problem.reference) <=
+               result.truncationError + 1e-10);
+  }
+}
+
+void testInvalidGates() {
+  const HostGate wide{{0, 1, 2, 3}, Matrix(256, 0.0)};
+  const std::vector<double> coefficients{1.0};
+  TEST_CHECK_THROWS(propagatePauliSum(4, {{{0, PauliKind::Z}}}, coefficients,
+                                      {wide}, PauliPropagationSettings()),
+                    std::invalid_argument);
+}
+} // namespace
+
+int main() {
+  testAgainstStateVector();
+  testCliffordCircuits();
+  testTruncationBound();
+  testInvalidGates();
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,113 @@
+/*******************************************************************************
+ * Copyright (c) 2022 - 2025 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#include "sample_counts.h"
+#include "test_utils.h"
+#include <random>
+
+using namespace nvqir;
+
+namespace {
+// Shots in the layout of `cutensornetSamplerSample` (one row of `numBits`
+// values per shot), drawn from a few dozen distinct outcomes.
+std::vector<int64_t> makeSamples(std::size_t numBits, std::size_t numShots,
+                                 unsigned seed) {
+  std::mt19937_64 engine(seed);
+  std::vector<int64_t> samples(numBits * numShots);
+  for (std::size_t shot = 0; shot < numShots; ++shot) {
+    const uint64_t outcome = (engine() % 37) * 2654435761u;
+    for (std::size_t bit = 0; bit < numBits; ++bit)
+      samples[shot * numBits + bit] = (outcome >> (bit % 31)) & 1;
+  }
+  return samples;
+}
+
+void testAgainstBitStrings() {
+  // Widths within a word, of exactly one word and spanning several words.
+  for (const std::size_t numBits : {1, 5, 63, 64, 65, 130}) {
+    constexpr std::size_t numShots = 5000;
+    const auto samples = makeSamples(numBits, numShots, numBits);
+    PackedSampleCounts counts(numBits);
+    TEST_CHECK(counts.numWords() == (numBits + 63) / 64);
+    counts.addSamples(samples);
+
+    // Reference histogram and mean parity from bit strings.
+    std::unordered_map<std::string, std::size_t> reference;
+    double paritySum = 0.0;
+    for (std::size_t shot = 0; shot < numShots; ++shot) {
+      std::string bitString(numBits, '0');
+      std::size_t numOnes = 0;
+      for (std::size_t bit = 0; bit < numBits; ++bit) {
+        bitString[bit] += samples[shot * numBits + bit];
+        numOnes += samples[shot * numBits + bit];
+      }
+      ++reference[bitString];
+      paritySum += numOnes % 2 == 0 ? 1.0 : -1.0;
+    }
+    TEST_CHECK(counts.toCounts() == reference);
+    TEST_CHECK(counts.numShots() == numShots);
+    TEST_CHECK(counts.size() == reference.size());
+    TEST_CHECK_NEAR(counts.parityExpectation(), paritySum / numShots, 1e-12);
+
+    // Outcomes are kept in first-drawn order.
+    std::string firstBitString(numBits, '0');
+    for (std::size_t bit = 0; bit < numBits; ++bit)
+      firstBitString[bit] += samples[bit];
+    TEST_CHECK(counts.toBitString(0) == firstBitString);
+    TEST_CHECK(counts.count(0) == reference[firstBitString]);
+
+    const auto roundTrip = PackedSampleCounts::fromCounts(numBits, reference);
+    TEST_CHECK(roundTrip.toCounts() == reference);
+    PackedSampleCounts merged(numBits);
+    merged.merge(counts);
+    merged.merge(roundTrip);
+    TEST_CHECK(merged.numShots() == 2 * numShots);
+    TEST_CHECK(merged.size() == counts.size());
+    for (std::size_t idx = 0; idx < merged.size(); ++idx)
+      TEST_CHECK(merged.count(idx) ==
+                 2 * reference.at(merged.toBitString(idx)));
+  }
+}
+
+void testPackedKeys() {
+  PackedSampleCounts counts(70);
+  std::vector<uint64_t> key{0b101, 1ull << 5};
+  counts.add(key, 3);
+  counts.add(key);
+  TEST_CHECK(counts.size() == 1);
+  TEST_CHECK(counts.numShots() == 4);
+  TEST_CHECK(counts.key(0)[0] == key[0] && counts.key(0)[1] == key[1]);
+  // Bit `i` of the string is bit `i % 64` of word `i / 64`.
+  const auto bitString = counts.toBitString(0);
+  TEST_CHECK(bitString.size() == 70);
+  for (std::size_t bit = 0; bit < bitString.size(); ++bit)
+    TEST_CHECK(bitString[bit] ==
+               (bit == 0 || bit == 2 || bit == 64 + 5 ? '1' : '0'));
+  // Three ones: odd parity.
+  TEST_CHECK_NEAR(counts.parityExpectation(), -1.0, 0.0);
+
+  // Enough distinct outcomes to grow the hash table several times.
+  PackedSampleCounts grown(20);
+  for (uint64_t outcome = 0; outcome < 5000; ++outcome)
+    grown.add(std::span<const uint64_t>(&outcome, 1), outcome % 3 + 1);
+  TEST_CHECK(grown.size() == 5000);
+  for (uint64_t outcome = 0; outcome < 5000; ++outcome) {
+    TEST_CHECK(grown.key(outcome)[0] == outcome);
+    TEST_CHECK(grown.count(outcome) == outcome % 3 + 1);
+  }
+
+  // No shots: zero parity expectation.
+  TEST_CHECK_NEAR(PackedSampleCounts(8).parityExpectation(), 0.0, 0.0);
+}
+} // namespace
+
+int main() {
+  testAgainstBitStrings();
+  testPackedKeys();
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,147 @@
+/*******************************************************************************
+ * Copyright (c) 2022 - 2025 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#include "trajectory_sampling.h"
+#include "test_utils.h"
+#include <cmath>
+#include <set>
+#include <stdexcept>
+
+using namespace nvqir;
+
+namespace {
+// The frequency of an event of the given probability over `numShots` shots
+// is within five standard deviations of it.
+void checkFrequency(double count, double probability, std::size_t numShots) {
+  const double deviation =
+      std::sqrt(probability * (1.0 - probability) / numShots);
+  TEST_CHECK_NEAR(count / numShots, probability, 5.0 * deviation + 1e-12);
+}
+
+void testBranchFrequencies() {
+  // A depolarizing-like channel, one whose most likely branch is not the
+  // first, a single Kraus operator and a deterministic channel.
+  const std::vector<std::vector<double>> probabilities{
+      {0.7, 0.1, 0.1, 0.1}, {0.2, 0.3, 0.5}, {1.0}, {0.0, 1.0}};
+  constexpr std::size_t numShots = 200000;
+  std::mt19937 engine(7);
+  const auto groups = sampleTrajectoryGroups(probabilities, numShots, engine);
+
+  std::size_t totalShots = 0;
+  std::set<std::vector<uint32_t>> trajectories;
+  std::vector<std::vector<double>> counts;
+  for (const auto &channel : probabilities)
+    counts.emplace_back(channel.size(), 0.0);
+  double jointCount = 0.0;
+  for (const auto &group : groups) {
+    TEST_CHECK(group.numShots > 0);
+    TEST_CHECK(group.branches.size() == probabilities.size());
+    // Each trajectory has a single group.
+    TEST_CHECK(trajectories.insert(group.branches).second);
+    totalShots += group.numShots;
+    for (std::size_t c = 0; c < probabilities.size(); ++c) {
+      TEST_CHECK(group.branches[c] < probabilities[c].size());
+      counts[c][group.branches[c]] += group.numShots;
+    }
+    if (group.branches[0] == 1 && group.branches[1] == 0)
+      jointCount += group.numShots;
+  }
+  TEST_CHECK(totalShots == numShots);
+
+  for (std::size_t c = 0; c < probabilities.size(); ++c)
+    for (std::size_t branch = 0; branch < probabilities[c].size(); ++branch)
+      checkFrequency(counts[c][branch], probabilities[c][branch], numShots);
+  // The channels select their branches independently.
+  checkFrequency(jointCount, 0.1 * 0.2, numShots);
+
+  // The trajectory of the most likely branches comes first.
+  TEST_CHECK(groups.front().branches ==
+             (std::vector<uint32_t>{0, 2, 0, 1}));
+  checkFrequency(groups.front().numShots, 0.7 * 0.5, numShots);
+}
+
+void testLowNoise() {
+  // Many channels at a low error rate: few distinct trajectories.
+  const std::vector<std::vector<double>> probabilities(
+      1000, {1.0 - 1e-4, 1e-4 / 3, 1e-4 / 3, 1e-4 / 3});
+  constexpr std::size_t numShots = 100000;
+  std::mt19937 engine(3);
+  const auto groups = sampleTrajectoryGroups(probabilities, numShots, engine);
+  std::size_t totalShots = 0;
+  for (const auto &group : groups)
+    totalShots += group.numShots;
+  TEST_CHECK(totalShots == numShots);
+  TEST_CHECK(groups.front().branches == std::vector<uint32_t>(1000, 0));
+  // The noiseless trajectory has probability (1 - 1e-4)^1000, about 0.905.
+  checkFrequency(groups.front().numShots, std::pow(1.0 - 1e-4, 1000),
+                 numShots);
+  TEST_CHECK(shouldSampleByTrajectory(groups.size(), numShots));
+  const double estimate = estimateNumTrajectoryGroups(probabilities, numShots);
+  TEST_CHECK(estimate >= groups.size());
+  TEST_CHECK(shouldSampleByTrajectory(estimate, numShots));
+}
+
+void testEstimate() {
+  // Noiseless channels: a single trajectory.
+  TEST_CHECK(estimateNumTrajectoryGroups({{1.0}, {0.0, 1.0}}, 100) == 1.0);
+  TEST_CHECK(estimateNumTrajectoryGroups({}, 100) == 1.0);
+  // Bounded by the number of possible trajectories and of shots.
+  TEST_CHECK(estimateNumTrajectoryGroups({{0.5, 0.5}, {0.5, 0.0, 0.5}},
+                                         1000) == 4.0);
+  TEST_CHECK(estimateNumTrajectoryGroups({{0.5, 0.5}}, 1) == 1.0);
+  // At a high error rate on many channels, nearly every shot deviates: the
+  // shots fall back to one trajectory each, without drawing them.
+  const std::vector<std::vector<double>> noisy(100, {0.7, 0.1, 0.1, 0.1});
+  const double estimate = estimateNumTrajectoryGroups(noisy, 1000);
+  TEST_CHECK(estimate == 1000.0);
+  TEST_CHECK(!shouldSampleByTrajectory(estimate, 1000));
+  // Otherwise, the deviating shots plus the noiseless trajectory.
+  const std::vector<std::vector<double>> lowNoise(20, {0.99, 0.01});
+  TEST_CHECK_NEAR(estimateNumTrajectoryGroups(lowNoise, 10000),
+                  1.0 + 10000 * (1.0 - std::pow(0.99, 20)), 1e-6);
+  std::mt19937 engine(5);
+  TEST_CHECK(sampleTrajectoryGroups(noisy, 1000, engine).size() <= estimate);
+
+  // The estimate bounds the distinct trajectories actually drawn.
+  const std::vector<std::vector<double>> mixed{
+      {0.9, 0.05, 0.05}, {0.99, 0.01}, {0.6, 0.4}, {0.95, 0.05}};
+  for (const std::size_t numShots : {1, 10, 100, 10000}) {
+    const auto groups = sampleTrajectoryGroups(mixed, numShots, engine);
+    TEST_CHECK(groups.size() <= estimateNumTrajectoryGroups(mixed, numShots));
+  }
+}
+
+void testEdgeCases() {
+  std::mt19937 engine(1);
+  const std::vector<std::vector<double>> probabilities{{0.9, 0.1}};
+  TEST_CHECK(sampleTrajectoryGroups(probabilities, 0, engine).empty());
+
+  // No channels: a single, empty trajectory.
+  const auto groups = sampleTrajectoryGroups({}, 5, engine);
+  TEST_CHECK(groups.size() == 1);
+  TEST_CHECK(groups[0].branches.empty() && groups[0].numShots == 5);
+
+  TEST_CHECK_THROWS(sampleTrajectoryGroups({{}}, 5, engine),
+                    std::invalid_argument);
+  TEST_CHECK_THROWS(sampleTrajectoryGroups({{0.0, 0.0}}, 5, engine),
+                    std::invalid_argument);
+  TEST_CHECK_THROWS(sampleTrajectoryGroups({{1.0, -0.5}}, 5, engine),
+                    std::invalid_argument);
+
+  TEST_CHECK(shouldSampleByTrajectory(50, 100));
+  TEST_CHECK(!shouldSampleByTrajectory(51, 100));
+}
+} // namespace
+
+int main() {
+  testBranchFrequencies();
+  testLowNoise();
+  testEstimate();
+  testEdgeCases();
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,46 @@
+/****************************************************************-*- C++ -*-****
+ * Copyright (c) 2022 - 2025 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+/// Checks of the host tests: a failed check reports its location and exits
+/// the test with a failure status.
+#define TEST_CHECK(cond)                                                       \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__,    \
+                   #cond);                                                     \
+      std::exit(EXIT_FAILURE);                                                 \
+    }                                                                          \
+  } while (0)
+
+#define TEST_CHECK_NEAR(lhs, rhs, tolerance)                                   \
+  do {                                                                         \
+    const double testLhs = (lhs);                                              \
+    const double testRhs = (rhs);                                              \
+    if (!(std::abs(testLhs - testRhs) <= (tolerance))) {                       \
+      std::fprintf(stderr, "%s:%d: check failed: %s (%g) ~= %s (%g)\n",        \
+                   __FILE__, __LINE__, #lhs, testLhs, #rhs, testRhs);          \
+      std::exit(EXIT_FAILURE);                                                 \
+    }                                                                          \
+  } while (0)
+
+#define TEST_CHECK_THROWS(expr, exception)                                     \
+  do {                                                                         \
+    bool testThrown = false;                                                   \
+    try {                                                                      \
+      (void)(expr);                                                            \
+    } catch (const exception &) {                                              \
+      testThrown = true;                                                       \
+    }                                                                          \
+    TEST_CHECK(testThrown && #expr " throws " #exception);                     \
+  } while (0)